@@ -34,6 +34,9 @@ knowledge of the CeCILL-B license and that you accept its terms.
 
 #include "Landmark.h"
 
+#include <algorithm>
+#include <iostream>
+#include <boost/cstdint.hpp>
 
 
 
@@ -50,6 +53,12 @@ GraphFactory::GraphFactory ( const std::string& filename, bool from_bin )
 {
     initialized = true;
     this->graph = new Graph( filename, from_bin );
+    
+    // a mapped graph is already frozen
+    if( !graph->mapped_file ) {
+        renumber_nodes();
+        graph->freeze();
+    }
 }
 
 void GraphFactory::add_road_edge ( const int source, const int target, const EdgeMode type, const int duration )
@@ -103,12 +112,76 @@ void GraphFactory::save_to_txt ( const std::string& filename ) const
     graph->save_to_txt( filename );
 }
 
+void GraphFactory::save_to_mmap ( const std::string& filename )
+{
+    get();
+    graph->save_to_mmap( filename );
+}
+
 void GraphFactory::init()
 {
+    renumber_nodes();
+    
+    // landmarks used to spot car dead-ends run on the frozen graph
+    graph->freeze();
     preproc_car_layer();
     graph->preprocess();
 }
 
+/**
+ * Position of the cell (x, y) along a Hilbert curve filling a 2^16 x 2^16 grid
+ */
+boost::uint32_t hilbert_index( boost::uint32_t x, boost::uint32_t y ) {
+    boost::uint32_t d = 0;
+    for( boost::uint32_t s = 1 << 15 ; s > 0 ; s >>= 1 ) {
+        const boost::uint32_t rx = (x & s) > 0;
+        const boost::uint32_t ry = (y & s) > 0;
+        d += s * s * ((3 * rx) ^ ry);
+        
+        // rotate the quadrant
+        if( ry == 0 ) {
+            if( rx == 1 ) {
+                x = s - 1 - x;
+                y = s - 1 - y;
+            }
+            std::swap(x, y);
+        }
+    }
+    return d;
+}
+
+void GraphFactory::renumber_nodes()
+{
+    const Graph_t & g = graph->g;
+    const int n = boost::num_vertices( g );
+    if( n == 0 )
+        return;
+    
+    float min_lon = g[0].lon, max_lon = g[0].lon, min_lat = g[0].lat, max_lat = g[0].lat;
+    for(int i=0 ; i<n ; ++i) {
+        min_lon = std::min( min_lon, g[i].lon );
+        max_lon = std::max( max_lon, g[i].lon );
+        min_lat = std::min( min_lat, g[i].lat );
+        max_lat = std::max( max_lat, g[i].lat );
+    }
+    const float lon_scale = max_lon > min_lon ? 65535 / (max_lon - min_lon) : 0;
+    const float lat_scale = max_lat > min_lat ? 65535 / (max_lat - min_lat) : 0;
+    
+    // nodes sharing a cell keep their relative order
+    std::vector< std::pair<boost::uint32_t, int> > keys( n );
+    for(int i=0 ; i<n ; ++i) {
+        const boost::uint32_t x = (g[i].lon - min_lon) * lon_scale;
+        const boost::uint32_t y = (g[i].lat - min_lat) * lat_scale;
+        keys[i] = std::make_pair( hilbert_index(x, y), i );
+    }
+    std::sort( keys.begin(), keys.end() );
+    
+    graph->node_order.resize( n );
+    for(int i=0 ; i<n ; ++i) {
+        graph->node_order[i] = keys[i].second;
+    }
+}
+
 /**
  * Removes all edges of type 'type' incoming in 'node'
  * 
@@ -162,13 +235,14 @@ void GraphFactory::preproc_car_layer()
     } while( count < graph->num_vertices()/3 );
     
     int cnt = 0;
+    // the landmark is computed on the frozen graph while edges are removed from the adjacency list
     for(int i=0; i< graph->num_vertices(); ++i) {
         if((lm->backward_reachable(i) && !lm->forward_reachable(i)) || (!lm->backward_reachable(i) && lm->forward_reachable(i))) {
             cnt++;
-            remove_in_edges(graph->g, i, CarEdge);
-            remove_out_edges(graph->g, i, CarEdge);
+            remove_in_edges(graph->g, graph->original_node(i), CarEdge);
+            remove_out_edges(graph->g, graph->original_node(i), CarEdge);
         } else if( lm->forward_reachable( i ) ) {
-            graph->set_car_accessible( i );
+            graph->set_car_accessible( graph->original_node(i) );
         }
     }
     std::cout << cnt << " car dead-ends spoted and removed." << std::endl;
@@ -0,0 +1,470 @@
+/** Copyright : Arthur Bit-Monnot (2013)  arthur.bit-monnot@laas.fr
+
+This software is a computer program whose purpose is to [describe
+functionalities and technical features of your software].
+
+This software is governed by the CeCILL-B license under French law and
+abiding by the rules of distribution of free software.  You can  use, 
+modify and/ or redistribute the software under the terms of the CeCILL-B
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info". 
+
+As a counterpart to the access to the source code and  rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty  and the software's author,  the holder of the
+economic rights,  and the successive licensors  have only  limited
+liability. 
+
+In this respect, the user's attention is drawn to the risks associated
+with loading,  using,  modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean  that it is complicated to manipulate,  and  that  also
+therefore means  that it is reserved for developers  and  experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or 
+data to be ensured and,  more generally, to use and operate it in the 
+same conditions as regards security. 
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL-B license and that you accept its terms. 
+*/
+
+#include "ContractionHierarchy.h"
+
+#include <fstream>
+#include <stdexcept>
+#include <limits>
+#include <boost/foreach.hpp>
+#include <boost/serialization/vector.hpp>
+#include <boost/archive/binary_iarchive.hpp>
+#include <boost/archive/binary_oarchive.hpp>
+
+namespace CH {
+
+namespace {
+
+const std::string CH_ARCHIVE_TAG = "#mumoro-contraction-hierarchy";
+
+const int INFINITE = std::numeric_limits<int>::max();
+
+/**
+ * Neighbour of a node that is not contracted yet and the arc leading to (or coming from) it
+ */
+typedef std::pair<int, int> Neighbour;
+typedef std::vector< std::vector<Neighbour> > Adjacency;
+
+/**
+ * Dijkstra bounded by a distance and a number of settled nodes, ignoring one node
+ */
+class WitnessSearch
+{
+public:
+    WitnessSearch( const int num_nodes ) : distance(num_nodes, INFINITE) {}
+
+    void run( const Adjacency & out, const std::vector<Arc> & arcs, const int source, const int ignored, const int max_distance, const int limit )
+    {
+        BOOST_FOREACH( const int n, touched ) {
+            distance[n] = INFINITE;
+        }
+        touched.clear();
+
+        std::priority_queue< Neighbour, std::vector<Neighbour>, std::greater<Neighbour> > queue;
+        distance[source] = 0;
+        touched.push_back( source );
+        queue.push( Neighbour(0, source) );
+        int settled = 0;
+        while( !queue.empty() && settled < limit ) {
+            const Neighbour curr = queue.top();
+            queue.pop();
+            if(curr.first > distance[curr.second])
+                continue;
+            if(curr.first > max_distance)
+                break;
+            ++settled;
+            BOOST_FOREACH( const Neighbour & next, out[curr.second] ) {
+                const int d = curr.first + arcs[next.second].weight;
+                if(next.first == ignored || d >= distance[next.first])
+                    continue;
+                if(distance[next.first] == INFINITE)
+                    touched.push_back( next.first );
+                distance[next.first] = d;
+                queue.push( Neighbour(d, next.first) );
+            }
+        }
+    }
+
+    std::vector<int> distance;
+
+private:
+    std::vector<int> touched;
+};
+
+/**
+ * Adds an arc between two nodes not contracted yet, or replaces the one between them if it is longer
+ */
+void add_arc( Adjacency & out, Adjacency & in, std::vector<Arc> & arcs, const Arc & arc )
+{
+    BOOST_FOREACH( Neighbour & n, out[arc.source] ) {
+        if(n.first != arc.target)
+            continue;
+        if(arc.weight < arcs[n.second].weight) {
+            BOOST_FOREACH( Neighbour & m, in[arc.target] ) {
+                if(m.first == arc.source)
+                    m.second = arcs.size();
+            }
+            n.second = arcs.size();
+            arcs.push_back( arc );
+        }
+        return;
+    }
+    out[arc.source].push_back( Neighbour(arc.target, arcs.size()) );
+    in[arc.target].push_back( Neighbour(arc.source, arcs.size()) );
+    arcs.push_back( arc );
+}
+
+void remove_neighbour( std::vector<Neighbour> & neighbours, const int node )
+{
+    for(uint i=0 ; i<neighbours.size() ; ++i) {
+        if(neighbours[i].first == node) {
+            neighbours[i] = neighbours.back();
+            neighbours.pop_back();
+            return;
+        }
+    }
+}
+
+/**
+ * Shortcuts needed to contract `node`, added to the graph unless `simulate`
+ */
+int contract( Adjacency & out, Adjacency & in, std::vector<Arc> & arcs, WitnessSearch & witness, const int node, const int limit, const bool simulate )
+{
+    int shortcuts = 0;
+    // the lists are copied since adding shortcuts modifies them
+    const std::vector<Neighbour> predecessors( in[node] );
+    const std::vector<Neighbour> successors( out[node] );
+    BOOST_FOREACH( const Neighbour & u, predecessors ) {
+        int max_distance = 0;
+        BOOST_FOREACH( const Neighbour & w, successors ) {
+            if(w.first != u.first)
+                max_distance = std::max( max_distance, arcs[u.second].weight + arcs[w.second].weight );
+        }
+        witness.run( out, arcs, u.first, node, max_distance, limit );
+
+        BOOST_FOREACH( const Neighbour & w, successors ) {
+            const int weight = arcs[u.second].weight + arcs[w.second].weight;
+            if(w.first == u.first || witness.distance[w.first] <= weight)
+                continue;
+            ++shortcuts;
+            if(!simulate) {
+                Arc shortcut;
+                shortcut.source = u.first;
+                shortcut.target = w.first;
+                shortcut.weight = weight;
+                shortcut.first = u.second;
+                shortcut.second = w.second;
+                add_arc( out, in, arcs, shortcut );
+            }
+        }
+    }
+    return shortcuts;
+}
+
+/**
+ * Arcs grouped by node, as offsets and arc ids
+ */
+void group( const std::vector< std::vector<int> > & lists, std::vector<int> & first, std::vector<int> & ids )
+{
+    first.assign( 1, 0 );
+    ids.clear();
+    BOOST_FOREACH( const std::vector<int> & list, lists ) {
+        ids.insert( ids.end(), list.begin(), list.end() );
+        first.push_back( ids.size() );
+    }
+}
+
+} // end anonymous namespace
+
+
+ContractionHierarchy::ContractionHierarchy( const Transport::Graph * graph, const EdgeMode mode, const int witness_limit ) :
+    graph(graph), mode(mode), shortcuts(0)
+{
+    BOOST_ASSERT( mode < Transport::CsrGraph::num_modes );
+    build( witness_limit );
+}
+
+ContractionHierarchy::ContractionHierarchy( const Transport::Graph * graph, const std::string & filename ) :
+    graph(graph), shortcuts(0)
+{
+    std::ifstream ifile(filename.c_str());
+    if(!ifile)
+        throw std::runtime_error( "Unable to open " + filename );
+    boost::archive::binary_iarchive iArchive(ifile);
+    std::string tag, id;
+    int stored_mode;
+    iArchive >> tag;
+    if(tag != CH_ARCHIVE_TAG)
+        throw std::runtime_error( "Not a contraction hierarchy file: " + filename );
+    iArchive >> id;
+    if(id != graph->get_id())
+        throw std::runtime_error( "Contraction hierarchy of another graph (" + id + "): " + filename );
+    iArchive >> stored_mode;
+    mode = (EdgeMode) stored_mode;
+    iArchive >> rank;
+    iArchive >> arcs;
+    iArchive >> up_first;
+    iArchive >> up_arcs;
+    iArchive >> down_first;
+    iArchive >> down_arcs;
+    // the id names the dump the graph was built from, a rebuilt graph keeps it: the content must fit the graph
+    if(!fits_graph())
+        throw std::runtime_error( "Contraction hierarchy inconsistent with the graph: " + filename );
+    BOOST_FOREACH( const Arc & arc, arcs ) {
+        if(arc.is_shortcut())
+            ++shortcuts;
+    }
+}
+
+bool ContractionHierarchy::fits_graph() const
+{
+    const Transport::CsrGraph & csr = graph->csr();
+    const size_t n = graph->num_vertices();
+    if( mode < 0 || mode >= Transport::CsrGraph::num_modes || rank.size() != n
+        || up_first.size() != n + 1 || down_first.size() != n + 1
+        || !Transport::valid_offsets(up_first, up_arcs.size()) || !Transport::valid_offsets(down_first, down_arcs.size())
+        || !Transport::all_below(up_arcs, arcs.size()) || !Transport::all_below(down_arcs, arcs.size()) )
+        return false;
+    BOOST_FOREACH( const Arc & arc, arcs ) {
+        if( arc.source < 0 || arc.source >= (int) n || arc.target < 0 || arc.target >= (int) n )
+            return false;
+        if(arc.is_shortcut()) {
+            if( arc.first < 0 || arc.first >= (int) arcs.size() || arc.second >= (int) arcs.size() )
+                return false;
+        }
+        else if( arc.first < 0 || arc.first >= csr.num_edges() || csr.type[arc.first] != mode )
+            return false;
+    }
+    return true;
+}
+
+void ContractionHierarchy::save( const std::string & filename ) const
+{
+    std::ofstream ofile(filename.c_str());
+    boost::archive::binary_oarchive oArchive(ofile);
+    const int stored_mode = mode;
+    oArchive << CH_ARCHIVE_TAG;
+    oArchive << graph->get_id();
+    oArchive << stored_mode;
+    oArchive << rank;
+    oArchive << arcs;
+    oArchive << up_first;
+    oArchive << up_arcs;
+    oArchive << down_first;
+    oArchive << down_arcs;
+}
+
+void ContractionHierarchy::build( const int witness_limit )
+{
+    const Transport::CsrGraph & csr = graph->csr();
+    const int n = graph->num_vertices();
+
+    Adjacency out(n), in(n);
+    arcs.clear();
+    for(int u=0 ; u<n ; ++u) {
+        for(int e=csr.out_begin(u, mode) ; e<csr.out_end(u, mode) ; ++e) {
+            if(csr.head[e] == u)
+                continue;
+            Arc arc;
+            arc.source = u;
+            arc.target = csr.head[e];
+            arc.weight = graph->min_duration(e).second;
+            arc.first = e;
+            arc.second = -1;
+            add_arc( out, in, arcs, arc );
+        }
+    }
+
+    WitnessSearch witness( n );
+    std::vector<int> contracted_neighbours( n, 0 );
+    std::priority_queue< std::pair<int, int>, std::vector< std::pair<int, int> >, std::greater< std::pair<int, int> > > queue;
+    for(int v=0 ; v<n ; ++v) {
+        const int priority = contract( out, in, arcs, witness, v, witness_limit, true ) - (int)(in[v].size() + out[v].size());
+        queue.push( std::make_pair(priority, v) );
+    }
+
+    rank.assign( n, -1 );
+    std::vector< std::vector<int> > up(n), down(n);
+    int next_rank = 0;
+    while( !queue.empty() ) {
+        const int v = queue.top().second;
+        queue.pop();
+
+        // priorities change as the graph is contracted, they are only updated when reaching the top
+        const int priority = contract( out, in, arcs, witness, v, witness_limit, true ) - (int)(in[v].size() + out[v].size())
+                             + contracted_neighbours[v];
+        if(!queue.empty() && priority > queue.top().first) {
+            queue.push( std::make_pair(priority, v) );
+            continue;
+        }
+
+        shortcuts += contract( out, in, arcs, witness, v, witness_limit, false );
+        rank[v] = next_rank++;
+
+        // arcs left are the ones with the nodes of higher rank
+        BOOST_FOREACH( const Neighbour & w, out[v] ) {
+            up[v].push_back( w.second );
+            remove_neighbour( in[w.first], v );
+            ++contracted_neighbours[w.first];
+        }
+        BOOST_FOREACH( const Neighbour & u, in[v] ) {
+            down[v].push_back( u.second );
+            remove_neighbour( out[u.first], v );
+            ++contracted_neighbours[u.first];
+        }
+        std::vector<Neighbour>().swap( out[v] );
+        std::vector<Neighbour>().swap( in[v] );
+    }
+
+    group( up, up_first, up_arcs );
+    group( down, down_first, down_arcs );
+}
+
+void ContractionHierarchy::unpack( const int arc, std::list<int> & edges ) const
+{
+    std::vector<int> stack( 1, arc );
+    while( !stack.empty() ) {
+        const Arc & a = arcs[stack.back()];
+        stack.pop_back();
+        if(a.is_shortcut()) {
+            stack.push_back( a.second );
+            stack.push_back( a.first );
+        } else {
+            edges.push_back( a.first );
+        }
+    }
+}
+
+boost::shared_ptr<Query> ContractionHierarchy::acquire_query() const
+{
+    return queries.acquire( [this]() { return new Query( *this ); } );
+}
+
+
+const int Query::UNREACHED;
+
+Query::Query( const ContractionHierarchy & hierarchy ) :
+    count(0), hierarchy(hierarchy), source(-1), target(-1), best(UNREACHED), meeting(-1)
+{
+    for(int d=0 ; d<2 ; ++d) {
+        distance[d].assign( hierarchy.num_nodes(), UNREACHED );
+        pred[d].assign( hierarchy.num_nodes(), -1 );
+    }
+}
+
+int Query::run( const int source, const int target )
+{
+    BOOST_FOREACH( const int n, touched ) {
+        distance[0][n] = distance[1][n] = UNREACHED;
+        pred[0][n] = pred[1][n] = -1;
+    }
+    touched.clear();
+    for(int d=0 ; d<2 ; ++d) {
+        queue[d] = Queue();
+    }
+
+    this->source = source;
+    this->target = target;
+    count = 0;
+    best = UNREACHED;
+    meeting = -1;
+
+    distance[0][source] = 0;
+    distance[1][target] = 0;
+    touched.push_back( source );
+    touched.push_back( target );
+    queue[0].push( QueueItem(0, source) );
+    queue[1].push( QueueItem(0, target) );
+
+    bool forward_active = true, backward_active = true;
+    bool forward = true;
+    while( forward_active || backward_active ) {
+        if(forward ? forward_active : backward_active) {
+            if(!step( forward )) {
+                if(forward)
+                    forward_active = false;
+                else
+                    backward_active = false;
+            }
+        }
+        forward = !forward;
+    }
+    return best == UNREACHED ? -1 : best;
+}
+
+bool Query::step( const bool forward )
+{
+    const int d = forward ? 0 : 1;
+    Queue & q = queue[d];
+    while( !q.empty() && q.top().first > distance[d][q.top().second] ) {
+        q.pop();
+    }
+    // the searches only go up: a node further than the best path cannot be on a shorter one
+    if(q.empty() || q.top().first >= best)
+        return false;
+
+    const QueueItem curr = q.top();
+    q.pop();
+    const int v = curr.second;
+    ++count;
+
+    if(distance[1-d][v] != UNREACHED && curr.first + distance[1-d][v] < best) {
+        best = curr.first + distance[1-d][v];
+        meeting = v;
+    }
+
+    // stall on demand: a higher neighbour gives a shorter way to v
+    const std::vector<int> & stall_first = forward ? hierarchy.down_first : hierarchy.up_first;
+    const std::vector<int> & stall_arcs = forward ? hierarchy.down_arcs : hierarchy.up_arcs;
+    for(int i=stall_first[v] ; i<stall_first[v+1] ; ++i) {
+        const Arc & arc = hierarchy.arcs[stall_arcs[i]];
+        const int u = forward ? arc.source : arc.target;
+        if(distance[d][u] != UNREACHED && distance[d][u] + arc.weight < curr.first)
+            return true;
+    }
+
+    const std::vector<int> & first = forward ? hierarchy.up_first : hierarchy.down_first;
+    const std::vector<int> & ids = forward ? hierarchy.up_arcs : hierarchy.down_arcs;
+    for(int i=first[v] ; i<first[v+1] ; ++i) {
+        const Arc & arc = hierarchy.arcs[ids[i]];
+        const int w = forward ? arc.target : arc.source;
+        const int dist = curr.first + arc.weight;
+        if(dist < distance[d][w]) {
+            if(distance[0][w] == UNREACHED && distance[1][w] == UNREACHED)
+                touched.push_back( w );
+            distance[d][w] = dist;
+            pred[d][w] = ids[i];
+            q.push( QueueItem(dist, w) );
+        }
+    }
+    return true;
+}
+
+Path Query::get_path() const
+{
+    Path path;
+    path.start_node = source;
+    path.end_node = target;
+    if(meeting < 0)
+        return path;
+
+    std::vector<int> up;
+    for(int v=meeting ; pred[0][v] >= 0 ; v=hierarchy.arcs[pred[0][v]].source)
+        up.push_back( pred[0][v] );
+    for(int i=up.size()-1 ; i>=0 ; --i)
+        hierarchy.unpack( up[i], path.edges );
+    for(int v=meeting ; pred[1][v] >= 0 ; v=hierarchy.arcs[pred[1][v]].target)
+        hierarchy.unpack( pred[1][v], path.edges );
+    return path;
+}
+
+} // end namespace CH
@@ -0,0 +1,205 @@
+/** Copyright : Arthur Bit-Monnot (2013)  arthur.bit-monnot@laas.fr
+
+This software is a computer program whose purpose is to [describe
+functionalities and technical features of your software].
+
+This software is governed by the CeCILL-B license under French law and
+abiding by the rules of distribution of free software.  You can  use, 
+modify and/ or redistribute the software under the terms of the CeCILL-B
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info". 
+
+As a counterpart to the access to the source code and  rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty  and the software's author,  the holder of the
+economic rights,  and the successive licensors  have only  limited
+liability. 
+
+In this respect, the user's attention is drawn to the risks associated
+with loading,  using,  modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean  that it is complicated to manipulate,  and  that  also
+therefore means  that it is reserved for developers  and  experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or 
+data to be ensured and,  more generally, to use and operate it in the 
+same conditions as regards security. 
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL-B license and that you accept its terms. 
+*/
+
+#ifndef CONTRACTION_HIERARCHY_H
+#define CONTRACTION_HIERARCHY_H
+
+#include <string>
+#include <vector>
+#include <list>
+#include <queue>
+
+#include <boost/shared_ptr.hpp>
+
+#include "graph_wrapper.h"
+#include "utils.h"
+#include "../Interface/Path.h"
+
+namespace CH {
+
+class Query;
+
+/**
+ * Arc of a contraction hierarchy.
+ *
+ * A shortcut replaces the arcs `first` and `second`, an original arc is the edge `first` of the transport graph
+ * and has -1 as `second`.
+ */
+struct Arc
+{
+    int source;
+    int target;
+    int weight;
+    int first;
+    int second;
+
+    inline bool is_shortcut() const { return second >= 0; }
+
+    template<class Archive>
+    void serialize(Archive& ar, const unsigned int version)
+    {
+        ar & source & target & weight & first & second;
+    }
+};
+
+/**
+ * Contraction hierarchy of the edges of a single mode (car, bike or foot) of a transport graph.
+ *
+ * Nodes are contracted one after the other, by increasing number of shortcuts added minus arcs removed
+ * (plus the number of neighbours already contracted to spread the contraction over the graph). Contracting a node
+ * adds a shortcut between two of its neighbours unless a bounded witness search finds a path at least as short
+ * avoiding it. Durations of road edges do not depend on time, neither does the hierarchy.
+ *
+ * The arcs of a node going up the hierarchy are kept in `up_arcs` (forward search) and the arcs coming from
+ * higher nodes in `down_arcs` (backward search).
+ */
+class ContractionHierarchy
+{
+public:
+    /**
+     * Contracts the edges of `mode` of the graph.
+     * A witness search stops after settling `witness_limit` nodes.
+     */
+    ContractionHierarchy( const Transport::Graph * graph, const EdgeMode mode, const int witness_limit = 100 );
+
+    /**
+     * Loads a hierarchy written by save(). The file must have been built from a graph with the same id.
+     * Throws std::runtime_error if its arrays do not fit the graph, as happens once the graph is rebuilt.
+     */
+    ContractionHierarchy( const Transport::Graph * graph, const std::string & filename );
+
+    void save( const std::string & filename ) const;
+
+    const Transport::Graph * graph;
+    EdgeMode mode;
+
+    inline int num_nodes() const { return rank.size(); }
+    inline int num_shortcuts() const { return shortcuts; }
+
+    /**
+     * Position of each node in the contraction order
+     */
+    std::vector<int> rank;
+
+    std::vector<Arc> arcs;
+
+    /**
+     * Arcs of node n to nodes of higher rank are up_arcs[up_first[n] .. up_first[n+1]),
+     * arcs from nodes of higher rank to n are down_arcs[down_first[n] .. down_first[n+1])
+     */
+    std::vector<int> up_first;
+    std::vector<int> up_arcs;
+    std::vector<int> down_first;
+    std::vector<int> down_arcs;
+
+    /**
+     * Appends to `edges` the edges of the transport graph replaced by an arc, in order
+     */
+    void unpack( const int arc, std::list<int> & edges ) const;
+
+    /**
+     * A query on the hierarchy that no other thread is running, reused from one call to the next.
+     * It must be released before the hierarchy is destroyed.
+     */
+    boost::shared_ptr<Query> acquire_query() const;
+
+private:
+    void build( const int witness_limit );
+
+    /**
+     * True if the ranks, offsets and arc ids index the graph and each other within bounds
+     */
+    bool fits_graph() const;
+
+    int shortcuts;
+
+    mutable ObjectPool<Query> queries;
+};
+
+/**
+ * Bidirectional query on a contraction hierarchy: both searches only go up the hierarchy and meet on the
+ * highest node of the shortest path. A node reached with a longer distance than through one of its
+ * higher neighbours is not expanded (stall on demand).
+ *
+ * An instance can be reused for several queries, only the nodes reached by the previous one being reset:
+ * ContractionHierarchy::acquire_query() gives one back for each query instead of filling new arrays.
+ */
+class Query
+{
+public:
+    Query( const ContractionHierarchy & hierarchy );
+
+    /**
+     * Returns the duration of the shortest path from source to target, -1 if there is none
+     */
+    int run( const int source, const int target );
+
+    /**
+     * Shortest path found by the last run, with the edges of the transport graph
+     */
+    Path get_path() const;
+
+    /**
+     * Number of nodes settled by the last run
+     */
+    int count;
+
+private:
+    static const int UNREACHED = 0x7fffffff;
+
+    typedef std::pair<int, int> QueueItem;
+    typedef std::priority_queue< QueueItem, std::vector<QueueItem>, std::greater<QueueItem> > Queue;
+
+    /**
+     * Settles the next node of one direction, returns false once it cannot improve the best path anymore
+     */
+    bool step( const bool forward );
+
+    const ContractionHierarchy & hierarchy;
+
+    int source;
+    int target;
+    int best;
+    int meeting;
+
+    /**
+     * Distance and arc of the predecessor of each node, for the forward and backward search
+     */
+    std::vector<int> distance[2];
+    std::vector<int> pred[2];
+    Queue queue[2];
+    std::vector<int> touched;
+};
+
+} // end namespace CH
+
+#endif
@@ -0,0 +1,257 @@
+/** Copyright : Arthur Bit-Monnot (2013)  arthur.bit-monnot@laas.fr
+
+This software is a computer program whose purpose is to [describe
+functionalities and technical features of your software].
+
+This software is governed by the CeCILL-B license under French law and
+abiding by the rules of distribution of free software.  You can  use, 
+modify and/ or redistribute the software under the terms of the CeCILL-B
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info". 
+
+As a counterpart to the access to the source code and  rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty  and the software's author,  the holder of the
+economic rights,  and the successive licensors  have only  limited
+liability. 
+
+In this respect, the user's attention is drawn to the risks associated
+with loading,  using,  modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean  that it is complicated to manipulate,  and  that  also
+therefore means  that it is reserved for developers  and  experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or 
+data to be ensured and,  more generally, to use and operate it in the 
+same conditions as regards security. 
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL-B license and that you accept its terms. 
+*/
+
+#include "HubLabels.h"
+
+#include <fstream>
+#include <stdexcept>
+#include <algorithm>
+#include <cstring>
+#include <boost/foreach.hpp>
+#include <boost/cstdint.hpp>
+
+namespace CH {
+
+namespace {
+
+const int UNREACHED = 0x7fffffff;
+
+/**
+ * Smallest sum of distances over the hubs common to two labels sorted by hub, UNREACHED if there is none
+ */
+inline int merge_labels( const HubEntry * f, const HubEntry * f_end, const HubEntry * b, const HubEntry * b_end )
+{
+    int best = UNREACHED;
+    while( f != f_end && b != b_end ) {
+        if(f->hub < b->hub) {
+            ++f;
+        } else if(f->hub > b->hub) {
+            ++b;
+        } else {
+            best = std::min( best, f->distance + b->distance );
+            ++f;
+            ++b;
+        }
+    }
+    return best;
+}
+
+inline bool by_hub( const HubEntry & a, const HubEntry & b )
+{
+    return a.hub < b.hub || (a.hub == b.hub && a.distance < b.distance);
+}
+
+/**
+ * Layout of the files written by HubLabels::save(): a LabelsHeader followed by one section per array,
+ * each section starting on a LABELS_ALIGNMENT bytes boundary.
+ */
+const char LABELS_MAGIC[8] = { 'M', 'U', 'M', 'O', 'R', 'O', 'H', 'L' };
+const boost::uint32_t LABELS_VERSION = 1;
+const boost::uint64_t LABELS_ALIGNMENT = 64;
+
+enum LabelsSection {
+    IdSection, ForwardFirstSection, ForwardEntriesSection, BackwardFirstSection, BackwardEntriesSection,
+    NumLabelsSections
+};
+
+struct LabelsHeader
+{
+    char magic[8];
+    boost::uint32_t version;
+    boost::int32_t mode;
+    boost::uint64_t offset[NumLabelsSections];
+    boost::uint64_t count[NumLabelsSections];
+};
+
+template<typename T>
+void write_section( std::ofstream & out, LabelsHeader & header, const LabelsSection section, const T * data, const size_t count )
+{
+    const boost::uint64_t pos = out.tellp();
+    const boost::uint64_t padding = (LABELS_ALIGNMENT - pos % LABELS_ALIGNMENT) % LABELS_ALIGNMENT;
+    const char zeros[LABELS_ALIGNMENT] = { 0 };
+    out.write( zeros, padding );
+
+    header.offset[section] = pos + padding;
+    header.count[section] = count;
+    out.write( reinterpret_cast<const char *>(data), count * sizeof(T) );
+}
+
+template<typename T>
+void map_section( const Transport::MappedFile & file, const LabelsHeader & header, const LabelsSection section, Transport::FlatArray<T> & array )
+{
+    const boost::uint64_t offset = header.offset[section];
+    const boost::uint64_t count = header.count[section];
+    if( offset % LABELS_ALIGNMENT != 0 || offset > file.size() || count > (file.size() - offset) / sizeof(T) )
+        throw std::runtime_error( "Corrupted section in hub labels file" );
+
+    array.borrow( reinterpret_cast<const T *>(file.data() + offset), count );
+}
+
+} // end anonymous namespace
+
+HubLabels::HubLabels( const ContractionHierarchy & hierarchy ) :
+    graph(hierarchy.graph), mode(hierarchy.mode)
+{
+    const int n = hierarchy.num_nodes();
+    std::vector<int> order( n );
+    for(int v=0 ; v<n ; ++v)
+        order[hierarchy.rank[v]] = v;
+
+    // labels of the upper neighbours are needed first
+    std::vector< std::vector<HubEntry> > labels[2];
+    labels[0].resize( n );
+    labels[1].resize( n );
+    for(int r=n-1 ; r>=0 ; --r) {
+        const int v = order[r];
+        for(int dir=0 ; dir<2 ; ++dir) {
+            std::vector<HubEntry> & label = labels[dir][v];
+            const HubEntry self = { r, 0 };
+            label.push_back( self );
+
+            const std::vector<int> & first = dir == 0 ? hierarchy.up_first : hierarchy.down_first;
+            const std::vector<int> & arcs = dir == 0 ? hierarchy.up_arcs : hierarchy.down_arcs;
+            for(int i=first[v] ; i<first[v+1] ; ++i) {
+                const Arc & arc = hierarchy.arcs[arcs[i]];
+                const int w = dir == 0 ? arc.target : arc.source;
+                BOOST_FOREACH( const HubEntry & e, labels[dir][w] ) {
+                    const HubEntry shifted = { e.hub, e.distance + arc.weight };
+                    label.push_back( shifted );
+                }
+            }
+
+            // only the shortest distance to each hub is kept
+            std::sort( label.begin(), label.end(), by_hub );
+            std::vector<HubEntry> candidates;
+            BOOST_FOREACH( const HubEntry & e, label ) {
+                if(candidates.empty() || candidates.back().hub != e.hub)
+                    candidates.push_back( e );
+            }
+
+            label.clear();
+            const HubEntry * c_begin = candidates.data();
+            const HubEntry * c_end = c_begin + candidates.size();
+            BOOST_FOREACH( const HubEntry & e, candidates ) {
+                // the vertex itself is always kept, and its other label is not built yet
+                if(e.hub == r) {
+                    label.push_back( e );
+                    continue;
+                }
+                const std::vector<HubEntry> & other = labels[1-dir][order[e.hub]];
+                const int through_hubs = dir == 0 ?
+                    merge_labels( c_begin, c_end, other.data(), other.data() + other.size() ) :
+                    merge_labels( other.data(), other.data() + other.size(), c_begin, c_end );
+                if(through_hubs >= e.distance)
+                    label.push_back( e );
+            }
+        }
+    }
+
+    for(int dir=0 ; dir<2 ; ++dir) {
+        std::vector<int> first_entry( 1, 0 );
+        std::vector<HubEntry> all_entries;
+        for(int v=0 ; v<n ; ++v) {
+            all_entries.insert( all_entries.end(), labels[dir][v].begin(), labels[dir][v].end() );
+            first_entry.push_back( all_entries.size() );
+            std::vector<HubEntry>().swap( labels[dir][v] );
+        }
+        first[dir].assign( first_entry );
+        entries[dir].assign( all_entries );
+    }
+}
+
+HubLabels::HubLabels( const Transport::Graph * graph, const std::string & filename ) :
+    graph(graph)
+{
+    mapped_file.reset( new Transport::MappedFile(filename) );
+
+    LabelsHeader header;
+    if( mapped_file->size() < sizeof(header) )
+        throw std::runtime_error( "Not a hub labels file: " + filename );
+    memcpy( &header, mapped_file->data(), sizeof(header) );
+    if( memcmp(header.magic, LABELS_MAGIC, sizeof(LABELS_MAGIC)) != 0 || header.version != LABELS_VERSION
+        || header.mode < 0 || header.mode >= Transport::CsrGraph::num_modes )
+        throw std::runtime_error( "Unsupported hub labels file: " + filename );
+    mode = (EdgeMode) header.mode;
+
+    Transport::FlatArray<char> id_chars;
+    map_section( *mapped_file, header, IdSection, id_chars );
+    const std::string id( id_chars.begin(), id_chars.end() );
+    if(id != graph->get_id())
+        throw std::runtime_error( "Hub labels of another graph (" + id + "): " + filename );
+
+    map_section( *mapped_file, header, ForwardFirstSection, first[0] );
+    map_section( *mapped_file, header, ForwardEntriesSection, entries[0] );
+    map_section( *mapped_file, header, BackwardFirstSection, first[1] );
+    map_section( *mapped_file, header, BackwardEntriesSection, entries[1] );
+    // distance() reads the entries between the offsets of its nodes, without bound checks
+    const int n = graph->num_vertices();
+    for(int dir=0 ; dir<2 ; ++dir) {
+        if( (int) first[dir].size() != n + 1 || !Transport::valid_offsets(first[dir], entries[dir].size()) )
+            throw std::runtime_error( "Corrupted section in hub labels file" );
+        for(const HubEntry * e=entries[dir].begin() ; e!=entries[dir].end() ; ++e) {
+            if(e->hub < 0 || e->hub >= n)
+                throw std::runtime_error( "Corrupted section in hub labels file" );
+        }
+    }
+}
+
+void HubLabels::save( const std::string & filename ) const
+{
+    LabelsHeader header;
+    memset( &header, 0, sizeof(header) );
+    memcpy( header.magic, LABELS_MAGIC, sizeof(LABELS_MAGIC) );
+    header.version = LABELS_VERSION;
+    header.mode = mode;
+
+    std::ofstream ofile( filename.c_str(), std::ios::binary );
+    ofile.write( reinterpret_cast<const char *>(&header), sizeof(header) );
+
+    const std::string id = graph->get_id();
+    write_section( ofile, header, IdSection, id.data(), id.size() );
+    write_section( ofile, header, ForwardFirstSection, first[0].data(), first[0].size() );
+    write_section( ofile, header, ForwardEntriesSection, entries[0].data(), entries[0].size() );
+    write_section( ofile, header, BackwardFirstSection, first[1].data(), first[1].size() );
+    write_section( ofile, header, BackwardEntriesSection, entries[1].data(), entries[1].size() );
+
+    ofile.seekp( 0 );
+    ofile.write( reinterpret_cast<const char *>(&header), sizeof(header) );
+}
+
+int HubLabels::distance( const int source, const int target ) const
+{
+    const HubEntry * f = entries[0].data();
+    const HubEntry * b = entries[1].data();
+    const int best = merge_labels( f + first[0][source], f + first[0][source+1], b + first[1][target], b + first[1][target+1] );
+    return best == UNREACHED ? -1 : best;
+}
+
+} // end namespace CH
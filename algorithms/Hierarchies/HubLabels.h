@@ -0,0 +1,107 @@
+/** Copyright : Arthur Bit-Monnot (2013)  arthur.bit-monnot@laas.fr
+
+This software is a computer program whose purpose is to [describe
+functionalities and technical features of your software].
+
+This software is governed by the CeCILL-B license under French law and
+abiding by the rules of distribution of free software.  You can  use, 
+modify and/ or redistribute the software under the terms of the CeCILL-B
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info". 
+
+As a counterpart to the access to the source code and  rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty  and the software's author,  the holder of the
+economic rights,  and the successive licensors  have only  limited
+liability. 
+
+In this respect, the user's attention is drawn to the risks associated
+with loading,  using,  modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean  that it is complicated to manipulate,  and  that  also
+therefore means  that it is reserved for developers  and  experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or 
+data to be ensured and,  more generally, to use and operate it in the 
+same conditions as regards security. 
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL-B license and that you accept its terms. 
+*/
+
+#ifndef HUB_LABELS_H
+#define HUB_LABELS_H
+
+#include <string>
+#include <boost/shared_ptr.hpp>
+
+#include "ContractionHierarchy.h"
+#include "flat_array.h"
+#include "mapped_file.h"
+
+namespace CH {
+
+/**
+ * Hub of a label: rank of the node in the contraction hierarchy and distance to (or from) it
+ */
+struct HubEntry
+{
+    int hub;
+    int distance;
+};
+
+/**
+ * Hub labels of the edges of a single mode of a transport graph.
+ *
+ * The forward (resp. backward) label of a node holds the nodes of higher rank in a contraction hierarchy that
+ * its upward search reaches, with their distance from (resp. to) it. The highest node of any shortest path is in
+ * the forward label of its source and the backward label of its target, a distance is hence the minimum over the
+ * hubs common to both labels. Labels are computed from the highest node down, each one from the labels of its
+ * upper neighbours; a hub that is reached faster through another hub of the label is dropped.
+ *
+ * Labels are sorted by hub and stored contiguously, in a file that is memory mapped when loaded.
+ */
+class HubLabels
+{
+public:
+    /**
+     * Computes the labels from a contraction hierarchy
+     */
+    HubLabels( const ContractionHierarchy & hierarchy );
+
+    /**
+     * Maps the labels written by save(). The file must have been built from a graph with the same id.
+     * Throws std::runtime_error if its mode, offsets or hubs do not fit the graph.
+     */
+    HubLabels( const Transport::Graph * graph, const std::string & filename );
+
+    void save( const std::string & filename ) const;
+
+    const Transport::Graph * graph;
+    EdgeMode mode;
+
+    /**
+     * Duration of the shortest path from source to target, -1 if there is none.
+     * Runs in the size of the labels of both nodes.
+     */
+    int distance( const int source, const int target ) const;
+
+    /**
+     * Number of hubs in the forward and backward labels of all nodes
+     */
+    inline int num_entries() const { return entries[0].size() + entries[1].size(); }
+
+private:
+    /**
+     * Forward (0) and backward (1) label of node n are entries[.][first[.][n] .. first[.][n+1])
+     */
+    Transport::FlatArray<int> first[2];
+    Transport::FlatArray<HubEntry> entries[2];
+
+    boost::shared_ptr<Transport::MappedFile> mapped_file;
+};
+
+} // end namespace CH
+
+#endif
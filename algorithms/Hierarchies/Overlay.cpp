@@ -0,0 +1,395 @@
+/** Copyright : Arthur Bit-Monnot (2013)  arthur.bit-monnot@laas.fr
+
+This software is a computer program whose purpose is to [describe
+functionalities and technical features of your software].
+
+This software is governed by the CeCILL-B license under French law and
+abiding by the rules of distribution of free software.  You can  use, 
+modify and/ or redistribute the software under the terms of the CeCILL-B
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info". 
+
+As a counterpart to the access to the source code and  rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty  and the software's author,  the holder of the
+economic rights,  and the successive licensors  have only  limited
+liability. 
+
+In this respect, the user's attention is drawn to the risks associated
+with loading,  using,  modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean  that it is complicated to manipulate,  and  that  also
+therefore means  that it is reserved for developers  and  experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or 
+data to be ensured and,  more generally, to use and operate it in the 
+same conditions as regards security. 
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL-B license and that you accept its terms. 
+*/
+
+#include "Overlay.h"
+
+#include <fstream>
+#include <stdexcept>
+#include <unordered_map>
+#include <boost/foreach.hpp>
+#include <boost/serialization/vector.hpp>
+#include <boost/archive/binary_iarchive.hpp>
+#include <boost/archive/binary_oarchive.hpp>
+
+#include "utils.h"
+
+namespace CH {
+
+namespace {
+
+const std::string PARTITION_ARCHIVE_TAG = "#mumoro-partition";
+
+const int INFINITE = 0x7fffffff;
+
+typedef std::pair<int, int> QueueItem;
+typedef std::priority_queue< QueueItem, std::vector<QueueItem>, std::greater<QueueItem> > Queue;
+
+} // end anonymous namespace
+
+
+Partition::Partition( const Transport::Graph * graph, const std::vector<int> & cell_sizes ) :
+    graph(graph)
+{
+    const int n = graph->num_vertices();
+    for(uint l=0 ; l<cell_sizes.size() ; ++l) {
+        BOOST_ASSERT( cell_sizes[l] > 0 );
+        BOOST_ASSERT( l == 0 || cell_sizes[l] % cell_sizes[l-1] == 0 );
+        cells.push_back( std::vector<int>(n) );
+        for(int v=0 ; v<n ; ++v)
+            cells[l][v] = v / cell_sizes[l];
+        cell_count.push_back( (n + cell_sizes[l] - 1) / cell_sizes[l] );
+    }
+}
+
+Partition::Partition( const Transport::Graph * graph, const std::string & filename ) :
+    graph(graph)
+{
+    std::ifstream ifile(filename.c_str());
+    if(!ifile)
+        throw std::runtime_error( "Unable to open " + filename );
+    boost::archive::binary_iarchive iArchive(ifile);
+    std::string tag, id;
+    iArchive >> tag;
+    if(tag != PARTITION_ARCHIVE_TAG)
+        throw std::runtime_error( "Not a partition file: " + filename );
+    iArchive >> id;
+    if(id != graph->get_id())
+        throw std::runtime_error( "Partition of another graph (" + id + "): " + filename );
+    iArchive >> cells;
+    iArchive >> cell_count;
+    // the id names the dump the graph was built from, a rebuilt graph keeps it: the cells must fit the graph
+    bool fits_graph = cell_count.size() == cells.size();
+    for(uint l=0 ; l<cells.size() && fits_graph ; ++l) {
+        fits_graph = (int) cells[l].size() == graph->num_vertices() && cell_count[l] >= 0
+            && Transport::all_below( cells[l], cell_count[l] );
+    }
+    if(!fits_graph)
+        throw std::runtime_error( "Partition inconsistent with the graph: " + filename );
+}
+
+void Partition::save( const std::string & filename ) const
+{
+    std::ofstream ofile(filename.c_str());
+    boost::archive::binary_oarchive oArchive(ofile);
+    oArchive << PARTITION_ARCHIVE_TAG;
+    oArchive << graph->get_id();
+    oArchive << cells;
+    oArchive << cell_count;
+}
+
+
+Overlay::Overlay( const Partition & partition, const EdgeMode mode ) :
+    graph(partition.graph), partition(partition), mode(mode)
+{
+    BOOST_ASSERT( mode < Transport::CsrGraph::num_modes );
+    const Transport::CsrGraph & csr = graph->csr();
+    const int n = graph->num_vertices();
+
+    levels.resize( partition.num_levels() );
+    for(int l=0 ; l<partition.num_levels() ; ++l) {
+        Level & level = levels[l];
+        std::vector< std::vector<int> > boundary( partition.num_cells(l) );
+        for(int v=0 ; v<n ; ++v) {
+            const int cell = partition.cell(l, v);
+            bool is_boundary = false;
+            for(int e=csr.out_begin(v, mode) ; e<csr.out_end(v, mode) && !is_boundary ; ++e)
+                is_boundary = partition.cell(l, csr.head[e]) != cell;
+            for(int i=csr.in_begin(v, mode) ; i<csr.in_end(v, mode) && !is_boundary ; ++i)
+                is_boundary = partition.cell(l, csr.tail[csr.in_edge_id[i]]) != cell;
+            if(is_boundary)
+                boundary[cell].push_back( v );
+        }
+
+        level.position.assign( n, -1 );
+        level.first_boundary.assign( 1, 0 );
+        level.first_distance.assign( 1, 0 );
+        for(int c=0 ; c<partition.num_cells(l) ; ++c) {
+            for(uint i=0 ; i<boundary[c].size() ; ++i) {
+                level.position[boundary[c][i]] = i;
+                level.boundary.push_back( boundary[c][i] );
+            }
+            level.first_boundary.push_back( level.boundary.size() );
+            level.first_distance.push_back( level.first_distance.back() + boundary[c].size() * boundary[c].size() );
+        }
+        level.distances.assign( level.first_distance.back(), -1 );
+    }
+}
+
+void Overlay::customize( const int threads )
+{
+    std::vector<int> durations( graph->csr().num_edges(), -1 );
+    for(uint e=0 ; e<durations.size() ; ++e) {
+        if(graph->csr().type[e] == mode)
+            durations[e] = graph->min_duration(e).second;
+    }
+    customize( durations, threads );
+}
+
+void Overlay::customize( const std::vector<int> & durations, const int threads )
+{
+    if((int) durations.size() != graph->csr().num_edges())
+        throw std::invalid_argument( "The overlay needs one duration per edge of the graph" );
+    metric = durations;
+    for(uint e=0 ; e<metric.size() ; ++e) {
+        if(graph->csr().type[e] != mode)
+            metric[e] = -1;
+    }
+
+    // buffers of each thread, kept from one cell to the next
+    std::vector< std::vector<int> > distance( num_threads(threads) );
+    std::vector< std::vector<int> > touched( distance.size() );
+    for(int l=0 ; l<partition.num_levels() ; ++l) {
+        // each level needs the cliques of the previous one
+        parallel_for( partition.num_cells(l), threads, [&]( const int c, const int t ) {
+            if(distance[t].empty())
+                distance[t].assign( graph->num_vertices(), INFINITE );
+            customize_cell( l, c, distance[t], touched[t] );
+        } );
+    }
+}
+
+void Overlay::customize_cell( const int l, const int cell, std::vector<int> & distance, std::vector<int> & touched )
+{
+    const Transport::CsrGraph & csr = graph->csr();
+    Level & level = levels[l];
+    const int first = level.first_boundary[cell];
+    const int size = level.num_boundary(cell);
+
+    for(int i=0 ; i<size ; ++i) {
+        BOOST_FOREACH( const int v, touched ) {
+            distance[v] = INFINITE;
+        }
+        touched.clear();
+
+        Queue queue;
+        const int source = level.boundary[first + i];
+        distance[source] = 0;
+        touched.push_back( source );
+        queue.push( QueueItem(0, source) );
+        int found = 0;
+        while( !queue.empty() && found < size ) {
+            const QueueItem curr = queue.top();
+            queue.pop();
+            const int u = curr.second;
+            if(curr.first > distance[u])
+                continue;
+            if(level.position[u] >= 0)
+                ++found;
+
+            // edges of the graph inside the cell, only those between subcells above level 0
+            const int subcell = l > 0 ? partition.cell(l-1, u) : -1;
+            for(int e=csr.out_begin(u, mode) ; e<csr.out_end(u, mode) ; ++e) {
+                const int v = csr.head[e];
+                if(metric[e] < 0 || partition.cell(l, v) != cell || (l > 0 && partition.cell(l-1, v) == subcell))
+                    continue;
+                if(curr.first + metric[e] < distance[v]) {
+                    if(distance[v] == INFINITE)
+                        touched.push_back( v );
+                    distance[v] = curr.first + metric[e];
+                    queue.push( QueueItem(distance[v], v) );
+                }
+            }
+
+            // clique of the subcell
+            if(l > 0) {
+                const Level & below = levels[l-1];
+                const int * row = below.row( subcell, u );
+                for(int j=0 ; j<below.num_boundary(subcell) ; ++j) {
+                    const int v = below.boundary[below.first_boundary[subcell] + j];
+                    if(row[j] < 0 || curr.first + row[j] >= distance[v])
+                        continue;
+                    if(distance[v] == INFINITE)
+                        touched.push_back( v );
+                    distance[v] = curr.first + row[j];
+                    queue.push( QueueItem(distance[v], v) );
+                }
+            }
+        }
+
+        int * row = &level.distances[level.first_distance[cell] + i * size];
+        for(int j=0 ; j<size ; ++j) {
+            const int d = distance[level.boundary[first + j]];
+            row[j] = d == INFINITE ? -1 : d;
+        }
+    }
+}
+
+boost::shared_ptr<OverlayQuery> Overlay::acquire_query() const
+{
+    return queries.acquire( [this]() { return new OverlayQuery( *this ); } );
+}
+
+
+const int OverlayQuery::UNREACHED;
+
+OverlayQuery::OverlayQuery( const Overlay & overlay ) :
+    count(0), overlay(overlay), source(-1), target(-1),
+    distance(overlay.graph->num_vertices(), UNREACHED),
+    pred_node(overlay.graph->num_vertices(), -1),
+    pred_edge(overlay.graph->num_vertices(), -1),
+    pred_level(overlay.graph->num_vertices(), -1)
+{
+}
+
+int OverlayQuery::query_level( const int node ) const
+{
+    const Partition & partition = overlay.partition;
+    for(int l=partition.num_levels()-1 ; l>=0 ; --l) {
+        const int cell = partition.cell(l, node);
+        if(cell != partition.cell(l, source) && cell != partition.cell(l, target))
+            return l;
+    }
+    return -1;
+}
+
+inline void OverlayQuery::relax( const int node, const int dist, const int from, const int edge, const int level )
+{
+    if(dist >= distance[node])
+        return;
+    if(distance[node] == UNREACHED)
+        touched.push_back( node );
+    distance[node] = dist;
+    pred_node[node] = from;
+    pred_edge[node] = edge;
+    pred_level[node] = level;
+    queue.push( QueueItem(dist, node) );
+}
+
+int OverlayQuery::run( const int source, const int target )
+{
+    if(overlay.metric.empty())
+        throw std::logic_error( "The overlay must be customized before it is queried" );
+
+    BOOST_FOREACH( const int v, touched ) {
+        distance[v] = UNREACHED;
+        pred_node[v] = -1;
+    }
+    touched.clear();
+    queue = std::priority_queue< QueueItem, std::vector<QueueItem>, std::greater<QueueItem> >();
+    this->source = source;
+    this->target = target;
+    count = 0;
+
+    const Transport::CsrGraph & csr = overlay.graph->csr();
+    const Partition & partition = overlay.partition;
+    relax( source, 0, -1, -1, -1 );
+    while( !queue.empty() ) {
+        const QueueItem curr = queue.top();
+        queue.pop();
+        const int u = curr.second;
+        if(curr.first > distance[u])
+            continue;
+        ++count;
+        if(u == target)
+            return curr.first;
+
+        // away from the source and the target: the clique of the cell, then only the edges leaving it
+        const int l = query_level( u );
+        if(l >= 0) {
+            const Overlay::Level & level = overlay.levels[l];
+            const int cell = partition.cell(l, u);
+            BOOST_ASSERT( level.position[u] >= 0 );
+            const int * row = level.row( cell, u );
+            for(int j=0 ; j<level.num_boundary(cell) ; ++j) {
+                if(row[j] >= 0)
+                    relax( level.boundary[level.first_boundary[cell] + j], curr.first + row[j], u, -1, l );
+            }
+        }
+        for(int e=csr.out_begin(u, overlay.mode) ; e<csr.out_end(u, overlay.mode) ; ++e) {
+            const int v = csr.head[e];
+            if(overlay.metric[e] >= 0 && (l < 0 || partition.cell(l, v) != partition.cell(l, u)))
+                relax( v, curr.first + overlay.metric[e], u, e, -1 );
+        }
+    }
+    return -1;
+}
+
+void OverlayQuery::unpack( const int level, const int from, const int to, std::list<int> & edges ) const
+{
+    const Transport::CsrGraph & csr = overlay.graph->csr();
+    const Partition & partition = overlay.partition;
+    const int cell = partition.cell(level, from);
+
+    // Dijkstra restricted to the cell, the predecessor edge being kept along the distance
+    std::unordered_map<int, std::pair<int, int> > labels;
+    Queue queue;
+    labels[from] = std::make_pair( 0, -1 );
+    queue.push( QueueItem(0, from) );
+    while( !queue.empty() ) {
+        const QueueItem curr = queue.top();
+        queue.pop();
+        const int u = curr.second;
+        if(curr.first > labels[u].first)
+            continue;
+        if(u == to)
+            break;
+        for(int e=csr.out_begin(u, overlay.mode) ; e<csr.out_end(u, overlay.mode) ; ++e) {
+            const int v = csr.head[e];
+            if(overlay.metric[e] < 0 || partition.cell(level, v) != cell)
+                continue;
+            const int d = curr.first + overlay.metric[e];
+            std::unordered_map<int, std::pair<int, int> >::iterator it = labels.find( v );
+            if(it == labels.end() || d < it->second.first) {
+                labels[v] = std::make_pair( d, e );
+                queue.push( QueueItem(d, v) );
+            }
+        }
+    }
+
+    std::list<int> path;
+    for(int v=to ; v != from ; v=csr.tail[labels[v].second])
+        path.push_front( labels[v].second );
+    edges.splice( edges.end(), path );
+}
+
+Path OverlayQuery::get_path() const
+{
+    Path path;
+    path.start_node = source;
+    path.end_node = target;
+    if(target < 0 || distance[target] == UNREACHED)
+        return path;
+
+    std::vector<int> nodes;
+    for(int v=target ; v != source ; v=pred_node[v])
+        nodes.push_back( v );
+    for(int i=nodes.size()-1 ; i>=0 ; --i) {
+        const int v = nodes[i];
+        if(pred_edge[v] >= 0)
+            path.edges.push_back( pred_edge[v] );
+        else
+            unpack( pred_level[v], pred_node[v], v, path.edges );
+    }
+    return path;
+}
+
+} // end namespace CH
@@ -0,0 +1,225 @@
+/** Copyright : Arthur Bit-Monnot (2013)  arthur.bit-monnot@laas.fr
+
+This software is a computer program whose purpose is to [describe
+functionalities and technical features of your software].
+
+This software is governed by the CeCILL-B license under French law and
+abiding by the rules of distribution of free software.  You can  use, 
+modify and/ or redistribute the software under the terms of the CeCILL-B
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info". 
+
+As a counterpart to the access to the source code and  rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty  and the software's author,  the holder of the
+economic rights,  and the successive licensors  have only  limited
+liability. 
+
+In this respect, the user's attention is drawn to the risks associated
+with loading,  using,  modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean  that it is complicated to manipulate,  and  that  also
+therefore means  that it is reserved for developers  and  experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or 
+data to be ensured and,  more generally, to use and operate it in the 
+same conditions as regards security. 
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL-B license and that you accept its terms. 
+*/
+
+#ifndef OVERLAY_H
+#define OVERLAY_H
+
+#include <string>
+#include <vector>
+#include <queue>
+
+#include <boost/shared_ptr.hpp>
+
+#include "graph_wrapper.h"
+#include "utils.h"
+#include "../Interface/Path.h"
+
+namespace CH {
+
+class OverlayQuery;
+
+/**
+ * Nested partition of the nodes of a graph in cells, level 0 having the smallest cells.
+ * Each cell of a level is included in a cell of the next one.
+ */
+class Partition
+{
+public:
+    /**
+     * Cells of level l are made of cell_sizes[l] consecutive nodes. Nodes being numbered along a Hilbert curve
+     * (see Transport::Graph::internal_node), cells are compact regions. Each size must divide the next one.
+     */
+    Partition( const Transport::Graph * graph, const std::vector<int> & cell_sizes );
+
+    /**
+     * Loads a partition written by save(). The file must have been built from a graph with the same id.
+     * Throws std::runtime_error if the cells do not fit the graph, as happens once the graph is rebuilt.
+     */
+    Partition( const Transport::Graph * graph, const std::string & filename );
+
+    void save( const std::string & filename ) const;
+
+    const Transport::Graph * graph;
+
+    inline int num_levels() const { return cells.size(); }
+    inline int num_cells( const int level ) const { return cell_count[level]; }
+    inline int cell( const int level, const int node ) const { return cells[level][node]; }
+
+private:
+    /**
+     * Cell of each node, by level
+     */
+    std::vector< std::vector<int> > cells;
+    std::vector<int> cell_count;
+};
+
+/**
+ * Multilevel overlay of the edges of a single mode, as in Customizable Route Planning.
+ *
+ * A node is a boundary node of a level if one of its edges leads to (or comes from) another cell of that level.
+ * The overlay stores, for each cell, the distances between all its boundary nodes (a clique) using paths
+ * inside the cell. Boundary nodes only depend on the partition and are computed once, customization computes the
+ * cliques from the current durations: level 0 on the edges inside each cell, higher levels on the cliques of
+ * the level below and the edges between its cells. Cells of a level are customized in parallel.
+ */
+class Overlay
+{
+public:
+    /**
+     * The overlay keeps its own copy of the partition, which may be destroyed afterwards
+     */
+    Overlay( const Partition & partition, const EdgeMode mode );
+
+    /**
+     * Computes the cliques with the durations of the graph, using `threads` threads (0: one per core)
+     */
+    void customize( const int threads = 0 );
+
+    /**
+     * Computes the cliques with the given duration of each edge of the graph (for instance with traffic).
+     * Edges with a negative duration are closed. Throws std::invalid_argument if there is not one duration per edge.
+     */
+    void customize( const std::vector<int> & durations, const int threads = 0 );
+
+    const Transport::Graph * graph;
+    const Partition partition;
+    const EdgeMode mode;
+
+    /**
+     * Duration of each edge of the mode used by the last customization, -1 if closed or of another mode
+     */
+    std::vector<int> metric;
+
+    struct Level {
+        /**
+         * Boundary nodes of cell c are boundary[first_boundary[c] .. first_boundary[c+1])
+         */
+        std::vector<int> first_boundary;
+        std::vector<int> boundary;
+
+        /**
+         * Index of each node in the boundary nodes of its cell, -1 if it is not one
+         */
+        std::vector<int> position;
+
+        /**
+         * Distances between the boundary nodes of cell c, row major, from first_distance[c].
+         * -1 if there is no path inside the cell.
+         */
+        std::vector<int> first_distance;
+        std::vector<int> distances;
+
+        inline int num_boundary( const int cell ) const { return first_boundary[cell+1] - first_boundary[cell]; }
+        inline const int * row( const int cell, const int from ) const {
+            return &distances[first_distance[cell] + position[from] * num_boundary(cell)];
+        }
+    };
+
+    std::vector<Level> levels;
+
+    /**
+     * A query on the overlay that no other thread is running, reused from one call to the next.
+     * It must be released before the overlay is destroyed.
+     */
+    boost::shared_ptr<OverlayQuery> acquire_query() const;
+
+private:
+    void customize_cell( const int level, const int cell, std::vector<int> & distance, std::vector<int> & touched );
+
+    mutable ObjectPool<OverlayQuery> queries;
+};
+
+/**
+ * Dijkstra on the overlay: around the source and the target it uses the edges of the graph, elsewhere the
+ * cliques of the highest level whose cell contains neither of them.
+ *
+ * An instance can be reused for several queries, only the nodes reached by the previous one being reset:
+ * Overlay::acquire_query() gives one back for each query instead of filling new arrays.
+ */
+class OverlayQuery
+{
+public:
+    OverlayQuery( const Overlay & overlay );
+
+    /**
+     * Returns the duration of the shortest path from source to target, -1 if there is none.
+     * Throws std::logic_error if the overlay has not been customized.
+     */
+    int run( const int source, const int target );
+
+    /**
+     * Shortest path found by the last run, cliques being unpacked to the edges of the graph
+     */
+    Path get_path() const;
+
+    /**
+     * Number of nodes settled by the last run
+     */
+    int count;
+
+private:
+    static const int UNREACHED = 0x7fffffff;
+
+    /**
+     * Highest level whose cell of `node` contains neither the source nor the target, -1 if none
+     */
+    int query_level( const int node ) const;
+
+    inline void relax( const int node, const int dist, const int pred_node, const int pred_edge, const int pred_level );
+
+    /**
+     * Edges of the graph of a shortest path between two nodes of the same cell, staying in that cell
+     */
+    void unpack( const int level, const int from, const int to, std::list<int> & edges ) const;
+
+    const Overlay & overlay;
+
+    int source;
+    int target;
+
+    typedef std::pair<int, int> QueueItem;
+    std::priority_queue< QueueItem, std::vector<QueueItem>, std::greater<QueueItem> > queue;
+
+    std::vector<int> distance;
+
+    /**
+     * Predecessor of each node: the previous node and either the edge of the graph or the level of the clique used
+     */
+    std::vector<int> pred_node;
+    std::vector<int> pred_edge;
+    std::vector<int> pred_level;
+    std::vector<int> touched;
+};
+
+} // end namespace CH
+
+#endif
@@ -0,0 +1,22 @@
+%module "mumoro::hierarchies"
+
+
+%{
+ #include "ContractionHierarchy.h"
+ #include "Overlay.h"
+ #include "HubLabels.h"
+%}
+
+// Queries are run through the functions of ItinerariesRequests.h
+%ignore CH::Query;
+%ignore CH::ContractionHierarchy::unpack;
+%ignore CH::ContractionHierarchy::acquire_query;
+%ignore CH::OverlayQuery;
+%ignore CH::Overlay::acquire_query;
+%ignore CH::Overlay::Level;
+%ignore CH::Overlay::levels;
+
+// Parse the original header file
+%include "ContractionHierarchy.h"
+%include "Overlay.h"
+%include "HubLabels.h"
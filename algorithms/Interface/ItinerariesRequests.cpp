@@ -33,16 +33,33 @@ knowledge of the CeCILL-B license and that you accept its terms.
 #include "ItinerariesRequests.h"
 #include <AspectStorePreds.h>
 #include <AspectTarget.h>
+#include <AspectArcFlags.h>
+#include <AspectTargetLandmark.h>
+#include <Workspace.h>
 
+#include <stdexcept>
 
+namespace {
+
+/**
+ * Workspaces of the searches of the requests, reused by the successive queries of every thread
+ */
+RLC::WorkspacePool workspaces;
+
+template<typename Base> using TargetPreds = RLC::AspectStorePreds<RLC::AspectTarget<Base>>;
+template<typename Base> using ArcFlagsTargetPreds = RLC::AspectStorePreds<RLC::AspectArcFlags<RLC::AspectTarget<Base>>>;
+template<typename Base> using LandmarksTargetPreds = RLC::AspectStorePreds<RLC::AspectTargetLandmark<Base, RLC::StateLandmarks>>;
+
+}
 
 Path point_to_point( const Transport::Graph * trans, const int source, const int dest, const int departure_time, const int day, RLC::DFA dfa )
 {
-    typedef RLC::AspectStorePreds<RLC::AspectTarget<RLC::DRegLC>> Algo;
+    typedef RLC::StaticDRegLC<TargetPreds> Algo;
     
     RLC::Graph g(trans, dfa);
+    boost::shared_ptr<RLC::Workspace> workspace = workspaces.acquire( &g );
     
-    Algo::ParamType p( RLC::DRegLCParams(&g, day), RLC::AspectTargetParams(dest));
+    Algo::ParamType p( RLC::DRegLCParams(&g, day, 1, workspace.get()), RLC::AspectTargetParams(dest));
     
     Algo dij( p );
     dij.add_source_node( RLC::Vertice(source, dfa.start_state), departure_time, 0 );
@@ -53,6 +70,115 @@ Path point_to_point( const Transport::Graph * trans, const int source, const int
     
     return res;
 }
+
+Path bidirectional_point_to_point( const Transport::Graph * trans, const int source, const int dest, const int departure_time, const int day, RLC::DFA dfa )
+{
+    if(dfa.accepts_public_transport())
+        return point_to_point( trans, source, dest, departure_time, day, dfa );
+    
+    RLC::Graph g(trans, dfa);
+    boost::shared_ptr<RLC::Workspace> forward_workspace = workspaces.acquire( &g );
+    boost::shared_ptr<RLC::Workspace> backward_workspace = workspaces.acquire( &g );
+    
+    RLC::BidirectionalDRegLC dij( &g, day, source, dest, departure_time, forward_workspace.get(), backward_workspace.get() );
+    dij.run();
+    
+    return dij.get_path();
+}
+
+Path arc_flags_point_to_point( const RLC::ArcFlags & flags, const int source, const int dest, const int departure_time, const int day )
+{
+    typedef RLC::StaticDRegLC<ArcFlagsTargetPreds> Algo;
+    
+    RLC::Graph g(flags.graph, flags.dfa);
+    boost::shared_ptr<RLC::Workspace> workspace = workspaces.acquire( &g );
+    
+    Algo::ParamType p( RLC::DRegLCParams(&g, day, 1, workspace.get()), RLC::AspectTargetParams(dest), RLC::AspectArcFlagsParams(&flags, dest) );
+    
+    Algo dij( p );
+    dij.add_source_node( RLC::Vertice(source, flags.dfa.start_state), departure_time, 0 );
+
+    dij.run();
+    
+    return dij.get_path_to(dest);
+}
+
+Path landmarks_point_to_point( const RLC::StateLandmarks & landmarks, const int source, const int dest, const int departure_time, const int day )
+{
+    typedef RLC::StaticDRegLC<LandmarksTargetPreds> Algo;
+    
+    RLC::Graph g(landmarks.graph, landmarks.dfa);
+    boost::shared_ptr<RLC::Workspace> workspace = workspaces.acquire( &g );
+    
+    Algo::ParamType p( RLC::DRegLCParams(&g, day, 1, workspace.get()), RLC::AspectTargetLandmarkParams<RLC::StateLandmarks>(dest, &landmarks) );
+    
+    Algo dij( p );
+    dij.add_source_node( RLC::Vertice(source, landmarks.dfa.start_state), departure_time, 0 );
+
+    dij.run();
+    
+    return dij.get_path_to(dest);
+}
+
+Path ch_point_to_point( const CH::ContractionHierarchy & hierarchy, const int source, const int dest )
+{
+    boost::shared_ptr<CH::Query> query = hierarchy.acquire_query();
+    query->run( source, dest );
+    
+    return query->get_path();
+}
+
+int car_distance( const CH::HubLabels & labels, const int source, const int dest )
+{
+    if(labels.mode != CarEdge)
+        throw std::invalid_argument( "Car distance with hub labels of another mode" );
+    return labels.distance( source, dest );
+}
+
+Path overlay_point_to_point( const CH::Overlay & overlay, const int source, const int dest )
+{
+    boost::shared_ptr<CH::OverlayQuery> query = overlay.acquire_query();
+    query->run( source, dest );
+    
+    return query->get_path();
+}
+
+std::vector<RLC::ProfileEntry> profile_point_to_point( const Transport::Graph * trans, const int source, const int dest, const int earliest, const int latest, const int day, RLC::DFA dfa )
+{
+    RLC::Graph g(trans, dfa);
+    
+    RLC::ProfileDRegLC profile( &g, day, earliest, latest, dest );
+    profile.add_source_node( RLC::Vertice(source, dfa.start_state) );
     
+    profile.run();
     
-    
\ No newline at end of file
+    return profile.profile();
+}
+
+Path csa_point_to_point( const PT::ConnectionTimetable & timetable, const int source, const int dest, const int departure_time )
+{
+    PT::ConnectionScan csa( timetable, dest );
+    csa.add_source_node( RLC::Vertice(source, 0), departure_time, 0 );
+    
+    csa.run();
+    
+    return csa.get_path_to(dest);
+}
+
+std::vector<PT::Journey> raptor_journeys( const PT::RaptorTimetable & timetable, const int source, const int dest, const int departure_time, const int max_rides )
+{
+    PT::Raptor raptor( timetable, source, dest, max_rides );
+    return raptor.run( departure_time );
+}
+
+std::vector<PT::Journey> raptor_range_journeys( const PT::RaptorTimetable & timetable, const int source, const int dest, const int earliest, const int latest, const int max_rides )
+{
+    PT::Raptor raptor( timetable, source, dest, max_rides );
+    return raptor.run_range( earliest, latest );
+}
+
+PT::Journey transfer_patterns_journey( const PT::TransferPatterns & patterns, const int source, const int dest, const int departure_time, const int day )
+{
+    PT::TransferPatternsQuery query( patterns, day );
+    return query.run( source, dest, departure_time );
+}
@@ -37,8 +37,83 @@ knowledge of the CeCILL-B license and that you accept its terms.
 
 #include "graph_wrapper.h"
 #include "reglc_graph.h"
+#include "ProfileDRegLC.h"
+#include "BidirectionalDRegLC.h"
+#include "ArcFlags.h"
+#include "StateLandmarks.h"
+#include "ConnectionScan.h"
+#include "Raptor.h"
+#include "TransferPatterns.h"
+#include "ContractionHierarchy.h"
+#include "Overlay.h"
+#include "HubLabels.h"
 
 Path point_to_point( const Transport::Graph * trans, const int source, const int dest, const int departure_time, const int day, const RLC::DFA dfa = RLC::pt_foot_dfa() );
 
+/**
+ * Same as point_to_point, searching from both the source and the destination (see RLC::BidirectionalDRegLC).
+ * DFAs accepting public transport, whose durations depend on time, are run by point_to_point instead.
+ */
+Path bidirectional_point_to_point( const Transport::Graph * trans, const int source, const int dest, const int departure_time, const int day, const RLC::DFA dfa = RLC::car_dfa() );
 
-#endif
\ No newline at end of file
+/**
+ * Same as point_to_point with the DFA of the arc flags, only following the edges flagged for the region of
+ * the destination (see RLC::AspectArcFlags)
+ */
+Path arc_flags_point_to_point( const RLC::ArcFlags & flags, const int source, const int dest, const int departure_time, const int day );
+
+/**
+ * Same as point_to_point with the DFA of the landmarks, as an A* search on their lower bounds
+ * (see RLC::StateLandmarks). Unlike the car landmarks, they hold for multimodal DFAs.
+ */
+Path landmarks_point_to_point( const RLC::StateLandmarks & landmarks, const int source, const int dest, const int departure_time, const int day );
+
+/**
+ * Shortest path on the mode of a contraction hierarchy, with the edges of its transport graph
+ */
+Path ch_point_to_point( const CH::ContractionHierarchy & hierarchy, const int source, const int dest );
+
+/**
+ * Duration of the shortest car path between two nodes, -1 if there is none.
+ * The labels must have been built from a contraction hierarchy of the car edges, throws std::invalid_argument otherwise.
+ */
+int car_distance( const CH::HubLabels & labels, const int source, const int dest );
+
+/**
+ * Shortest path on the mode of a customized overlay, with the edges of its transport graph
+ */
+Path overlay_point_to_point( const CH::Overlay & overlay, const int source, const int dest );
+
+/**
+ * Travel time profile for every departure in [earliest, latest], computed by a single profile search
+ * (see RLC::ProfileDRegLC). Entries are by increasing departure.
+ */
+std::vector<RLC::ProfileEntry> profile_point_to_point( const Transport::Graph * trans, const int source, const int dest, const int earliest, const int latest, const int day, const RLC::DFA dfa = RLC::pt_foot_dfa() );
+
+/**
+ * Earliest arrival itinerary using public transport and walking, computed by the Connection Scan Algorithm.
+ * The day is the one of the timetable. Walking is bounded by the max_walking of the footpaths of the
+ * timetable, unlike point_to_point on pt_foot_dfa (see PT::Footpaths).
+ */
+Path csa_point_to_point( const PT::ConnectionTimetable & timetable, const int source, const int dest, const int departure_time );
+
+/**
+ * Itineraries leaving at `departure_time` that are Pareto optimal regarding the arrival time and the number
+ * of vehicles used (RAPTOR). Walking is bounded as in csa_point_to_point.
+ */
+std::vector<PT::Journey> raptor_journeys( const PT::RaptorTimetable & timetable, const int source, const int dest, const int departure_time, const int max_rides = 8 );
+
+/**
+ * Itineraries leaving in [earliest, latest] that are Pareto optimal regarding the departure time, the arrival time
+ * and the number of vehicles used (rRAPTOR). Walking is bounded as in csa_point_to_point.
+ */
+std::vector<PT::Journey> raptor_range_journeys( const PT::RaptorTimetable & timetable, const int source, const int dest, const int earliest, const int latest, const int max_rides = 8 );
+
+/**
+ * Earliest arrival itinerary on `day`, evaluated on the transfer patterns of the stops near the source.
+ * Its arrival is -1 if there is none. Walking is bounded as in csa_point_to_point.
+ */
+PT::Journey transfer_patterns_journey( const PT::TransferPatterns & patterns, const int source, const int dest, const int departure_time, const int day );
+
+
+#endif
@@ -37,6 +37,7 @@ knowledge of the CeCILL-B license and that you accept its terms.
 typedef std::list<int> Edges;
 
 struct Path {
+    Path() : start_node(-1), end_node(-1) {}
   
     int start_node;
     int end_node;
@@ -3,8 +3,146 @@
 %{
 #include "ItinerariesRequests.h"
 #include "Path.h"
+
+/**
+ * Path with the node ids of the input data, a node of -1 (no path) being kept as it is
+ */
+static Path original_path( const Transport::Graph * trans, Path path )
+{
+    if(path.start_node >= 0)
+        path.start_node = trans->original_node( path.start_node );
+    if(path.end_node >= 0)
+        path.end_node = trans->original_node( path.end_node );
+    return path;
+}
 %}
 
+// Python uses the node ids of the input data (see Transport::Graph::internal_node)
+%ignore point_to_point;
+%rename(point_to_point) original_point_to_point;
+%ignore bidirectional_point_to_point;
+%rename(bidirectional_point_to_point) original_bidirectional_point_to_point;
+%ignore arc_flags_point_to_point;
+%rename(arc_flags_point_to_point) original_arc_flags_point_to_point;
+%ignore landmarks_point_to_point;
+%rename(landmarks_point_to_point) original_landmarks_point_to_point;
+%ignore ch_point_to_point;
+%rename(ch_point_to_point) original_ch_point_to_point;
+%ignore car_distance;
+%rename(car_distance) original_car_distance;
+%ignore overlay_point_to_point;
+%rename(overlay_point_to_point) original_overlay_point_to_point;
+%ignore profile_point_to_point;
+%rename(profile_point_to_point) original_profile_point_to_point;
+%ignore csa_point_to_point;
+%rename(csa_point_to_point) original_csa_point_to_point;
+%ignore raptor_journeys;
+%rename(raptor_journeys) original_raptor_journeys;
+%ignore raptor_range_journeys;
+%rename(raptor_range_journeys) original_raptor_range_journeys;
+%ignore transfer_patterns_journey;
+%rename(transfer_patterns_journey) original_transfer_patterns_journey;
+
 // Parse the original header file
 %include "ItinerariesRequests.h"
 %include "Path.h"
+
+%inline %{
+Path original_point_to_point( const Transport::Graph * trans, const int source, const int dest, const int departure_time, const int day, const RLC::DFA dfa = RLC::pt_foot_dfa() )
+{
+    Path path = point_to_point( trans, trans->internal_node(source), trans->internal_node(dest), departure_time, day, dfa );
+    return original_path( trans, path );
+}
+
+Path original_bidirectional_point_to_point( const Transport::Graph * trans, const int source, const int dest, const int departure_time, const int day, const RLC::DFA dfa = RLC::car_dfa() )
+{
+    Path path = bidirectional_point_to_point( trans, trans->internal_node(source), trans->internal_node(dest), departure_time, day, dfa );
+    return original_path( trans, path );
+}
+
+Path original_arc_flags_point_to_point( const RLC::ArcFlags & flags, const int source, const int dest, const int departure_time, const int day )
+{
+    const Transport::Graph * trans = flags.graph;
+    Path path = arc_flags_point_to_point( flags, trans->internal_node(source), trans->internal_node(dest), departure_time, day );
+    return original_path( trans, path );
+}
+
+/**
+ * Landmarks on the nodes given with the ids of the input data
+ */
+RLC::StateLandmarks * state_landmarks( const Transport::Graph * trans, const RLC::DFA dfa, const std::vector<int> & nodes )
+{
+    return new RLC::StateLandmarks( trans, dfa, internal_nodes(trans, nodes) );
+}
+
+Path original_landmarks_point_to_point( const RLC::StateLandmarks & landmarks, const int source, const int dest, const int departure_time, const int day )
+{
+    const Transport::Graph * trans = landmarks.graph;
+    Path path = landmarks_point_to_point( landmarks, trans->internal_node(source), trans->internal_node(dest), departure_time, day );
+    return original_path( trans, path );
+}
+
+Path original_ch_point_to_point( const CH::ContractionHierarchy & hierarchy, const int source, const int dest )
+{
+    const Transport::Graph * trans = hierarchy.graph;
+    Path path = ch_point_to_point( hierarchy, trans->internal_node(source), trans->internal_node(dest) );
+    return original_path( trans, path );
+}
+
+int original_car_distance( const CH::HubLabels & labels, const int source, const int dest )
+{
+    const Transport::Graph * trans = labels.graph;
+    return car_distance( labels, trans->internal_node(source), trans->internal_node(dest) );
+}
+
+Path original_overlay_point_to_point( const CH::Overlay & overlay, const int source, const int dest )
+{
+    const Transport::Graph * trans = overlay.graph;
+    Path path = overlay_point_to_point( overlay, trans->internal_node(source), trans->internal_node(dest) );
+    return original_path( trans, path );
+}
+
+std::vector<RLC::ProfileEntry> original_profile_point_to_point( const Transport::Graph * trans, const int source, const int dest, const int earliest, const int latest, const int day, const RLC::DFA dfa = RLC::pt_foot_dfa() )
+{
+    std::vector<RLC::ProfileEntry> entries = profile_point_to_point( trans, trans->internal_node(source), trans->internal_node(dest), earliest, latest, day, dfa );
+    for(unsigned int i=0 ; i<entries.size() ; ++i) {
+        entries[i].path = original_path( trans, entries[i].path );
+    }
+    return entries;
+}
+
+Path original_csa_point_to_point( const PT::ConnectionTimetable & timetable, const int source, const int dest, const int departure_time )
+{
+    const Transport::Graph * trans = timetable.footpaths.graph;
+    Path path = csa_point_to_point( timetable, trans->internal_node(source), trans->internal_node(dest), departure_time );
+    return original_path( trans, path );
+}
+
+std::vector<PT::Journey> original_journeys( const Transport::Graph * trans, std::vector<PT::Journey> journeys )
+{
+    for(unsigned int i=0 ; i<journeys.size() ; ++i) {
+        journeys[i].path = original_path( trans, journeys[i].path );
+    }
+    return journeys;
+}
+
+std::vector<PT::Journey> original_raptor_journeys( const PT::RaptorTimetable & timetable, const int source, const int dest, const int departure_time, const int max_rides = 8 )
+{
+    const Transport::Graph * trans = timetable.footpaths.graph;
+    return original_journeys( trans, raptor_journeys( timetable, trans->internal_node(source), trans->internal_node(dest), departure_time, max_rides ) );
+}
+
+std::vector<PT::Journey> original_raptor_range_journeys( const PT::RaptorTimetable & timetable, const int source, const int dest, const int earliest, const int latest, const int max_rides = 8 )
+{
+    const Transport::Graph * trans = timetable.footpaths.graph;
+    return original_journeys( trans, raptor_range_journeys( timetable, trans->internal_node(source), trans->internal_node(dest), earliest, latest, max_rides ) );
+}
+
+PT::Journey original_transfer_patterns_journey( const PT::TransferPatterns & patterns, const int source, const int dest, const int departure_time, const int day )
+{
+    const Transport::Graph * trans = patterns.footpaths.graph;
+    PT::Journey journey = transfer_patterns_journey( patterns, trans->internal_node(source), trans->internal_node(dest), departure_time, day );
+    journey.path = original_path( trans, journey.path );
+    return journey;
+}
+%}
\ No newline at end of file
@@ -76,6 +76,9 @@ public:
     // results
     Label target_label;
     
+    // out edges of the label being expanded, reused between iterations
+    std::vector<RLC::Edge> n_out_edges;
+    
     Martins( const RLC::AbstractGraph * rlc, const int target, const int day, const Area * area = NULL ) : 
     graph(rlc), 
     target(target), 
@@ -112,8 +115,8 @@ public:
             return lab;
         }
         
-        std::list<RLC::Edge> n_out_edges = graph->out_edges(lab.node);
-        BOOST_FOREACH(RLC::Edge e, n_out_edges) 
+        graph->out_edges(lab.node, n_out_edges);
+        BOOST_FOREACH(const RLC::Edge & e, n_out_edges) 
         {
             RLC::Vertice target = graph->target(e);
             
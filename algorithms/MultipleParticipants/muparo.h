@@ -321,7 +321,7 @@ public:
             RLC::Vertice vert = curr.label.node;
             
             if( dij[l]->has_pred(vert) ) {
-                vres.edges.push_back(transport->edgeIndex( dij[l]->get_pred(vert).first ));
+                vres.edges.push_back( dij[l]->get_pred(vert).first );
                 queue.push_back( CompleteNode(l, graphs[l]->source(dij[l]->get_pred(vert) )));
             }
             else if( flags[l][vert.first].pred_layers == 0 ) // no pred layers  
@@ -176,7 +176,7 @@ void init_car_sharing_with_areas(T * cs, const Transport::Graph* trans, int src_
     cs->graphs.push_back( g5 );
     cs->dij.push_back( new PassAlgo( 
         PassAlgo::ParamType(
-            RLC::DRegLCParams(g1, day, 1),
+            RLC::DRegLCParams(g1, day, 1, RLC::Workspace::Sparse),
             RLC::AspectNodePruningParams( &area_start->ns ) ) ) );
     if(!use_landmarks) {
         cs->dij.push_back( new CarAlgo( 
@@ -210,7 +210,7 @@ void init_car_sharing_with_areas(T * cs, const Transport::Graph* trans, int src_
     }
     cs->dij.push_back( new PassAlgo( 
         PassAlgo::ParamType(
-            RLC::DRegLCParams(g5, day, 1),
+            RLC::DRegLCParams(g5, day, 1, RLC::Workspace::Sparse),
             RLC::AspectNodePruningParams( &area_dest->ns ) ) ) );
     
     cs->insert( StateFreeNode(0, src_ped), time, 0);
@@ -248,7 +248,7 @@ void init_multi_car_sharing_with_areas(T * cs, const Transport::Graph* trans, in
     cs->graphs.push_back( g5 );
     cs->dij.push_back( new PassAlgo( 
         PassAlgo::ParamType(
-            RLC::DRegLCParams(g1, day, 1),
+            RLC::DRegLCParams(g1, day, 1, RLC::Workspace::Sparse),
             RLC::AspectNodePruningParams( &area_start->ns ) ) ) );
     if(!use_landmarks) {
         cs->dij.push_back( new CarAlgo( 
@@ -283,7 +283,7 @@ void init_multi_car_sharing_with_areas(T * cs, const Transport::Graph* trans, in
     /*
     cs->dij.push_back( new PassAlgo( 
         PassAlgo::ParamType(
-            RLC::DRegLCParams(g5, day, 1),
+            RLC::DRegLCParams(g5, day, 1, RLC::Workspace::Sparse),
             RLC::AspectNodePruningParams( &area_dest->ns ) ) ) );
     */
     cs->dij.push_back( new RLC::Martins(g5, dest_ped, day, area_dest) );
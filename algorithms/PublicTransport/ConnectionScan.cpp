@@ -0,0 +1,212 @@
+/** Copyright : Arthur Bit-Monnot (2013)  arthur.bit-monnot@laas.fr
+
+This software is a computer program whose purpose is to [describe
+functionalities and technical features of your software].
+
+This software is governed by the CeCILL-B license under French law and
+abiding by the rules of distribution of free software.  You can  use, 
+modify and/ or redistribute the software under the terms of the CeCILL-B
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info". 
+
+As a counterpart to the access to the source code and  rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty  and the software's author,  the holder of the
+economic rights,  and the successive licensors  have only  limited
+liability. 
+
+In this respect, the user's attention is drawn to the risks associated
+with loading,  using,  modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean  that it is complicated to manipulate,  and  that  also
+therefore means  that it is reserved for developers  and  experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or 
+data to be ensured and,  more generally, to use and operate it in the 
+same conditions as regards security. 
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL-B license and that you accept its terms. 
+*/
+
+#include <algorithm>
+#include <limits>
+#include <boost/foreach.hpp>
+
+#include "ConnectionScan.h"
+
+namespace PT {
+
+ConnectionTimetable::ConnectionTimetable( const Footpaths & footpaths, const int day ) : footpaths(footpaths), day(day)
+{
+    const Transport::Graph * graph = footpaths.graph;
+    boost::shared_ptr<const Transport::DayTimetable> lines = graph->day_timetable( day );
+    if(!lines)
+        return;
+
+    const Transport::CsrGraph & csr = graph->csr();
+    for(int e=0 ; e<csr.num_edges() ; ++e) {
+        const int index = graph->timetable_index(e);
+        if(index < 0)
+            continue;
+        Connection c;
+        c.from = footpaths.stop_index[csr.tail[e]];
+        c.to = footpaths.stop_index[csr.head[e]];
+        c.edge = e;
+        for(int l=lines->begin(index) ; l<lines->end(index) ; ++l) {
+            c.departure = lines->departure(l);
+            c.arrival = lines->arrival(l);
+            connections.push_back( c );
+        }
+    }
+    std::sort( connections.begin(), connections.end() );
+}
+
+int ConnectionTimetable::first_departure( const int time ) const
+{
+    Connection c;
+    c.departure = time;
+    c.arrival = std::numeric_limits<int>::min();
+    return std::lower_bound( connections.begin(), connections.end(), c ) - connections.begin();
+}
+
+
+const int ConnectionScan::UNREACHED;
+
+ConnectionScan::ConnectionScan( const ConnectionTimetable & timetable, const int target ) : 
+    timetable(timetable), footpaths(timetable.footpaths), walker(footpaths.acquire_walker()), target(target), scanned(false), departure(UNREACHED),
+    stop_arrival(footpaths.num_stops(), UNREACHED), pred_connection(footpaths.num_stops(), -1), 
+    pred_stop(footpaths.num_stops(), -1), pred_source(footpaths.num_stops(), -1),
+    egress(footpaths.num_stops(), -1), target_arrival(UNREACHED), target_stop(-1), target_source(-1)
+{
+}
+
+bool ConnectionScan::insert_node( const RLC::Vertice & vert, const int arrival, const int vert_cost, const int source )
+{
+    BOOST_ASSERT( !scanned );
+    sources.push_back( std::make_pair(vert.first, arrival) );
+    departure = std::min( departure, arrival );
+    return true;
+}
+
+void ConnectionScan::update_target( const int stop )
+{
+    if(egress[stop] >= 0 && stop_arrival[stop] + egress[stop] < target_arrival) {
+        target_arrival = stop_arrival[stop] + egress[stop];
+        target_stop = stop;
+    }
+}
+
+bool ConnectionScan::run()
+{
+    if(scanned)
+        return target_arrival != UNREACHED;
+    scanned = true;
+
+    // walk from the last stop to the target
+    walker->run( target, footpaths.max_walking, false );
+    for(uint i=0 ; i<walker->reached().size() ; ++i) {
+        const int stop = footpaths.stop_index[walker->reached()[i].first];
+        if(stop >= 0)
+            egress[stop] = walker->reached()[i].second;
+    }
+
+    // walk from the sources to the first stop (or to the target)
+    for(uint s=0 ; s<sources.size() ; ++s) {
+        walker->run( sources[s].first, footpaths.max_walking );
+        for(uint i=0 ; i<walker->reached().size() ; ++i) {
+            const int node = walker->reached()[i].first;
+            const int arrival = sources[s].second + walker->reached()[i].second;
+            if(node == target && arrival < target_arrival) {
+                target_arrival = arrival;
+                target_stop = -1;
+                target_source = s;
+            }
+            const int stop = footpaths.stop_index[node];
+            if(stop >= 0 && arrival < stop_arrival[stop]) {
+                stop_arrival[stop] = arrival;
+                pred_connection[stop] = -1;
+                pred_stop[stop] = -1;
+                pred_source[stop] = s;
+                update_target( stop );
+            }
+        }
+    }
+
+    const std::vector<Connection> & connections = timetable.connections;
+    for(uint i=timetable.first_departure(departure) ; i<connections.size() ; ++i) {
+        const Connection & c = connections[i];
+        if(c.departure >= target_arrival)
+            break;
+        ++count;
+        if(stop_arrival[c.from] > c.departure || c.arrival >= stop_arrival[c.to])
+            continue;
+
+        stop_arrival[c.to] = c.arrival;
+        pred_connection[c.to] = i;
+        update_target( c.to );
+
+        for(int t=footpaths.transfers_begin(c.to) ; t<footpaths.transfers_end(c.to) ; ++t) {
+            const int stop = footpaths.transfer_target[t];
+            const int arrival = c.arrival + footpaths.transfer_duration[t];
+            if(arrival < stop_arrival[stop]) {
+                stop_arrival[stop] = arrival;
+                pred_connection[stop] = -1;
+                pred_stop[stop] = c.to;
+                update_target( stop );
+            }
+        }
+    }
+    return target_arrival != UNREACHED;
+}
+
+RLC::Label ConnectionScan::treat_next()
+{
+    if(!run())
+        return RLC::Label();
+    return RLC::Label( RLC::Vertice(target, 0), target_arrival, target_arrival - departure );
+}
+
+Path ConnectionScan::get_path_to( const int node ) const
+{
+    BOOST_ASSERT( node == target );
+    Path path;
+    path.start_node = sources.empty() ? -1 : sources[0].first;
+    path.end_node = target;
+    if(target_arrival == UNREACHED)
+        return path;
+
+    if(target_stop < 0) {
+        walker->run( sources[target_source].first, footpaths.max_walking );
+        path.edges = walker->path_to( target );
+        path.start_node = sources[target_source].first;
+        return path;
+    }
+
+    walker->run( target, footpaths.max_walking, false );
+    path.edges = walker->path_to( footpaths.stops[target_stop] );
+
+    int stop = target_stop;
+    for(;;) {
+        if(pred_connection[stop] >= 0) {
+            const Connection & c = timetable.connections[pred_connection[stop]];
+            path.edges.push_front( c.edge );
+            stop = c.from;
+        } else if(pred_stop[stop] >= 0) {
+            walker->run( footpaths.stops[pred_stop[stop]], footpaths.max_transfer );
+            std::list<int> walk = walker->path_to( footpaths.stops[stop] );
+            path.edges.splice( path.edges.begin(), walk );
+            stop = pred_stop[stop];
+        } else {
+            const int source = sources[pred_source[stop]].first;
+            walker->run( source, footpaths.max_walking );
+            std::list<int> walk = walker->path_to( footpaths.stops[stop] );
+            path.edges.splice( path.edges.begin(), walk );
+            path.start_node = source;
+            return path;
+        }
+    }
+}
+
+} // end namespace PT
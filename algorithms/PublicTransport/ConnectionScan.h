@@ -0,0 +1,170 @@
+/** Copyright : Arthur Bit-Monnot (2013)  arthur.bit-monnot@laas.fr
+
+This software is a computer program whose purpose is to [describe
+functionalities and technical features of your software].
+
+This software is governed by the CeCILL-B license under French law and
+abiding by the rules of distribution of free software.  You can  use, 
+modify and/ or redistribute the software under the terms of the CeCILL-B
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info". 
+
+As a counterpart to the access to the source code and  rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty  and the software's author,  the holder of the
+economic rights,  and the successive licensors  have only  limited
+liability. 
+
+In this respect, the user's attention is drawn to the risks associated
+with loading,  using,  modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean  that it is complicated to manipulate,  and  that  also
+therefore means  that it is reserved for developers  and  experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or 
+data to be ensured and,  more generally, to use and operate it in the 
+same conditions as regards security. 
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL-B license and that you accept its terms. 
+*/
+
+#ifndef PT_CONNECTION_SCAN_H
+#define PT_CONNECTION_SCAN_H
+
+#include <vector>
+#include <boost/shared_ptr.hpp>
+
+#include "LabelSettingAlgo.h"
+#include "Footpaths.h"
+
+namespace PT {
+
+/**
+ * A vehicle leaving stop `from` at `departure` and reaching stop `to` at `arrival` through
+ * the edge `edge` of the transport graph
+ */
+struct Connection
+{
+    int departure;
+    int arrival;
+    int from;
+    int to;
+    int edge;
+
+    bool operator<( const Connection & other ) const {
+        return departure < other.departure || (departure == other.departure && arrival < other.arrival);
+    }
+};
+
+/**
+ * Every connection running on a day, sorted by departure.
+ *
+ * Lines of the previous and next days are included (see Transport::DayTimetable). Edges whose duration is
+ * a frequency or a constant are not part of the timetable and are ignored, except transfer edges
+ * which are footpaths.
+ */
+class ConnectionTimetable
+{
+public:
+    ConnectionTimetable( const Footpaths & footpaths, const int day );
+
+    const Footpaths & footpaths;
+    const int day;
+
+    std::vector<Connection> connections;
+
+    /**
+     * Index of the first connection leaving at or after `time`
+     */
+    int first_departure( const int time ) const;
+};
+
+/**
+ * Earliest arrival query answered by the Connection Scan Algorithm of Dibbelt & al.
+ *
+ * Connections are scanned once, in order of departure, from the departure time of the query until
+ * the best arrival at the target is known. A connection is reachable if its departure stop has been
+ * reached before it leaves, in which case its arrival stop and the stops within walking distance
+ * are updated.
+ *
+ * Sources are inserted with add_source_node (the DFA state is ignored), the walk from them to the
+ * first stop and from the last stop to the target are bounded by Footpaths::max_walking.
+ */
+class ConnectionScan : public RLC::LabelSettingAlgo
+{
+public:
+    ConnectionScan( const ConnectionTimetable & timetable, const int target );
+    virtual ~ConnectionScan() {}
+
+    virtual bool finished() const override { return scanned; }
+
+    /**
+     * Scans the connections, returns true if the target was reached
+     */
+    virtual bool run() override;
+
+    /**
+     * Runs the search and returns the label of the target (invalid if it was not reached)
+     */
+    virtual RLC::Label treat_next() override;
+
+    virtual bool insert_node( const RLC::Vertice & vert, const int arrival, const int vert_cost, const int source ) override;
+
+    virtual int best_cost_in_heap() override { return target_arrival == UNREACHED ? UNREACHED : target_arrival - departure; }
+
+    /**
+     * Earliest arrival at the target, -1 if it was not reached
+     */
+    inline int arrival() const { return target_arrival == UNREACHED ? -1 : target_arrival; }
+
+    virtual Path get_path_to( const int node ) const override;
+
+private:
+    static const int UNREACHED = 0x7fffffff;
+
+    void update_target( const int stop );
+
+    const ConnectionTimetable & timetable;
+    const Footpaths & footpaths;
+    /**
+     * Walks to and from the stops, the walker being taken from the pool of the footpaths
+     */
+    boost::shared_ptr<Walker> walker;
+    const int target;
+    bool scanned;
+
+    /**
+     * Source of the query and its departure time (the earliest one if several sources were inserted)
+     */
+    std::vector< std::pair<int, int> > sources;
+    int departure;
+
+    std::vector<int> stop_arrival;
+
+    /**
+     * How each stop was reached: through the connection `pred_connection[s]` if it is not -1, else
+     * by walking from `pred_stop[s]` if it is not -1, else by walking from `pred_source[s]`
+     */
+    std::vector<int> pred_connection;
+    std::vector<int> pred_stop;
+    std::vector<int> pred_source;
+
+    /**
+     * Walking duration from each stop to the target, -1 if it is too far
+     */
+    std::vector<int> egress;
+
+    int target_arrival;
+
+    /**
+     * Stop from which the target was reached, -1 if it was reached by walking from `target_source`
+     */
+    int target_stop;
+    int target_source;
+};
+
+} // end namespace PT
+
+#endif
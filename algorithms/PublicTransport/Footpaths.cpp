@@ -0,0 +1,150 @@
+/** Copyright : Arthur Bit-Monnot (2013)  arthur.bit-monnot@laas.fr
+
+This software is a computer program whose purpose is to [describe
+functionalities and technical features of your software].
+
+This software is governed by the CeCILL-B license under French law and
+abiding by the rules of distribution of free software.  You can  use, 
+modify and/ or redistribute the software under the terms of the CeCILL-B
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info". 
+
+As a counterpart to the access to the source code and  rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty  and the software's author,  the holder of the
+economic rights,  and the successive licensors  have only  limited
+liability. 
+
+In this respect, the user's attention is drawn to the risks associated
+with loading,  using,  modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean  that it is complicated to manipulate,  and  that  also
+therefore means  that it is reserved for developers  and  experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or 
+data to be ensured and,  more generally, to use and operate it in the 
+same conditions as regards security. 
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL-B license and that you accept its terms. 
+*/
+
+#include <boost/foreach.hpp>
+
+#include "Footpaths.h"
+
+namespace PT {
+
+const int Walker::UNREACHED;
+
+Walker::Walker( const Transport::Graph * graph ) : graph(graph), forward(true), source(-1), 
+    dist(graph->num_vertices(), UNREACHED), pred(graph->num_vertices(), -1)
+{
+}
+
+void Walker::run( const int source, const int max_duration, const bool forward )
+{
+    BOOST_FOREACH( const int n, touched ) {
+        dist[n] = UNREACHED;
+        pred[n] = -1;
+    }
+    touched.clear();
+    settled.clear();
+    this->forward = forward;
+    this->source = source;
+
+    const Transport::CsrGraph & csr = graph->csr();
+    dist[source] = 0;
+    touched.push_back( source );
+    queue.push( QueueItem(0, source) );
+
+    while( !queue.empty() ) {
+        const QueueItem curr = queue.top();
+        queue.pop();
+        const int node = curr.second;
+        if(curr.first > dist[node])
+            continue;
+        settled.push_back( std::make_pair(node, curr.first) );
+
+        for(int mode=0 ; mode<Transport::CsrGraph::num_modes ; ++mode) {
+            if(!is_footpath_mode(mode))
+                continue;
+            const int begin = forward ? csr.out_begin(node, mode) : csr.in_begin(node, mode);
+            const int end = forward ? csr.out_end(node, mode) : csr.in_end(node, mode);
+            for(int i=begin ; i<end ; ++i) {
+                const int edge = forward ? i : csr.in_edge_id[i];
+                const int next = forward ? csr.head[edge] : csr.tail[edge];
+                const int next_dist = curr.first + graph->min_duration(edge).second;
+                if(next_dist <= max_duration && next_dist < dist[next]) {
+                    if(dist[next] == UNREACHED)
+                        touched.push_back( next );
+                    dist[next] = next_dist;
+                    pred[next] = edge;
+                    queue.push( QueueItem(next_dist, next) );
+                }
+            }
+        }
+    }
+}
+
+std::list<int> Walker::path_to( const int node ) const
+{
+    BOOST_ASSERT( dist[node] != UNREACHED );
+    std::list<int> edges;
+    const Transport::CsrGraph & csr = graph->csr();
+    for(int curr = node ; curr != source ; ) {
+        const int edge = pred[curr];
+        if(forward) {
+            edges.push_front( edge );
+            curr = csr.tail[edge];
+        } else {
+            edges.push_back( edge );
+            curr = csr.head[edge];
+        }
+    }
+    return edges;
+}
+
+
+Footpaths::Footpaths( const Transport::Graph * graph, const int max_walking ) : Footpaths(graph, max_walking, max_walking)
+{
+    Walker walker( graph );
+    first_transfer.reserve( stops.size() + 1 );
+    for(uint s=0 ; s<stops.size() ; ++s) {
+        first_transfer.push_back( transfer_target.size() );
+        walker.run( stops[s], max_walking );
+        for(uint i=0 ; i<walker.reached().size() ; ++i) {
+            const int target = stop_index[walker.reached()[i].first];
+            if(target >= 0 && target != (int) s) {
+                transfer_target.push_back( target );
+                transfer_duration.push_back( walker.reached()[i].second );
+            }
+        }
+    }
+    first_transfer.push_back( transfer_target.size() );
+}
+
+Footpaths::Footpaths( const Transport::Graph * graph, const int max_walking, const int max_transfer ) : graph(graph),
+    max_walking(max_walking), max_transfer(max_transfer), stop_index(graph->num_vertices(), -1)
+{
+    const Transport::CsrGraph & csr = graph->csr();
+    for(int e=0 ; e<csr.num_edges() ; ++e) {
+        if(graph->timetable_index(e) < 0)
+            continue;
+        const int ends[2] = { csr.tail[e], csr.head[e] };
+        for(int i=0 ; i<2 ; ++i) {
+            if(stop_index[ends[i]] < 0) {
+                stop_index[ends[i]] = stops.size();
+                stops.push_back( ends[i] );
+            }
+        }
+    }
+}
+
+boost::shared_ptr<Walker> Footpaths::acquire_walker() const
+{
+    return walkers.acquire( [this]() { return new Walker( graph ); } );
+}
+
+} // end namespace PT
@@ -0,0 +1,173 @@
+/** Copyright : Arthur Bit-Monnot (2013)  arthur.bit-monnot@laas.fr
+
+This software is a computer program whose purpose is to [describe
+functionalities and technical features of your software].
+
+This software is governed by the CeCILL-B license under French law and
+abiding by the rules of distribution of free software.  You can  use, 
+modify and/ or redistribute the software under the terms of the CeCILL-B
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info". 
+
+As a counterpart to the access to the source code and  rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty  and the software's author,  the holder of the
+economic rights,  and the successive licensors  have only  limited
+liability. 
+
+In this respect, the user's attention is drawn to the risks associated
+with loading,  using,  modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean  that it is complicated to manipulate,  and  that  also
+therefore means  that it is reserved for developers  and  experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or 
+data to be ensured and,  more generally, to use and operate it in the 
+same conditions as regards security. 
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL-B license and that you accept its terms. 
+*/
+
+#ifndef PT_FOOTPATHS_H
+#define PT_FOOTPATHS_H
+
+#include <vector>
+#include <list>
+#include <queue>
+
+#include <boost/shared_ptr.hpp>
+
+#include "graph_wrapper.h"
+#include "utils.h"
+
+/**
+ * Engines working directly on the timetables of the public transport network (instead of the
+ * product of the transport graph with a DFA)
+ */
+namespace PT {
+
+/**
+ * True if the edge can be used to walk between stops: foot edges of the street network and transfer
+ * edges of the public transport layers
+ */
+inline bool is_footpath_mode( const int mode ) { return mode == FootEdge || mode == TransferEdge; }
+
+/**
+ * Dijkstra over the footpath edges of the transport graph, bounded by a maximal walking duration.
+ *
+ * Buffers are reused from one run to the next, only the nodes reached by the previous run being reset.
+ */
+class Walker
+{
+public:
+    Walker( const Transport::Graph * graph );
+
+    /**
+     * Computes the walking durations from `source` (to `source` if not `forward`) to every node
+     * reachable within `max_duration`
+     */
+    void run( const int source, const int max_duration, const bool forward = true );
+
+    /**
+     * Nodes reached by the last run with their walking duration, by increasing duration
+     */
+    inline const std::vector< std::pair<int, int> > & reached() const { return settled; }
+
+    /**
+     * Walking duration to `node` in the last run, -1 if it was not reached
+     */
+    inline int duration( const int node ) const { return dist[node] == UNREACHED ? -1 : dist[node]; }
+
+    /**
+     * Edges walked from the source to `node` (from `node` to the source if the last run was backward)
+     */
+    std::list<int> path_to( const int node ) const;
+
+private:
+    static const int UNREACHED = 0x7fffffff;
+
+    const Transport::Graph * graph;
+    bool forward;
+    int source;
+    std::vector<int> dist;
+    std::vector<int> pred;
+    std::vector< std::pair<int, int> > settled;
+    std::vector<int> touched;
+
+    typedef std::pair<int, int> QueueItem;
+    std::priority_queue< QueueItem, std::vector<QueueItem>, std::greater<QueueItem> > queue;
+};
+
+/**
+ * Stops of the public transport network and the walking transfers between them.
+ *
+ * A stop is a node of the transport graph that is the source or target of a timetabled edge. With the
+ * GTFS import, each stop of each route is a distinct node and the transfer edges between them are part
+ * of the footpaths.
+ *
+ * Transfers of stop `s` are in [first_transfer[s], first_transfer[s+1]) of transfer_target and
+ * transfer_duration, transfer_target being the index of the target stop.
+ *
+ * Transfers are the stops reached by a walk of at most max_walking from each stop, they are not closed
+ * transitively. The walks to the first stop and from the last one are bounded the same way. With a finite
+ * bound, the engines built on the footpaths may thus miss itineraries, or find later ones, compared to
+ * DRegLC on pt_foot_dfa that walks without limit. Use a bound longer than any walk of the network (or
+ * TransferShortcuts) to get the same results.
+ */
+class Footpaths
+{
+public:
+    Footpaths( const Transport::Graph * graph, const int max_walking = 15*60 );
+    virtual ~Footpaths() {}
+
+    const Transport::Graph * graph;
+
+    /**
+     * Maximal walking duration of a transfer, and of the walk to the first stop and from the last one
+     */
+    const int max_walking;
+
+    /**
+     * Maximal duration of a transfer, max_walking unless the transfers were computed otherwise
+     */
+    int max_transfer;
+
+    /**
+     * Node of each stop
+     */
+    std::vector<int> stops;
+
+    /**
+     * Stop of each node of the graph, -1 if the node is not a stop
+     */
+    std::vector<int> stop_index;
+
+    std::vector<int> first_transfer;
+    std::vector<int> transfer_target;
+    std::vector<int> transfer_duration;
+
+    inline int num_stops() const { return stops.size(); }
+    inline int transfers_begin( const int stop ) const { return first_transfer[stop]; }
+    inline int transfers_end( const int stop ) const { return first_transfer[stop+1]; }
+
+    /**
+     * A walker on the graph that no other thread is running, reused from one search to the next.
+     * It must be released before the footpaths are destroyed.
+     */
+    boost::shared_ptr<Walker> acquire_walker() const;
+
+protected:
+    /**
+     * Only finds the stops, transfers are left to the derived class
+     */
+    Footpaths( const Transport::Graph * graph, const int max_walking, const int max_transfer );
+
+private:
+    mutable ObjectPool<Walker> walkers;
+};
+
+} // end namespace PT
+
+#endif
@@ -0,0 +1,289 @@
+/** Copyright : Arthur Bit-Monnot (2013)  arthur.bit-monnot@laas.fr
+
+This software is a computer program whose purpose is to [describe
+functionalities and technical features of your software].
+
+This software is governed by the CeCILL-B license under French law and
+abiding by the rules of distribution of free software.  You can  use, 
+modify and/ or redistribute the software under the terms of the CeCILL-B
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info". 
+
+As a counterpart to the access to the source code and  rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty  and the software's author,  the holder of the
+economic rights,  and the successive licensors  have only  limited
+liability. 
+
+In this respect, the user's attention is drawn to the risks associated
+with loading,  using,  modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean  that it is complicated to manipulate,  and  that  also
+therefore means  that it is reserved for developers  and  experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or 
+data to be ensured and,  more generally, to use and operate it in the 
+same conditions as regards security. 
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL-B license and that you accept its terms. 
+*/
+
+#include <algorithm>
+#include <functional>
+#include <boost/foreach.hpp>
+
+#include "Raptor.h"
+
+namespace PT {
+
+RaptorTimetable::RaptorTimetable( const Footpaths & footpaths, const int day ) : footpaths(footpaths), day(day), 
+    lines(footpaths.graph->day_timetable(day))
+{
+    const Transport::Graph * graph = footpaths.graph;
+    const Transport::CsrGraph & csr = graph->csr();
+
+    // timetabled edges leaving each stop: rides leaving stop `s` are in [first_ride[s], first_ride[s+1])
+    std::vector<int> first_ride;
+    std::vector<int> ride_edge;
+    std::vector<int> ride_index;
+    std::vector<int> ride_target;
+    first_ride.reserve( footpaths.num_stops() + 1 );
+    for(int s=0 ; s<footpaths.num_stops() ; ++s) {
+        first_ride.push_back( ride_edge.size() );
+        const int node = footpaths.stops[s];
+        for(int e=csr.out_begin(node) ; e<csr.out_end(node) ; ++e) {
+            const int index = graph->timetable_index(e);
+            if(index < 0)
+                continue;
+            ride_edge.push_back( e );
+            ride_index.push_back( index );
+            ride_target.push_back( footpaths.stop_index[csr.head[e]] );
+        }
+    }
+    first_ride.push_back( ride_edge.size() );
+
+    // each ride goes on with the first ride leaving its target that no other ride goes on with,
+    // except the one going back to its source
+    std::vector<int> next( ride_edge.size(), -1 );
+    std::vector<int> previous( ride_edge.size(), -1 );
+    for(uint r=0 ; r<ride_edge.size() ; ++r) {
+        const int target = ride_target[r];
+        for(int n=first_ride[target] ; n<first_ride[target+1] ; ++n) {
+            if(previous[n] < 0 && ride_target[n] != footpaths.stop_index[csr.tail[ride_edge[r]]]) {
+                next[r] = n;
+                previous[n] = r;
+                break;
+            }
+        }
+    }
+
+    // routes start with the rides nobody goes on with, the remaining ones are loops cut anywhere
+    std::vector<bool> in_route( ride_edge.size(), false );
+    for(int pass=0 ; pass<2 ; ++pass) {
+        for(uint first=0 ; first<ride_edge.size() ; ++first) {
+            if(in_route[first] || (pass == 0 && previous[first] >= 0))
+                continue;
+            first_route.push_back( route_stop.size() );
+            for(int r=first ; r >= 0 && !in_route[r] ; r=next[r]) {
+                in_route[r] = true;
+                route_stop.push_back( footpaths.stop_index[csr.tail[ride_edge[r]]] );
+                route_edge.push_back( ride_edge[r] );
+                first_line.push_back( departures.size() );
+                for(int l=lines->begin(ride_index[r]) ; l<lines->end(ride_index[r]) ; ++l) {
+                    departures.push_back( lines->departure(l) );
+                    arrivals.push_back( lines->arrival(l) );
+                }
+                if(next[r] < 0 || in_route[next[r]]) {
+                    route_stop.push_back( ride_target[r] );
+                    route_edge.push_back( -1 );
+                    first_line.push_back( departures.size() );
+                }
+            }
+        }
+    }
+    first_route.push_back( route_stop.size() );
+    first_line.push_back( departures.size() );
+
+    position_route.resize( route_stop.size() );
+    for(int r=0 ; r<num_routes() ; ++r) {
+        std::fill( position_route.begin() + route_begin(r), position_route.begin() + route_end(r), r );
+    }
+
+    first_position.assign( footpaths.num_stops() + 1, 0 );
+    BOOST_FOREACH( const int s, route_stop ) {
+        first_position[s + 1]++;
+    }
+    for(int s=0 ; s<footpaths.num_stops() ; ++s) {
+        first_position[s+1] += first_position[s];
+    }
+    std::vector<int> slot( first_position.begin(), first_position.end() - 1 );
+    stop_position.resize( route_stop.size() );
+    for(uint p=0 ; p<route_stop.size() ; ++p) {
+        stop_position[ slot[route_stop[p]]++ ] = p;
+    }
+}
+
+
+void RaptorTimetable::departures_from( const int stop, std::vector<int> & times ) const
+{
+    for(int i=positions_begin(stop) ; i<positions_end(stop) ; ++i) {
+        const int p = stop_position[i];
+        times.insert( times.end(), departures.begin() + first_line[p], departures.begin() + first_line[p+1] );
+    }
+}
+
+
+Raptor::Raptor( const RaptorTimetable & timetable, const int source, const int target, const int max_rides ) :
+    RoundSearch<Raptor>(timetable, max_rides), walker(footpaths.acquire_walker()), source(source), target(target),
+    access(footpaths.num_stops(), -1), egress(footpaths.num_stops(), -1), direct_walk(-1),
+    target_arrival(max_rides + 1, UNREACHED), target_stop(max_rides + 1, -1), target_round(max_rides + 1, 0)
+{
+    walker->run( source, footpaths.max_walking );
+    direct_walk = walker->duration( target );
+    for(uint i=0 ; i<walker->reached().size() ; ++i) {
+        const int stop = footpaths.stop_index[walker->reached()[i].first];
+        if(stop >= 0)
+            access[stop] = walker->reached()[i].second;
+    }
+
+    walker->run( target, footpaths.max_walking, false );
+    for(uint i=0 ; i<walker->reached().size() ; ++i) {
+        const int stop = footpaths.stop_index[walker->reached()[i].first];
+        if(stop >= 0)
+            egress[stop] = walker->reached()[i].second;
+    }
+}
+
+std::vector<Journey> Raptor::run( const int departure_time )
+{
+    std::vector<Journey> journeys;
+    if(timetable.lines)
+        search( departure_time, journeys );
+    return journeys;
+}
+
+std::vector<Journey> Raptor::run_range( const int earliest, const int latest )
+{
+    std::vector<Journey> journeys;
+    if(!timetable.lines)
+        return journeys;
+
+    // departure times for which a line can be caught just in time at a stop reached by walking
+    std::vector<int> departures( 1, latest );
+    std::vector<int> lines;
+    for(int s=0 ; s<footpaths.num_stops() ; ++s) {
+        if(access[s] < 0)
+            continue;
+        lines.clear();
+        timetable.departures_from( s, lines );
+        BOOST_FOREACH( const int line, lines ) {
+            const int departure = line - access[s];
+            if(departure >= earliest && departure <= latest)
+                departures.push_back( departure );
+        }
+    }
+    std::sort( departures.begin(), departures.end(), std::greater<int>() );
+    departures.erase( std::unique( departures.begin(), departures.end() ), departures.end() );
+
+    BOOST_FOREACH( const int departure, departures ) {
+        search( departure, journeys );
+    }
+    return journeys;
+}
+
+void Raptor::label_improved( const int round, const int stop )
+{
+    const int arrival = labels[round][stop].arrival;
+    if(egress[stop] >= 0 && arrival + egress[stop] < target_arrival[round]) {
+        target_arrival[round] = arrival + egress[stop];
+        target_stop[round] = stop;
+        target_round[round] = round;
+    }
+}
+
+void Raptor::search( const int departure, std::vector<Journey> & journeys )
+{
+    const std::vector<int> previous_target( target_arrival );
+
+    // round 0: walking from the source
+    marked.clear();
+    if(direct_walk >= 0 && departure + direct_walk < target_arrival[0]) {
+        target_arrival[0] = departure + direct_walk;
+        target_stop[0] = -1;
+    }
+    for(int s=0 ; s<footpaths.num_stops() ; ++s) {
+        if(access[s] >= 0 && improve( 0, s, departure + access[s], SourcePred, -1 ))
+            marked.push_back( s );
+    }
+
+    for(int k=1 ; k<=max_rides && !marked.empty() ; ++k) {
+        // an itinerary with fewer rides is also valid in this round
+        if(target_arrival[k-1] < target_arrival[k]) {
+            target_arrival[k] = target_arrival[k-1];
+            target_stop[k] = target_stop[k-1];
+            target_round[k] = target_round[k-1];
+        }
+        round( k );
+    }
+
+    // itineraries found by this search, which are not dominated by one with fewer rides
+    for(int k=0 ; k<=max_rides ; ++k) {
+        if(target_arrival[k] == UNREACHED || target_arrival[k] >= previous_target[k])
+            continue;
+        if(k > 0 && target_arrival[k] >= target_arrival[k-1])
+            continue;
+        Journey journey;
+        journey.departure = departure;
+        journey.arrival = target_arrival[k];
+        journey.rides = k;
+        journey.path = path( target_round[k], target_stop[k] );
+        journeys.push_back( journey );
+    }
+}
+
+Path Raptor::path( int round, int stop ) const
+{
+    Path path;
+    path.start_node = source;
+    path.end_node = target;
+
+    if(stop < 0) {
+        walker->run( source, footpaths.max_walking );
+        path.edges = walker->path_to( target );
+        return path;
+    }
+
+    walker->run( target, footpaths.max_walking, false );
+    path.edges = walker->path_to( footpaths.stops[stop] );
+
+    bool in_vehicle = false;
+    for(;;) {
+        const StopLabel & label = in_vehicle ? rides[round][stop] : labels[round][stop];
+        if(label.kind == CopyPred) {
+            --round;
+        } else if(label.kind == WalkPred) {
+            walker->run( footpaths.stops[label.pred], footpaths.max_transfer );
+            std::list<int> walk = walker->path_to( footpaths.stops[stop] );
+            path.edges.splice( path.edges.begin(), walk );
+            stop = label.pred;
+            in_vehicle = true;
+        } else if(label.kind == RidePred) {
+            for(int p=label.last-1 ; p>=label.pred ; --p) {
+                path.edges.push_front( timetable.route_edge[p] );
+            }
+            stop = timetable.route_stop[label.pred];
+            in_vehicle = false;
+            --round;
+        } else {
+            BOOST_ASSERT( label.kind == SourcePred );
+            walker->run( source, footpaths.max_walking );
+            std::list<int> walk = walker->path_to( footpaths.stops[stop] );
+            path.edges.splice( path.edges.begin(), walk );
+            return path;
+        }
+    }
+}
+
+} // end namespace PT
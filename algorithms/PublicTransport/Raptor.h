@@ -0,0 +1,424 @@
+/** Copyright : Arthur Bit-Monnot (2013)  arthur.bit-monnot@laas.fr
+
+This software is a computer program whose purpose is to [describe
+functionalities and technical features of your software].
+
+This software is governed by the CeCILL-B license under French law and
+abiding by the rules of distribution of free software.  You can  use, 
+modify and/ or redistribute the software under the terms of the CeCILL-B
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info". 
+
+As a counterpart to the access to the source code and  rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty  and the software's author,  the holder of the
+economic rights,  and the successive licensors  have only  limited
+liability. 
+
+In this respect, the user's attention is drawn to the risks associated
+with loading,  using,  modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean  that it is complicated to manipulate,  and  that  also
+therefore means  that it is reserved for developers  and  experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or 
+data to be ensured and,  more generally, to use and operate it in the 
+same conditions as regards security. 
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL-B license and that you accept its terms. 
+*/
+
+#ifndef PT_RAPTOR_H
+#define PT_RAPTOR_H
+
+#include <vector>
+#include <algorithm>
+#include <functional>
+#include <boost/shared_ptr.hpp>
+#include <boost/foreach.hpp>
+
+#include "Footpaths.h"
+#include "../Interface/Path.h"
+
+namespace PT {
+
+/**
+ * Routes of the public transport network with their timetables on a given day, as scanned by Raptor.
+ *
+ * A route is a sequence of stops linked by timetabled edges. The GTFS import creates a node per stop and route,
+ * linked to the next stop of the route by a timetabled edge: chaining these edges, without going back to the
+ * previous stop, gives the routes. Every timetabled edge belongs to exactly one route.
+ *
+ * Positions of route `r` are in [route_begin(r), route_end(r)) of route_stop (the stop) and route_edge (the edge
+ * to the next position, -1 for the last one). The lines of that edge on the day are in
+ * [first_line[p], first_line[p+1]) of the departures and arrivals columns, sorted by departure. Scanning a route
+ * hence reads contiguous arrays. Positions of stop `s` are in [first_position[s], first_position[s+1]) of
+ * stop_position.
+ */
+class RaptorTimetable
+{
+public:
+    RaptorTimetable( const Footpaths & footpaths, const int day );
+
+    const Footpaths & footpaths;
+    const int day;
+
+    /**
+     * Lines of the day, including the ones of the adjacent days (see Transport::DayTimetable)
+     */
+    boost::shared_ptr<const Transport::DayTimetable> lines;
+
+    std::vector<int> first_route;
+    std::vector<int> route_stop;
+    std::vector<int> route_edge;
+
+    /**
+     * Route of each position
+     */
+    std::vector<int> position_route;
+
+    std::vector<int> first_line;
+    std::vector<int> departures;
+    std::vector<int> arrivals;
+
+    std::vector<int> first_position;
+    std::vector<int> stop_position;
+
+    inline int num_routes() const { return first_route.size() - 1; }
+    inline int route_begin( const int route ) const { return first_route[route]; }
+    inline int route_end( const int route ) const { return first_route[route+1]; }
+    inline int positions_begin( const int stop ) const { return first_position[stop]; }
+    inline int positions_end( const int stop ) const { return first_position[stop+1]; }
+
+    /**
+     * Arrival at the next position of the route when leaving position `position` at `time`, -1 if no line leaves after it
+     */
+    inline int forward( const int position, const int time ) const {
+        const std::vector<int>::const_iterator end = departures.begin() + first_line[position+1];
+        const std::vector<int>::const_iterator it = std::lower_bound( departures.begin() + first_line[position], end, time );
+        return it == end ? -1 : arrivals[it - departures.begin()];
+    }
+
+    /**
+     * Appends to `times` the departures of the lines leaving `stop`
+     */
+    void departures_from( const int stop, std::vector<int> & times ) const;
+};
+
+/**
+ * A Pareto optimal itinerary: no other one leaves later, arrives earlier and uses fewer vehicles.
+ */
+struct Journey
+{
+    int departure;
+    int arrival;
+
+    /**
+     * Number of vehicles used (0 for a walk), the number of transfers being rides - 1
+     */
+    int rides;
+
+    Path path;
+};
+
+/**
+ * Rounds of RAPTOR over the routes of a RaptorTimetable, shared by the searches following them (Raptor,
+ * transfer patterns and transfer shortcuts).
+ *
+ * Round k computes the earliest arrival at every stop using at most k vehicles: every route serving a stop
+ * improved in round k-1 is scanned once, from the first of these stops, boarding wherever the arrival of round
+ * k-1 is earlier than the current vehicle. The walking transfers of the stops reached by a vehicle are relaxed
+ * afterwards. No priority queue is involved. Graphs carry no trip identifiers, so staying on a route takes its
+ * earliest departure at each stop.
+ *
+ * `Derived` is the search itself (curiously recurring template), whose hooks are resolved at compile time:
+ * - pruned(round, arrival): true if an arrival can not be useful, for instance since the target is already
+ *   reached earlier;
+ * - label_improved(round, stop) and ride_improved(round, stop): called once labels[round][stop] (resp.
+ *   rides[round][stop]) has been improved.
+ *
+ * Unless `prune_rides` is false, an arrival in the vehicle of the k-th ride is dropped if the stop was
+ * reached as early with fewer rides.
+ */
+template<typename Derived>
+class RoundSearch
+{
+public:
+    /**
+     * Number of timetable lookups made while scanning routes
+     */
+    int count;
+
+protected:
+    static const int UNREACHED = 0x7fffffff;
+
+    /**
+     * SourcePred labels are the ones of round 0, set by the search
+     */
+    typedef enum { NoPred, SourcePred, CopyPred, WalkPred, RidePred } PredKind;
+
+    struct StopLabel {
+        StopLabel() : arrival(UNREACHED), kind(NoPred), pred(-1), last(-1) {}
+        int arrival;
+        PredKind kind;
+
+        /**
+         * Stop walked from for WalkPred, route position boarded at for RidePred
+         */
+        int pred;
+
+        /**
+         * Transfer walked for WalkPred, route position alighted at for RidePred
+         */
+        int last;
+    };
+
+    RoundSearch( const RaptorTimetable & timetable, const int max_rides, const bool prune_rides = true ) :
+        count(0), timetable(timetable), footpaths(timetable.footpaths), max_rides(max_rides), prune_rides(prune_rides),
+        labels(max_rides + 1, std::vector<StopLabel>(footpaths.num_stops())),
+        rides(max_rides + 1, std::vector<StopLabel>(footpaths.num_stops())),
+        is_marked(footpaths.num_stops(), false), scan_from(timetable.num_routes(), UNREACHED) {}
+
+    /**
+     * Forgets every label
+     */
+    void clear() {
+        for(int k=0 ; k<=max_rides ; ++k) {
+            labels[k].assign( footpaths.num_stops(), StopLabel() );
+            rides[k].assign( footpaths.num_stops(), StopLabel() );
+        }
+    }
+
+    /**
+     * Distinct departure times of the lines leaving the stop during the day, the latest first
+     */
+    void day_departures( const int stop, std::vector<int> & departures ) const {
+        std::vector<int> lines;
+        timetable.departures_from( stop, lines );
+        departures.clear();
+        BOOST_FOREACH( const int departure, lines ) {
+            if(departure >= 0 && departure < 24*3600)
+                departures.push_back( departure );
+        }
+        std::sort( departures.begin(), departures.end(), std::greater<int>() );
+        departures.erase( std::unique( departures.begin(), departures.end() ), departures.end() );
+    }
+
+    /**
+     * Round k from the stops of `marked`, which is then filled with the stops it improved
+     */
+    void round( const int k ) {
+        copy_previous( k );
+        scan_routes( k );
+        relax_transfers( k );
+    }
+
+    /**
+     * The labels of round k-1 of the stops of `marked` are also valid in round k
+     */
+    void copy_previous( const int k ) {
+        BOOST_FOREACH( const int s, marked ) {
+            if(labels[k-1][s].arrival < labels[k][s].arrival) {
+                labels[k][s].arrival = labels[k-1][s].arrival;
+                labels[k][s].kind = CopyPred;
+            }
+        }
+    }
+
+    /**
+     * Scans once every route serving a stop of `marked`, filling `improved` with the stops reached by a vehicle
+     */
+    void scan_routes( const int k ) {
+        queued_routes.clear();
+        BOOST_FOREACH( const int s, marked ) {
+            for(int i=timetable.positions_begin(s) ; i<timetable.positions_end(s) ; ++i) {
+                const int p = timetable.stop_position[i];
+                const int route = timetable.position_route[p];
+                if(scan_from[route] == UNREACHED)
+                    queued_routes.push_back( route );
+                scan_from[route] = std::min( scan_from[route], p );
+            }
+        }
+        improved.clear();
+        BOOST_FOREACH( const int route, queued_routes ) {
+            scan_route( k, route );
+        }
+    }
+
+    /**
+     * Walking transfers from the stops of `improved`, filling `marked` with the stops improved in round k
+     */
+    void relax_transfers( const int k ) {
+        marked.clear();
+        BOOST_FOREACH( const int s, improved ) {
+            if(is_marked[s])
+                continue;
+            is_marked[s] = true;
+            marked.push_back( s );
+            for(int t=footpaths.transfers_begin(s) ; t<footpaths.transfers_end(s) ; ++t) {
+                const int stop = footpaths.transfer_target[t];
+                if(improve( k, stop, rides[k][s].arrival + footpaths.transfer_duration[t], WalkPred, s, t ) && !is_marked[stop]) {
+                    is_marked[stop] = true;
+                    marked.push_back( stop );
+                }
+            }
+        }
+        BOOST_FOREACH( const int s, marked ) {
+            is_marked[s] = false;
+        }
+    }
+
+    bool improve( const int round, const int stop, const int arrival, const PredKind kind, const int pred, const int last = -1 ) {
+        StopLabel & label = labels[round][stop];
+        if(arrival >= label.arrival || derived().pruned( round, arrival ))
+            return false;
+        // dominated by an itinerary with fewer rides
+        if(round > 0 && arrival >= labels[round-1][stop].arrival)
+            return false;
+
+        label.arrival = arrival;
+        label.kind = kind;
+        label.pred = pred;
+        label.last = last;
+        derived().label_improved( round, stop );
+        return true;
+    }
+
+    bool ride( const int round, const int stop, const int arrival, const int board, const int alight ) {
+        StopLabel & label = rides[round][stop];
+        if(arrival >= label.arrival || derived().pruned( round, arrival ))
+            return false;
+        if(prune_rides && arrival >= labels[round-1][stop].arrival)
+            return false;
+
+        label.arrival = arrival;
+        label.kind = RidePred;
+        label.pred = board;
+        label.last = alight;
+        derived().ride_improved( round, stop );
+        improve( round, stop, arrival, RidePred, board, alight );
+        return true;
+    }
+
+    inline bool pruned( const int, const int ) const { return false; }
+    inline void label_improved( const int, const int ) {}
+    inline void ride_improved( const int, const int ) {}
+
+    const RaptorTimetable & timetable;
+    const Footpaths & footpaths;
+    const int max_rides;
+    const bool prune_rides;
+
+    /**
+     * labels[k][s]: earliest arrival at stop s with at most k rides
+     */
+    std::vector< std::vector<StopLabel> > labels;
+
+    /**
+     * rides[k][s]: earliest arrival at stop s in the vehicle of the k-th ride. It is kept apart from labels[k][s]
+     * since walking is only possible from an arrival by vehicle, not from one by a walking transfer
+     */
+    std::vector< std::vector<StopLabel> > rides;
+
+    std::vector<int> marked;
+    std::vector<bool> is_marked;
+    std::vector<int> improved;
+
+    /**
+     * Routes to scan in the current round, and the first position to scan them from
+     */
+    std::vector<int> queued_routes;
+    std::vector<int> scan_from;
+
+private:
+    inline Derived & derived() { return static_cast<Derived &>(*this); }
+
+    void scan_route( const int round, const int route ) {
+        const std::vector<StopLabel> & previous = labels[round-1];
+        int time = UNREACHED;
+        int board = -1;
+        for(int p=scan_from[route] ; p<timetable.route_end(route) ; ++p) {
+            const int stop = timetable.route_stop[p];
+            if(time != UNREACHED && ride( round, stop, time, board, p ))
+                improved.push_back( stop );
+            // an earlier arrival at the stop catches the same departure or an earlier one
+            if(previous[stop].arrival < time) {
+                time = previous[stop].arrival;
+                board = p;
+            }
+            if(time != UNREACHED && p + 1 < timetable.route_end(route)) {
+                ++count;
+                time = timetable.forward( p, time );
+                if(time < 0)
+                    time = UNREACHED;
+            }
+        }
+        scan_from[route] = UNREACHED;
+    }
+};
+
+template<typename Derived>
+const int RoundSearch<Derived>::UNREACHED;
+
+/**
+ * RAPTOR (Delling & al.) computing the Pareto set of (arrival time, number of rides) from a source node to a
+ * target node, round 0 being the walk from the source to the stops.
+ *
+ * The range mode (rRAPTOR) runs one search per departure time in a window, from the latest to the earliest,
+ * keeping the labels between searches so that each one only explores what the later ones did not reach.
+ */
+class Raptor : public RoundSearch<Raptor>
+{
+    friend class RoundSearch<Raptor>;
+
+public:
+    Raptor( const RaptorTimetable & timetable, const int source, const int target, const int max_rides = 8 );
+
+    /**
+     * Pareto set of the itineraries leaving at `departure_time`, by increasing number of rides
+     */
+    std::vector<Journey> run( const int departure_time );
+
+    /**
+     * Pareto set of the itineraries leaving in [earliest, latest], by decreasing departure
+     */
+    std::vector<Journey> run_range( const int earliest, const int latest );
+
+private:
+    /**
+     * One search leaving at `departure`, labels of the previous searches are kept
+     */
+    void search( const int departure, std::vector<Journey> & journeys );
+    Path path( int round, int stop ) const;
+
+    inline bool pruned( const int round, const int arrival ) const { return arrival >= target_arrival[round]; }
+    void label_improved( const int round, const int stop );
+
+    /**
+     * Walks to and from the stops, the walker being taken from the pool of the footpaths
+     */
+    boost::shared_ptr<Walker> walker;
+    const int source;
+    const int target;
+
+    /**
+     * Walk from the source to each stop and from each stop to the target, -1 if too far
+     */
+    std::vector<int> access;
+    std::vector<int> egress;
+    int direct_walk;
+
+    /**
+     * Earliest arrival at the target with at most k rides, the stop it was reached from (-1: walking from the source)
+     * and the round of the label of that stop
+     */
+    std::vector<int> target_arrival;
+    std::vector<int> target_stop;
+    std::vector<int> target_round;
+};
+
+} // end namespace PT
+
+#endif
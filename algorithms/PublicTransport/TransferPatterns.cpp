@@ -0,0 +1,511 @@
+/** Copyright : Arthur Bit-Monnot (2013)  arthur.bit-monnot@laas.fr
+
+This software is a computer program whose purpose is to [describe
+functionalities and technical features of your software].
+
+This software is governed by the CeCILL-B license under French law and
+abiding by the rules of distribution of free software.  You can  use, 
+modify and/ or redistribute the software under the terms of the CeCILL-B
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info". 
+
+As a counterpart to the access to the source code and  rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty  and the software's author,  the holder of the
+economic rights,  and the successive licensors  have only  limited
+liability. 
+
+In this respect, the user's attention is drawn to the risks associated
+with loading,  using,  modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean  that it is complicated to manipulate,  and  that  also
+therefore means  that it is reserved for developers  and  experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or 
+data to be ensured and,  more generally, to use and operate it in the 
+same conditions as regards security. 
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL-B license and that you accept its terms. 
+*/
+
+#include <algorithm>
+#include <functional>
+#include <fstream>
+#include <stdexcept>
+#include <map>
+#include <queue>
+#include <boost/foreach.hpp>
+#include <boost/serialization/vector.hpp>
+#include <boost/archive/binary_iarchive.hpp>
+#include <boost/archive/binary_oarchive.hpp>
+
+#include "TransferPatterns.h"
+#include "utils.h"
+
+namespace PT {
+
+namespace {
+
+const std::string TRANSFER_PATTERNS_ARCHIVE_TAG = "#mumoro-transfer-patterns";
+
+/**
+ * Stop from which the walking transfer t leaves
+ */
+inline int transfer_source( const Footpaths & footpaths, const int t )
+{
+    return std::upper_bound( footpaths.first_transfer.begin(), footpaths.first_transfer.end(), t ) - footpaths.first_transfer.begin() - 1;
+}
+
+/**
+ * Prefix tree of the patterns of a stop and its targets (stop, node). A ride hop is an index in `segments`.
+ */
+struct StopPatterns
+{
+    std::vector<int> parent;
+    std::vector<int> hop;
+    std::vector< std::pair<int, int> > targets;
+    std::vector< std::vector<int> > segments;
+};
+
+/**
+ * Range search from a stop to every other stop, following the rounds of Raptor
+ */
+class PatternSearch : public RoundSearch<PatternSearch>
+{
+    friend class RoundSearch<PatternSearch>;
+
+public:
+    PatternSearch( const RaptorTimetable & timetable, const int max_rides ) : RoundSearch<PatternSearch>(timetable, max_rides) {}
+
+    void run( const int source, StopPatterns & patterns );
+
+private:
+    void search( const int source, const int departure );
+
+    inline void label_improved( const int round, const int stop ) {
+        if(round > 0)
+            found.push_back( std::make_pair(round, stop) );
+    }
+
+    /**
+     * Adds the hops of the itinerary of labels[round][stop] to the prefix tree
+     */
+    void add_pattern( int round, int stop, StopPatterns & patterns );
+
+    /**
+     * Labels (round, stop) improved by the current search
+     */
+    std::vector< std::pair<int, int> > found;
+
+    /**
+     * Node reached from a node of the tree by a hop
+     */
+    std::map< std::pair<int, int>, int > children;
+
+    /**
+     * Index of the segments already in the patterns
+     */
+    std::map< std::vector<int>, int > segment_ids;
+};
+
+void PatternSearch::run( const int source, StopPatterns & patterns )
+{
+    clear();
+    children.clear();
+    segment_ids.clear();
+    patterns.parent.assign( 1, -1 );
+    patterns.hop.assign( 1, -1 );
+    patterns.targets.clear();
+    patterns.segments.clear();
+
+    std::vector<int> departures;
+    day_departures( source, departures );
+
+    BOOST_FOREACH( const int departure, departures ) {
+        found.clear();
+        search( source, departure );
+
+        std::sort( found.begin(), found.end() );
+        found.erase( std::unique( found.begin(), found.end() ), found.end() );
+        for(uint i=0 ; i<found.size() ; ++i) {
+            const int k = found[i].first, s = found[i].second;
+            // not dominated by an itinerary with fewer rides
+            if(labels[k][s].kind != CopyPred && labels[k][s].arrival < labels[k-1][s].arrival)
+                add_pattern( k, s, patterns );
+        }
+    }
+
+    std::sort( patterns.targets.begin(), patterns.targets.end() );
+    patterns.targets.erase( std::unique( patterns.targets.begin(), patterns.targets.end() ), patterns.targets.end() );
+}
+
+void PatternSearch::search( const int source, const int departure )
+{
+    marked.clear();
+    if(improve( 0, source, departure, SourcePred, -1 ))
+        marked.push_back( source );
+
+    for(int k=1 ; k<=max_rides && !marked.empty() ; ++k) {
+        round( k );
+    }
+}
+
+void PatternSearch::add_pattern( int round, int stop, StopPatterns & patterns )
+{
+    const int target = stop;
+
+    // hops from the last one to the first one
+    std::vector<int> hops;
+    bool in_vehicle = false;
+    for(;;) {
+        const StopLabel & label = in_vehicle ? rides[round][stop] : labels[round][stop];
+        if(label.kind == CopyPred) {
+            --round;
+        } else if(label.kind == WalkPred) {
+            hops.push_back( -2 - label.last );
+            stop = label.pred;
+            in_vehicle = true;
+        } else if(label.kind == RidePred) {
+            const std::vector<int> segment( timetable.route_edge.begin() + label.pred, timetable.route_edge.begin() + label.last );
+            std::map< std::vector<int>, int >::const_iterator it = segment_ids.find( segment );
+            if(it == segment_ids.end()) {
+                it = segment_ids.insert( std::make_pair(segment, (int) patterns.segments.size()) ).first;
+                patterns.segments.push_back( segment );
+            }
+            hops.push_back( it->second );
+            stop = timetable.route_stop[label.pred];
+            in_vehicle = false;
+            --round;
+        } else {
+            BOOST_ASSERT( label.kind == SourcePred );
+            break;
+        }
+    }
+
+    int node = 0;
+    for(int i=hops.size()-1 ; i>=0 ; --i) {
+        const std::pair<int, int> key( node, hops[i] );
+        std::map< std::pair<int, int>, int >::const_iterator it = children.find( key );
+        if(it == children.end()) {
+            it = children.insert( std::make_pair(key, (int) patterns.hop.size()) ).first;
+            patterns.parent.push_back( node );
+            patterns.hop.push_back( hops[i] );
+        }
+        node = it->second;
+    }
+    patterns.targets.push_back( std::make_pair(target, node) );
+}
+
+} // end anonymous namespace
+
+
+TransferPatterns::TransferPatterns( const Footpaths & footpaths, const int day, const int max_rides, const int threads ) :
+    footpaths(footpaths), day(day)
+{
+    const RaptorTimetable timetable( footpaths, day );
+    std::vector<StopPatterns> stop_patterns( footpaths.num_stops() );
+    for(int s=0 ; s<footpaths.num_stops() ; ++s) {
+        stop_patterns[s].parent.assign( 1, -1 );
+        stop_patterns[s].hop.assign( 1, -1 );
+    }
+
+    if(timetable.lines) {
+        // each thread keeps its search from one stop to the next
+        std::vector< boost::shared_ptr<PatternSearch> > searches( num_threads(threads) );
+        parallel_for( footpaths.num_stops(), threads, [&]( const int s, const int t ) {
+            if(!searches[t])
+                searches[t].reset( new PatternSearch( timetable, max_rides ) );
+            searches[t]->run( s, stop_patterns[s] );
+        } );
+    }
+
+    // the segments are shared by all the stops
+    std::map< std::vector<int>, int > segment_ids;
+    first_node.push_back( 0 );
+    first_target.push_back( 0 );
+    first_segment_edge.push_back( 0 );
+    BOOST_FOREACH( StopPatterns & patterns, stop_patterns ) {
+        node_parent.insert( node_parent.end(), patterns.parent.begin(), patterns.parent.end() );
+        BOOST_FOREACH( int hop, patterns.hop ) {
+            if(hop >= 0) {
+                const std::vector<int> & edges = patterns.segments[hop];
+                std::map< std::vector<int>, int >::const_iterator it = segment_ids.find( edges );
+                if(it == segment_ids.end()) {
+                    it = segment_ids.insert( std::make_pair(edges, num_segments()) ).first;
+                    segment_edges.insert( segment_edges.end(), edges.begin(), edges.end() );
+                    first_segment_edge.push_back( segment_edges.size() );
+                }
+                hop = it->second;
+            }
+            node_hop.push_back( hop );
+        }
+        first_node.push_back( node_hop.size() );
+        for(uint i=0 ; i<patterns.targets.size() ; ++i) {
+            target_stop.push_back( patterns.targets[i].first );
+            target_node.push_back( patterns.targets[i].second );
+        }
+        first_target.push_back( target_stop.size() );
+        patterns = StopPatterns();
+    }
+}
+
+TransferPatterns::TransferPatterns( const Footpaths & footpaths, const std::string & filename ) :
+    footpaths(footpaths)
+{
+    std::ifstream ifile(filename.c_str());
+    if(!ifile)
+        throw std::runtime_error( "Unable to open " + filename );
+    boost::archive::binary_iarchive iArchive(ifile);
+    std::string tag, id;
+    iArchive >> tag;
+    if(tag != TRANSFER_PATTERNS_ARCHIVE_TAG)
+        throw std::runtime_error( "Not a transfer patterns file: " + filename );
+    iArchive >> id;
+    if(id != footpaths.graph->get_id())
+        throw std::runtime_error( "Transfer patterns of another graph (" + id + "): " + filename );
+    iArchive >> day;
+    iArchive >> first_node;
+    iArchive >> node_parent;
+    iArchive >> node_hop;
+    iArchive >> first_target;
+    iArchive >> target_stop;
+    iArchive >> target_node;
+    iArchive >> first_segment_edge;
+    iArchive >> segment_edges;
+    // the id names the dump the graph was built from, a rebuilt graph keeps it: the patterns must fit the footpaths
+    if(!fits_footpaths())
+        throw std::runtime_error( "Transfer patterns computed with other footpaths: " + filename );
+}
+
+bool TransferPatterns::fits_footpaths() const
+{
+    const int num_stops = footpaths.num_stops();
+    const int num_transfers = footpaths.transfer_target.size();
+    if( (int) first_node.size() != num_stops + 1 || (int) first_target.size() != num_stops + 1
+        || node_parent.size() != node_hop.size() || target_node.size() != target_stop.size()
+        || !Transport::valid_offsets(first_node, node_hop.size())
+        || !Transport::valid_offsets(first_target, target_stop.size())
+        || !Transport::valid_offsets(first_segment_edge, segment_edges.size())
+        || !Transport::all_below(segment_edges, footpaths.graph->csr().num_edges())
+        || !Transport::all_below(target_stop, num_stops) )
+        return false;
+    for(int stop=0 ; stop<num_stops ; ++stop) {
+        const int tree_size = nodes_end(stop) - nodes_begin(stop);
+        // the root of the tree (its first node) has no parent nor hop
+        for(int node=nodes_begin(stop) + 1 ; node<nodes_end(stop) ; ++node) {
+            const int hop = node_hop[node];
+            if( node_parent[node] < 0 || node_parent[node] >= tree_size
+                || (is_transfer(hop) ? transfer(hop) >= num_transfers : hop < 0 || hop >= num_segments()) )
+                return false;
+        }
+        for(int t=targets_begin(stop) ; t<targets_end(stop) ; ++t) {
+            if(target_node[t] < 0 || target_node[t] >= tree_size)
+                return false;
+        }
+    }
+    return true;
+}
+
+void TransferPatterns::save( const std::string & filename ) const
+{
+    std::ofstream ofile(filename.c_str());
+    boost::archive::binary_oarchive oArchive(ofile);
+    oArchive << TRANSFER_PATTERNS_ARCHIVE_TAG;
+    oArchive << footpaths.graph->get_id();
+    oArchive << day;
+    oArchive << first_node;
+    oArchive << node_parent;
+    oArchive << node_hop;
+    oArchive << first_target;
+    oArchive << target_stop;
+    oArchive << target_node;
+    oArchive << first_segment_edge;
+    oArchive << segment_edges;
+}
+
+
+const int TransferPatternsQuery::UNREACHED;
+
+TransferPatternsQuery::TransferPatternsQuery( const TransferPatterns & patterns, const int day ) :
+    count(0), patterns(patterns), footpaths(patterns.footpaths), lines(footpaths.graph->day_timetable(day)),
+    walker(footpaths.acquire_walker()), egress(footpaths.num_stops(), -1), in_graph(patterns.num_nodes(), false),
+    hop_in_graph(patterns.num_segments() + footpaths.transfer_target.size(), false),
+    arrival(2 * footpaths.num_stops(), UNREACHED), pred_vertex(2 * footpaths.num_stops(), -1), pred_hop(2 * footpaths.num_stops(), -1)
+{
+}
+
+Journey TransferPatternsQuery::run( const int source, const int target, const int departure_time )
+{
+    BOOST_FOREACH( const int s, egress_stops ) {
+        egress[s] = -1;
+    }
+    egress_stops.clear();
+    BOOST_FOREACH( const int node, graph_nodes ) {
+        in_graph[node] = false;
+    }
+    graph_nodes.clear();
+    BOOST_FOREACH( const int h, graph_hops ) {
+        hop_in_graph[h] = false;
+    }
+    graph_hops.clear();
+    BOOST_FOREACH( const int v, touched ) {
+        arrival[v] = UNREACHED;
+    }
+    touched.clear();
+
+    Journey journey;
+    journey.departure = departure_time;
+    journey.arrival = -1;
+    journey.rides = 0;
+    journey.path.start_node = source;
+    journey.path.end_node = target;
+
+    walker->run( target, footpaths.max_walking, false );
+    for(uint i=0 ; i<walker->reached().size() ; ++i) {
+        const int stop = footpaths.stop_index[walker->reached()[i].first];
+        if(stop >= 0) {
+            egress[stop] = walker->reached()[i].second;
+            egress_stops.push_back( stop );
+        }
+    }
+    walker->run( source, footpaths.max_walking );
+    const int direct_walk = walker->duration( target );
+
+    // query graph: hops of the patterns from the stops around the source to the ones around the target
+    hops.clear();
+    // vertices are (stop, 1 if reached by a vehicle): as in Raptor, walking transfers only follow a vehicle
+    typedef std::pair<int, int> QueueItem;
+    std::priority_queue< QueueItem, std::vector<QueueItem>, std::greater<QueueItem> > queue;
+    for(uint i=0 ; i<walker->reached().size() ; ++i) {
+        const int stop = footpaths.stop_index[walker->reached()[i].first];
+        if(stop < 0)
+            continue;
+        arrival[2 * stop] = departure_time + walker->reached()[i].second;
+        pred_vertex[2 * stop] = -1;
+        touched.push_back( 2 * stop );
+        queue.push( QueueItem(arrival[2 * stop], 2 * stop) );
+
+        // the targets of the stop are sorted by stop: only the ones around the target are looked up
+        const int root = patterns.nodes_begin( stop );
+        const std::vector<int>::const_iterator targets_begin = patterns.target_stop.begin() + patterns.targets_begin( stop );
+        const std::vector<int>::const_iterator targets_end = patterns.target_stop.begin() + patterns.targets_end( stop );
+        BOOST_FOREACH( const int egress_stop, egress_stops ) {
+            std::vector<int>::const_iterator it = std::lower_bound( targets_begin, targets_end, egress_stop );
+            for( ; it != targets_end && *it == egress_stop ; ++it)
+                add_pattern( root, root + patterns.target_node[it - patterns.target_stop.begin()] );
+        }
+    }
+    std::sort( hops.begin(), hops.end() );
+    count = hops.size();
+
+    // earliest arrival on the query graph
+    int best = direct_walk >= 0 ? departure_time + direct_walk : UNREACHED;
+    int best_vertex = -1;
+    while( !queue.empty() && queue.top().first < best ) {
+        const QueueItem curr = queue.top();
+        queue.pop();
+        const int vertex = curr.second;
+        const int stop = vertex / 2;
+        if(curr.first > arrival[vertex])
+            continue;
+        if(egress[stop] >= 0 && curr.first + egress[stop] < best) {
+            best = curr.first + egress[stop];
+            best_vertex = vertex;
+        }
+
+        std::vector< std::pair<int, StopHop> >::const_iterator it = std::lower_bound( hops.begin(), hops.end(), std::make_pair(stop, StopHop(-1, -0x7fffffff)) );
+        for( ; it != hops.end() && it->first == stop ; ++it) {
+            const int hop = it->second.second;
+            int duration;
+            if(TransferPatterns::is_transfer(hop))
+                duration = vertex % 2 == 1 ? footpaths.transfer_duration[TransferPatterns::transfer(hop)] : -1;
+            else
+                duration = lines ? ride( hop, curr.first ) : -1;
+            if(duration < 0)
+                continue;
+            const int next = 2 * it->second.first + (TransferPatterns::is_transfer(hop) ? 0 : 1);
+            if(curr.first + duration < arrival[next]) {
+                if(arrival[next] == UNREACHED)
+                    touched.push_back( next );
+                arrival[next] = curr.first + duration;
+                pred_vertex[next] = vertex;
+                pred_hop[next] = hop;
+                queue.push( QueueItem(arrival[next], next) );
+            }
+        }
+    }
+    if(best == UNREACHED)
+        return journey;
+    journey.arrival = best;
+
+    if(best_vertex < 0) {
+        journey.path.edges = walker->path_to( target );
+        return journey;
+    }
+
+    // edges from the last stop back to the source
+    walker->run( target, footpaths.max_walking, false );
+    journey.path.edges = walker->path_to( footpaths.stops[best_vertex / 2] );
+    int vertex = best_vertex;
+    while( pred_vertex[vertex] >= 0 ) {
+        const int hop = pred_hop[vertex];
+        const int previous = pred_vertex[vertex];
+        if(TransferPatterns::is_transfer(hop)) {
+            walker->run( footpaths.stops[previous / 2], footpaths.max_transfer );
+            std::list<int> walk = walker->path_to( footpaths.stops[vertex / 2] );
+            journey.path.edges.splice( journey.path.edges.begin(), walk );
+        } else {
+            for(int i=patterns.edges_end(hop) - 1 ; i>=patterns.edges_begin(hop) ; --i)
+                journey.path.edges.push_front( patterns.segment_edges[i] );
+            ++journey.rides;
+        }
+        vertex = previous;
+    }
+    walker->run( source, footpaths.max_walking );
+    std::list<int> walk = walker->path_to( footpaths.stops[vertex / 2] );
+    journey.path.edges.splice( journey.path.edges.begin(), walk );
+    return journey;
+}
+
+void TransferPatternsQuery::add_pattern( const int root, const int last_node )
+{
+    const Transport::CsrGraph & csr = footpaths.graph->csr();
+    for(int node=last_node ; node != root ; node=root + patterns.node_parent[node]) {
+        // the rest of the pattern is already in the query graph
+        if(in_graph[node])
+            break;
+        in_graph[node] = true;
+        graph_nodes.push_back( node );
+        const int hop = patterns.node_hop[node];
+        const int h = TransferPatterns::is_transfer(hop) ? patterns.num_segments() + TransferPatterns::transfer(hop) : hop;
+        if(hop_in_graph[h])
+            continue;
+        hop_in_graph[h] = true;
+        graph_hops.push_back( h );
+        if(TransferPatterns::is_transfer(hop)) {
+            const int t = TransferPatterns::transfer(hop);
+            hops.push_back( std::make_pair(transfer_source( footpaths, t ), StopHop(footpaths.transfer_target[t], hop)) );
+        } else {
+            const int first = patterns.segment_edges[patterns.edges_begin(hop)];
+            const int last = patterns.segment_edges[patterns.edges_end(hop) - 1];
+            hops.push_back( std::make_pair(footpaths.stop_index[csr.tail[first]], StopHop(footpaths.stop_index[csr.head[last]], hop)) );
+        }
+    }
+}
+
+int TransferPatternsQuery::ride( const int segment, const int start_time ) const
+{
+    const Transport::Graph * graph = footpaths.graph;
+    int time = start_time;
+    for(int i=patterns.edges_begin(segment) ; i<patterns.edges_end(segment) ; ++i) {
+        const int duration = lines->forward( graph->timetable_index(patterns.segment_edges[i]), time );
+        if(duration < 0)
+            return -1;
+        time += duration;
+    }
+    return time - start_time;
+}
+
+} // end namespace PT
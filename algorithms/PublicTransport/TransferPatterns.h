@@ -0,0 +1,206 @@
+/** Copyright : Arthur Bit-Monnot (2013)  arthur.bit-monnot@laas.fr
+
+This software is a computer program whose purpose is to [describe
+functionalities and technical features of your software].
+
+This software is governed by the CeCILL-B license under French law and
+abiding by the rules of distribution of free software.  You can  use, 
+modify and/ or redistribute the software under the terms of the CeCILL-B
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info". 
+
+As a counterpart to the access to the source code and  rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty  and the software's author,  the holder of the
+economic rights,  and the successive licensors  have only  limited
+liability. 
+
+In this respect, the user's attention is drawn to the risks associated
+with loading,  using,  modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean  that it is complicated to manipulate,  and  that  also
+therefore means  that it is reserved for developers  and  experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or 
+data to be ensured and,  more generally, to use and operate it in the 
+same conditions as regards security. 
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL-B license and that you accept its terms. 
+*/
+
+#ifndef PT_TRANSFER_PATTERNS_H
+#define PT_TRANSFER_PATTERNS_H
+
+#include <string>
+#include <vector>
+
+#include "Raptor.h"
+
+namespace PT {
+
+/**
+ * Transfer patterns of Bast & al.: for each stop, the sequences of hops of the optimal itineraries leaving
+ * it at any time of a representative day towards every other stop.
+ *
+ * They are computed by a range search from each stop (similar to Raptor::run_range, without target), stops
+ * being spread over several threads. A hop is either a segment (the timetabled edges travelled during one ride,
+ * from the stop where it boards to the one where it alights) or a walking transfer; an itinerary of the Pareto
+ * set (departure, arrival, rides) adds its hops to the prefix tree of its first stop and the node it ends on
+ * is a target of the stop it reaches.
+ *
+ * The prefix tree of stop s is made of the nodes [nodes_begin(s), nodes_end(s)), its root being the first one.
+ * The targets of s are [targets_begin(s), targets_end(s)), sorted by stop.
+ */
+class TransferPatterns
+{
+public:
+    /**
+     * Computes the patterns of the itineraries using at most `max_rides` vehicles leaving during `day`,
+     * using `threads` threads (0: one per core)
+     */
+    TransferPatterns( const Footpaths & footpaths, const int day, const int max_rides = 8, const int threads = 0 );
+
+    /**
+     * Loads patterns written by save(). They must have been computed on a graph with the same id.
+     * Throws std::runtime_error if their offsets, hops or edges do not fit the footpaths and their graph.
+     */
+    TransferPatterns( const Footpaths & footpaths, const std::string & filename );
+
+    void save( const std::string & filename ) const;
+
+    const Footpaths & footpaths;
+
+    /**
+     * Day the patterns were computed on
+     */
+    int day;
+
+    inline int nodes_begin( const int stop ) const { return first_node[stop]; }
+    inline int nodes_end( const int stop ) const { return first_node[stop+1]; }
+    inline int targets_begin( const int stop ) const { return first_target[stop]; }
+    inline int targets_end( const int stop ) const { return first_target[stop+1]; }
+    inline int num_nodes() const { return node_hop.size(); }
+    inline int edges_begin( const int segment ) const { return first_segment_edge[segment]; }
+    inline int edges_end( const int segment ) const { return first_segment_edge[segment+1]; }
+    inline int num_segments() const { return first_segment_edge.size() - 1; }
+
+    /**
+     * Parent of each node, as an offset from the root of its tree (-1 for the roots)
+     */
+    std::vector<int> node_parent;
+
+    /**
+     * Hop reaching each node: the segment (>= 0) or the walking transfer t of the footpaths as -2 - t
+     * (-1 for the roots)
+     */
+    std::vector<int> node_hop;
+
+    /**
+     * Edges of the transport graph of the segments, those of segment s being [edges_begin(s), edges_end(s))
+     */
+    std::vector<int> segment_edges;
+
+    std::vector<int> target_stop;
+    std::vector<int> target_node;
+
+    static inline bool is_transfer( const int hop ) { return hop <= -2; }
+    static inline int transfer( const int hop ) { return -2 - hop; }
+
+private:
+    /**
+     * True if the offsets, parents, hops and targets index the patterns, the footpaths and the graph within bounds
+     */
+    bool fits_footpaths() const;
+
+    std::vector<int> first_node;
+    std::vector<int> first_target;
+    std::vector<int> first_segment_edge;
+};
+
+/**
+ * Earliest arrival itinerary using the transfer patterns of the stops around the source.
+ *
+ * The query graph is made of the hops of the patterns going from a stop within walking distance of the source
+ * to a stop within walking distance of the target. It is small and evaluated with the timetables of the day of
+ * the query. The result is optimal on the day of the patterns; on other days, optimal itineraries whose
+ * pattern never is on that day are missed.
+ *
+ * The query graph grows with the number of stops within walking distance of the source and of the target:
+ * when walks are long compared to the distance between stops, Raptor answers faster.
+ */
+class TransferPatternsQuery
+{
+public:
+    TransferPatternsQuery( const TransferPatterns & patterns, const int day );
+
+    /**
+     * Itinerary arriving the earliest, with an arrival of -1 if there is none
+     */
+    Journey run( const int source, const int target, const int departure_time );
+
+    /**
+     * Number of hops in the query graph of the last run
+     */
+    int count;
+
+private:
+    static const int UNREACHED = 0x7fffffff;
+
+    typedef std::pair<int, int> StopHop;
+
+    /**
+     * Adds the hops of a pattern to the query graph, from its last node up to the root of its tree
+     */
+    void add_pattern( const int root, const int last_node );
+
+    /**
+     * Time needed to ride along a segment when reaching its first stop at `start_time`, -1 if no line leaves
+     * after it. As in Raptor, each edge takes the first line leaving once the previous one arrived.
+     */
+    int ride( const int segment, const int start_time ) const;
+
+    const TransferPatterns & patterns;
+    const Footpaths & footpaths;
+    boost::shared_ptr<const Transport::DayTimetable> lines;
+    /**
+     * Walks to and from the stops, the walker being taken from the pool of the footpaths
+     */
+    boost::shared_ptr<Walker> walker;
+
+    /**
+     * Walk from each stop to the target, -1 if too far
+     */
+    std::vector<int> egress;
+    std::vector<int> egress_stops;
+
+    /**
+     * Nodes of the patterns already in the query graph
+     */
+    std::vector<bool> in_graph;
+    std::vector<int> graph_nodes;
+
+    /**
+     * Hops already in the query graph, by segment then by transfer: several stops share most of them
+     */
+    std::vector<bool> hop_in_graph;
+    std::vector<int> graph_hops;
+
+    /**
+     * Hops of the query graph as (stop left, (stop reached, hop))
+     */
+    std::vector< std::pair<int, StopHop> > hops;
+
+    /**
+     * Earliest arrival at each vertex (stop, 1 if reached by a vehicle) with the previous vertex and the hop
+     */
+    std::vector<int> arrival;
+    std::vector<int> pred_vertex;
+    std::vector<int> pred_hop;
+    std::vector<int> touched;
+};
+
+} // end namespace PT
+
+#endif
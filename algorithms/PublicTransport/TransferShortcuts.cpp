@@ -0,0 +1,315 @@
+/** Copyright : Arthur Bit-Monnot (2013)  arthur.bit-monnot@laas.fr
+
+This software is a computer program whose purpose is to [describe
+functionalities and technical features of your software].
+
+This software is governed by the CeCILL-B license under French law and
+abiding by the rules of distribution of free software.  You can  use, 
+modify and/ or redistribute the software under the terms of the CeCILL-B
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info". 
+
+As a counterpart to the access to the source code and  rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty  and the software's author,  the holder of the
+economic rights,  and the successive licensors  have only  limited
+liability. 
+
+In this respect, the user's attention is drawn to the risks associated
+with loading,  using,  modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean  that it is complicated to manipulate,  and  that  also
+therefore means  that it is reserved for developers  and  experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or 
+data to be ensured and,  more generally, to use and operate it in the 
+same conditions as regards security. 
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL-B license and that you accept its terms. 
+*/
+
+#include <algorithm>
+#include <functional>
+#include <fstream>
+#include <stdexcept>
+#include <queue>
+#include <boost/foreach.hpp>
+#include <boost/serialization/vector.hpp>
+#include <boost/archive/binary_iarchive.hpp>
+#include <boost/archive/binary_oarchive.hpp>
+
+#include "TransferShortcuts.h"
+#include "Raptor.h"
+#include "utils.h"
+
+namespace PT {
+
+namespace {
+
+const std::string TRANSFER_SHORTCUTS_ARCHIVE_TAG = "#mumoro-transfer-shortcuts";
+
+struct Shortcut
+{
+    Shortcut() : from(-1), to(-1), duration(0) {}
+    Shortcut( const int from, const int to, const int duration ) : from(from), to(to), duration(duration) {}
+    int from;
+    int to;
+    int duration;
+
+    bool operator<( const Shortcut & other ) const {
+        return from < other.from || (from == other.from && (to < other.to || (to == other.to && duration < other.duration)));
+    }
+};
+
+/**
+ * Range search from a stop limited to two rides, the walk between them going through the street network
+ *
+ * Unlike Raptor, an arrival in a vehicle is kept even if the stop was reached earlier with fewer rides, so that
+ * the shortcuts do not depend on how an engine prunes its rides.
+ */
+class ShortcutSearch : public RoundSearch<ShortcutSearch>
+{
+    friend class RoundSearch<ShortcutSearch>;
+
+public:
+    ShortcutSearch( const RaptorTimetable & timetable, const int max_transfer ) :
+        RoundSearch<ShortcutSearch>(timetable, 2, false), graph(footpaths.graph), max_transfer(max_transfer),
+        dist(graph->num_vertices(), UNREACHED), origin(graph->num_vertices(), -1), walk(graph->num_vertices(), 0) {}
+
+    /**
+     * Adds to `shortcuts` the transfers of the optimal itineraries from `source`
+     */
+    void run( const int source, std::vector<Shortcut> & shortcuts );
+
+private:
+    void search( const int source, const int departure );
+
+    /**
+     * Walks from the stops reached in the first round to every stop, through the street network. Unlike the
+     * transfers of the footpaths, these walks set labels[1].
+     */
+    void walk_round();
+
+    void ride_improved( const int round, const int stop );
+
+    const Transport::Graph * graph;
+    const int max_transfer;
+
+    /**
+     * Transfer between the two rides of rides[2][s], `from` being -1 if both rides met at the same stop
+     */
+    std::vector<Shortcut> ride_walk;
+
+    /**
+     * Dijkstra of the intermediate walk: arrival at each node, stop it left and walking duration
+     */
+    std::vector<int> dist;
+    std::vector<int> origin;
+    std::vector<int> walk;
+    std::vector<int> touched;
+
+    /**
+     * Stops improved by the second ride of the current search
+     */
+    std::vector<int> found;
+};
+
+void ShortcutSearch::run( const int source, std::vector<Shortcut> & shortcuts )
+{
+    clear();
+    ride_walk.assign( footpaths.num_stops(), Shortcut() );
+
+    std::vector<int> departures;
+    day_departures( source, departures );
+
+    BOOST_FOREACH( const int departure, departures ) {
+        found.clear();
+        search( source, departure );
+
+        // the labels kept from the later departures were not improved: their transfers are already known
+        std::sort( found.begin(), found.end() );
+        found.erase( std::unique( found.begin(), found.end() ), found.end() );
+        BOOST_FOREACH( const int s, found ) {
+            if(ride_walk[s].from >= 0)
+                shortcuts.push_back( ride_walk[s] );
+        }
+    }
+}
+
+void ShortcutSearch::search( const int source, const int departure )
+{
+    if(departure >= labels[0][source].arrival)
+        return;
+    labels[0][source].arrival = departure;
+    labels[0][source].kind = SourcePred;
+
+    marked.assign( 1, source );
+    scan_routes( 1 );
+    walk_round();
+    scan_routes( 2 );
+}
+
+void ShortcutSearch::ride_improved( const int round, const int stop )
+{
+    if(round < 2)
+        return;
+    const int board = timetable.route_stop[rides[2][stop].pred];
+    const StopLabel & walked = labels[1][board];
+    if(walked.kind == WalkPred)
+        ride_walk[stop] = Shortcut( walked.pred, board, walked.arrival - rides[1][walked.pred].arrival );
+    else
+        ride_walk[stop] = Shortcut();
+    // not dominated by a single ride, a walk to that stop not allowing to walk again from it
+    if(rides[2][stop].arrival < rides[1][stop].arrival)
+        found.push_back( stop );
+}
+
+void ShortcutSearch::walk_round()
+{
+    const Transport::CsrGraph & csr = graph->csr();
+    BOOST_FOREACH( const int n, touched ) {
+        dist[n] = UNREACHED;
+    }
+    touched.clear();
+
+    typedef std::pair<int, int> QueueItem;
+    std::priority_queue< QueueItem, std::vector<QueueItem>, std::greater<QueueItem> > queue;
+    BOOST_FOREACH( const int s, improved ) {
+        const int node = footpaths.stops[s];
+        if(rides[1][s].arrival >= dist[node])
+            continue;
+        if(dist[node] == UNREACHED)
+            touched.push_back( node );
+        dist[node] = rides[1][s].arrival;
+        origin[node] = s;
+        walk[node] = 0;
+        queue.push( QueueItem(dist[node], node) );
+    }
+
+    marked.clear();
+    while( !queue.empty() ) {
+        const QueueItem curr = queue.top();
+        queue.pop();
+        const int node = curr.second;
+        if(curr.first > dist[node])
+            continue;
+
+        const int stop = footpaths.stop_index[node];
+        // the first round already set labels[1] to the arrival of the vehicle, which must be boarded from as well
+        if(stop >= 0 && curr.first <= labels[1][stop].arrival && curr.first < labels[0][stop].arrival) {
+            StopLabel & label = labels[1][stop];
+            label.arrival = curr.first;
+            label.kind = origin[node] == stop ? RidePred : WalkPred;
+            label.pred = origin[node];
+            if(!is_marked[stop]) {
+                is_marked[stop] = true;
+                marked.push_back( stop );
+            }
+        }
+
+        for(int mode=0 ; mode<Transport::CsrGraph::num_modes ; ++mode) {
+            if(!is_footpath_mode(mode))
+                continue;
+            for(int edge=csr.out_begin(node, mode) ; edge<csr.out_end(node, mode) ; ++edge) {
+                const int next = csr.head[edge];
+                const int duration = graph->min_duration(edge).second;
+                const int next_dist = curr.first + duration;
+                if(walk[node] + duration <= max_transfer && next_dist < dist[next]) {
+                    if(dist[next] == UNREACHED)
+                        touched.push_back( next );
+                    dist[next] = next_dist;
+                    origin[next] = origin[node];
+                    walk[next] = walk[node] + duration;
+                    queue.push( QueueItem(next_dist, next) );
+                }
+            }
+        }
+    }
+    BOOST_FOREACH( const int s, marked ) {
+        is_marked[s] = false;
+    }
+}
+
+} // end anonymous namespace
+
+
+TransferShortcuts::TransferShortcuts( const Transport::Graph * graph, const int day, const int max_walking,
+                                      const int max_transfer, const int threads ) :
+    Footpaths(graph, max_walking, max_transfer), day(day)
+{
+    const RaptorTimetable timetable( *this, day );
+    std::vector< std::vector<Shortcut> > found( num_threads(threads) );
+
+    if(timetable.lines) {
+        // each thread keeps its search from one stop to the next
+        std::vector< boost::shared_ptr<ShortcutSearch> > searches( found.size() );
+        parallel_for( num_stops(), threads, [&]( const int s, const int t ) {
+            if(!searches[t])
+                searches[t].reset( new ShortcutSearch( timetable, max_transfer ) );
+            searches[t]->run( s, found[t] );
+        } );
+    }
+
+    // the same transfer is found from several stops and departures, its duration is the shortest walk
+    std::vector<Shortcut> shortcuts;
+    BOOST_FOREACH( const std::vector<Shortcut> & f, found ) {
+        shortcuts.insert( shortcuts.end(), f.begin(), f.end() );
+    }
+    std::sort( shortcuts.begin(), shortcuts.end() );
+
+    first_transfer.reserve( num_stops() + 1 );
+    uint i = 0;
+    for(int s=0 ; s<num_stops() ; ++s) {
+        first_transfer.push_back( transfer_target.size() );
+        for( ; i<shortcuts.size() && shortcuts[i].from == s ; ++i) {
+            if(transfer_target.size() > (uint) first_transfer.back() && transfer_target.back() == shortcuts[i].to)
+                continue;
+            transfer_target.push_back( shortcuts[i].to );
+            transfer_duration.push_back( shortcuts[i].duration );
+        }
+    }
+    first_transfer.push_back( transfer_target.size() );
+}
+
+TransferShortcuts::TransferShortcuts( const Transport::Graph * graph, const std::string & filename, const int max_walking ) :
+    Footpaths(graph, max_walking, 0)
+{
+    std::ifstream ifile(filename.c_str());
+    if(!ifile)
+        throw std::runtime_error( "Unable to open " + filename );
+    boost::archive::binary_iarchive iArchive(ifile);
+    std::string tag, id;
+    iArchive >> tag;
+    if(tag != TRANSFER_SHORTCUTS_ARCHIVE_TAG)
+        throw std::runtime_error( "Not a transfer shortcuts file: " + filename );
+    iArchive >> id;
+    if(id != graph->get_id())
+        throw std::runtime_error( "Transfer shortcuts of another graph (" + id + "): " + filename );
+    iArchive >> day;
+    iArchive >> max_transfer;
+    iArchive >> first_transfer;
+    iArchive >> transfer_target;
+    iArchive >> transfer_duration;
+    // the id names the dump the graph was built from, a rebuilt graph keeps it: the engines index stops with these
+    if( (int) first_transfer.size() != num_stops() + 1 || transfer_duration.size() != transfer_target.size()
+        || !Transport::valid_offsets(first_transfer, transfer_target.size())
+        || !Transport::all_below(transfer_target, num_stops()) )
+        throw std::runtime_error( "Transfer shortcuts of other stops: " + filename );
+}
+
+void TransferShortcuts::save( const std::string & filename ) const
+{
+    std::ofstream ofile(filename.c_str());
+    boost::archive::binary_oarchive oArchive(ofile);
+    oArchive << TRANSFER_SHORTCUTS_ARCHIVE_TAG;
+    oArchive << graph->get_id();
+    oArchive << day;
+    oArchive << max_transfer;
+    oArchive << first_transfer;
+    oArchive << transfer_target;
+    oArchive << transfer_duration;
+}
+
+} // end namespace PT
@@ -0,0 +1,83 @@
+/** Copyright : Arthur Bit-Monnot (2013)  arthur.bit-monnot@laas.fr
+
+This software is a computer program whose purpose is to [describe
+functionalities and technical features of your software].
+
+This software is governed by the CeCILL-B license under French law and
+abiding by the rules of distribution of free software.  You can  use, 
+modify and/ or redistribute the software under the terms of the CeCILL-B
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info". 
+
+As a counterpart to the access to the source code and  rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty  and the software's author,  the holder of the
+economic rights,  and the successive licensors  have only  limited
+liability. 
+
+In this respect, the user's attention is drawn to the risks associated
+with loading,  using,  modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean  that it is complicated to manipulate,  and  that  also
+therefore means  that it is reserved for developers  and  experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or 
+data to be ensured and,  more generally, to use and operate it in the 
+same conditions as regards security. 
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL-B license and that you accept its terms. 
+*/
+
+#ifndef PT_TRANSFER_SHORTCUTS_H
+#define PT_TRANSFER_SHORTCUTS_H
+
+#include <string>
+
+#include "Footpaths.h"
+
+namespace PT {
+
+/**
+ * Walking transfers between stops that are part of an optimal itinerary, following the shortcut
+ * computation of Baum & al. (ULTRA).
+ *
+ * Transfers are not bounded by max_walking but by max_transfer: instead of every stop within walking
+ * distance, a stop only gets the transfers used by an itinerary that rides a vehicle, walks through the
+ * street network and rides a second vehicle, and which no itinerary with a single ride equals. The range
+ * search from every stop uses the departures of one representative day and runs in parallel.
+ *
+ * The result is a Footpaths, so RaptorTimetable, ConnectionTimetable and TransferPatterns use the shortcuts
+ * in place of the transfers within max_walking. The walk from the source to the first stop and from the last
+ * stop to the target are still bounded by max_walking.
+ *
+ * An intermediate walk is bounded by max_transfer from the stop it leaves, and a longer walk arriving earlier
+ * at a street node hides the ones leaving it later: near that bound, a transfer can be missed.
+ */
+class TransferShortcuts : public Footpaths
+{
+public:
+    /**
+     * Computes the shortcuts from the timetables of `day`, with `threads` workers (0: one per core)
+     */
+    TransferShortcuts( const Transport::Graph * graph, const int day, const int max_walking = 15*60,
+                       const int max_transfer = 60*60, const int threads = 0 );
+
+    /**
+     * Loads shortcuts saved by save(), throws std::runtime_error if they were computed for another graph
+     * or if their offsets and targets do not fit the stops of this one
+     */
+    TransferShortcuts( const Transport::Graph * graph, const std::string & filename, const int max_walking = 15*60 );
+
+    void save( const std::string & filename ) const;
+
+    /**
+     * Day whose timetables were used
+     */
+    int day;
+};
+
+} // end namespace PT
+
+#endif
@@ -0,0 +1,40 @@
+%module "mumoro::public_transport"
+
+
+%{
+ #include "Footpaths.h"
+ #include "TransferShortcuts.h"
+ #include "ConnectionScan.h"
+ #include "Raptor.h"
+ #include "TransferPatterns.h"
+%}
+
+// Searches are run through the functions of ItinerariesRequests.h
+%ignore PT::Walker;
+%ignore PT::ConnectionScan;
+%ignore PT::Raptor;
+%ignore PT::TransferPatternsQuery;
+%ignore PT::Footpaths::acquire_walker;
+
+// Parse the original header file
+%include "Footpaths.h"
+%include "TransferShortcuts.h"
+%include "ConnectionScan.h"
+%include "Raptor.h"
+%include "TransferPatterns.h"
+
+%template(JourneyList) std::vector<PT::Journey>;
+
+// The timetables and the transfer patterns keep a reference to their footpaths, which must hence live as long
+// as them even when they were created inline (ConnectionTimetable(Footpaths(g), day))
+%pythoncode %{
+def _keep_footpaths(cls):
+    init = cls.__init__
+    def __init__(self, footpaths, *args):
+        init(self, footpaths, *args)
+        self._footpaths = footpaths
+    cls.__init__ = __init__
+
+for _cls in (ConnectionTimetable, RaptorTimetable, TransferPatterns):
+    _keep_footpaths(_cls)
+%}
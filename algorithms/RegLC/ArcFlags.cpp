@@ -0,0 +1,241 @@
+/** Copyright : Arthur Bit-Monnot (2013)  arthur.bit-monnot@laas.fr
+
+This software is a computer program whose purpose is to [describe
+functionalities and technical features of your software].
+
+This software is governed by the CeCILL-B license under French law and
+abiding by the rules of distribution of free software.  You can  use, 
+modify and/ or redistribute the software under the terms of the CeCILL-B
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info". 
+
+As a counterpart to the access to the source code and  rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty  and the software's author,  the holder of the
+economic rights,  and the successive licensors  have only  limited
+liability. 
+
+In this respect, the user's attention is drawn to the risks associated
+with loading,  using,  modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean  that it is complicated to manipulate,  and  that  also
+therefore means  that it is reserved for developers  and  experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or 
+data to be ensured and,  more generally, to use and operate it in the 
+same conditions as regards security. 
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL-B license and that you accept its terms. 
+*/
+
+#include "ArcFlags.h"
+
+#include <fstream>
+#include <algorithm>
+#include <stdexcept>
+#include <boost/foreach.hpp>
+#include <boost/serialization/vector.hpp>
+#include <boost/serialization/utility.hpp>
+#include <boost/archive/binary_iarchive.hpp>
+#include <boost/archive/binary_oarchive.hpp>
+
+#include "DRegLC.h"
+#include "AspectMinCost.h"
+#include "utils.h"
+
+namespace RLC {
+
+namespace {
+
+const std::string ARC_FLAGS_ARCHIVE_TAG = "#mumoro-arc-flags-2";
+
+/**
+ * Transitions of the DFA, sorted so that two DFAs with the same transitions give the same list
+ */
+DfaEdgeList transitions( const DFA & dfa )
+{
+    DfaEdgeList edges;
+    boost::graph_traits<Graph_t>::edge_iterator it, end;
+    for(boost::tie(it, end) = boost::edges(dfa.graph) ; it != end ; ++it) {
+        const std::pair<int, int> states( boost::source(*it, dfa.graph), boost::target(*it, dfa.graph) );
+        edges.push_back( DfaEdge(states, dfa.graph[*it].type) );
+    }
+    std::sort( edges.begin(), edges.end() );
+    return edges;
+}
+
+/**
+ * Edges cost their duration if it is constant, others are ignored: costs are upper bounds of the distances
+ */
+template<typename Base>
+class AspectConstantCost : public Base {
+public:
+    typedef typename Base::ParamType ParamType;
+    AspectConstantCost( ParamType parameters ) : Base(parameters) {}
+    virtual ~AspectConstantCost() {}
+
+    virtual std::pair <bool, int> duration( const RLC::Edge& edge, const float start_sec, const int day ) const override {
+        if( !Base::graph->transport->constant_duration( edge.first ) )
+            return std::pair<bool, int>( false, 0 );
+        return Base::graph->min_duration( edge );
+    }
+};
+
+} // end anonymous namespace
+
+struct ArcFlags::RegionSearch
+{
+    // the day is not used by minimal durations
+    RegionSearch( Graph * g ) :
+        bg(g), lower(DRegLCParams(&bg, 0)), upper(DRegLCParams(&bg, 0)),
+        lower_bound(g->num_dfa_vertices() * g->num_transport_vertices(), -1),
+        upper_bound(g->num_dfa_vertices() * g->num_transport_vertices(), -1) {}
+
+    BackwardGraph bg;
+    AspectMinCost<DRegLC> lower;
+    AspectConstantCost<DRegLC> upper;
+    std::vector<int> lower_bound;
+    std::vector<int> upper_bound;
+    std::vector<Vertice> settled;
+    std::vector<Edge> edges;
+};
+
+ArcFlags::ArcFlags( const Transport::Graph * graph, const DFA & dfa, const int region_size, const int threads ) :
+    graph(graph),
+    dfa(dfa),
+    region_size(region_size),
+    region_count((graph->num_vertices() + region_size - 1) / region_size),
+    words_per_region((graph->csr().num_edges() + 63) / 64),
+    flags(region_count * words_per_region, 0)
+{
+    BOOST_ASSERT( region_size > 0 );
+    Graph g( graph, dfa );
+
+    // each region only writes its own flags, each thread keeps its search from one region to the next
+    std::vector< boost::shared_ptr<RegionSearch> > searches( num_threads(threads) );
+    parallel_for( region_count, threads, [&]( const int r, const int t ) {
+        if(!searches[t])
+            searches[t].reset( new RegionSearch( &g ) );
+        flag_region( r, *searches[t] );
+    } );
+}
+
+void ArcFlags::flag_region( const int r, RegionSearch & search )
+{
+    const Transport::CsrGraph & csr = graph->csr();
+    const int n = graph->num_vertices();
+    const int num_states = search.bg.num_dfa_vertices();
+
+    uint64_t * region_flags = &flags[r * words_per_region];
+    const int first = r * region_size;
+    const int last = std::min( n, first + region_size );
+
+    for(int b=first ; b<last ; ++b) {
+        // edges inside the region are always flagged
+        bool is_boundary = false;
+        for(int mode=0 ; mode<Transport::CsrGraph::num_modes ; ++mode) {
+            for(int e=csr.out_begin(b, mode) ; e<csr.out_end(b, mode) ; ++e) {
+                if(region(csr.head[e]) == r)
+                    region_flags[e / 64] |= uint64_t(1) << (e % 64);
+            }
+            for(int i=csr.in_begin(b, mode) ; i<csr.in_end(b, mode) ; ++i)
+                is_boundary = is_boundary || region(csr.tail[csr.in_edge_id[i]]) != r;
+        }
+        if(!is_boundary)
+            continue;
+
+        for(int q=0 ; q<num_states ; ++q) {
+            search.upper.clear();
+            search.upper.add_source_node( Vertice(b, q), 0, 0 );
+            while( !search.upper.finished() ) {
+                const Label lab = search.upper.treat_next();
+                search.upper_bound[lab.node.second * n + lab.node.first] = lab.cost;
+            }
+
+            search.lower.clear();
+            search.lower.add_source_node( Vertice(b, q), 0, 0 );
+            while( !search.lower.finished() ) {
+                const Label lab = search.lower.treat_next();
+                search.lower_bound[lab.node.second * n + lab.node.first] = lab.cost;
+                search.settled.push_back( lab.node );
+            }
+
+            // vertices reached by the upper bounds are also settled by the lower bounds
+            // edges from (u, p) to a settled vertex (v, p') that may start a shortest path to (b, q)
+            for(uint i=0 ; i<search.settled.size() ; ++i) {
+                const Vertice & v = search.settled[i];
+                const int lb_v = search.lower_bound[v.second * n + v.first];
+                if(lb_v < 0)
+                    continue;
+                search.bg.out_edges( v, search.edges );
+                BOOST_FOREACH( const Edge & e, search.edges ) {
+                    const std::pair<bool, int> cost = search.bg.min_duration( e );
+                    const Vertice u = search.bg.target( e );
+                    const int ub_u = search.upper_bound[u.second * n + u.first];
+                    if(cost.first && (ub_u < 0 || cost.second + lb_v <= ub_u))
+                        region_flags[e.first / 64] |= uint64_t(1) << (e.first % 64);
+                }
+            }
+
+            BOOST_FOREACH( const Vertice & v, search.settled ) {
+                search.lower_bound[v.second * n + v.first] = -1;
+                search.upper_bound[v.second * n + v.first] = -1;
+            }
+            search.settled.clear();
+        }
+    }
+}
+
+ArcFlags::ArcFlags( const Transport::Graph * graph, const DFA & dfa, const std::string & filename ) :
+    graph(graph),
+    dfa(dfa)
+{
+    std::ifstream ifile(filename.c_str());
+    if(!ifile)
+        throw std::runtime_error( "Unable to open " + filename );
+    boost::archive::binary_iarchive iArchive(ifile);
+    std::string tag, id;
+    int num_states;
+    DfaEdgeList stored_transitions;
+    iArchive >> tag;
+    if(tag != ARC_FLAGS_ARCHIVE_TAG)
+        throw std::runtime_error( "Not an arc flags file: " + filename );
+    iArchive >> id;
+    if(id != graph->get_id())
+        throw std::runtime_error( "Arc flags of another graph (" + id + "): " + filename );
+    iArchive >> num_states >> stored_transitions;
+    if(num_states != (int) boost::num_vertices( dfa.graph ) || stored_transitions != transitions( dfa ))
+        throw std::runtime_error( "Arc flags of another DFA: " + filename );
+    iArchive >> region_size >> region_count >> words_per_region;
+    iArchive >> flags;
+    // the id names the dump the graph was built from, a rebuilt graph keeps it: the sizes must fit the graph
+    if( region_size <= 0 || words_per_region != (graph->csr().num_edges() + 63) / 64
+        || region_count != (graph->num_vertices() + region_size - 1) / region_size
+        || flags.size() != (size_t) region_count * words_per_region )
+        throw std::runtime_error( "Arc flags inconsistent with the graph: " + filename );
+}
+
+void ArcFlags::save( const std::string & filename ) const
+{
+    std::ofstream ofile(filename.c_str());
+    boost::archive::binary_oarchive oArchive(ofile);
+    const int num_states = boost::num_vertices( dfa.graph );
+    oArchive << ARC_FLAGS_ARCHIVE_TAG;
+    oArchive << graph->get_id();
+    oArchive << num_states << transitions( dfa );
+    oArchive << region_size << region_count << words_per_region;
+    oArchive << flags;
+}
+
+int ArcFlags::num_flags() const
+{
+    int count = 0;
+    BOOST_FOREACH( const uint64_t word, flags ) {
+        count += __builtin_popcountll( word );
+    }
+    return count;
+}
+
+} // end namespace RLC
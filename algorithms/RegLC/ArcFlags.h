@@ -0,0 +1,113 @@
+/** Copyright : Arthur Bit-Monnot (2013)  arthur.bit-monnot@laas.fr
+
+This software is a computer program whose purpose is to [describe
+functionalities and technical features of your software].
+
+This software is governed by the CeCILL-B license under French law and
+abiding by the rules of distribution of free software.  You can  use, 
+modify and/ or redistribute the software under the terms of the CeCILL-B
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info". 
+
+As a counterpart to the access to the source code and  rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty  and the software's author,  the holder of the
+economic rights,  and the successive licensors  have only  limited
+liability. 
+
+In this respect, the user's attention is drawn to the risks associated
+with loading,  using,  modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean  that it is complicated to manipulate,  and  that  also
+therefore means  that it is reserved for developers  and  experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or 
+data to be ensured and,  more generally, to use and operate it in the 
+same conditions as regards security. 
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL-B license and that you accept its terms. 
+*/
+
+#ifndef ARC_FLAGS_H
+#define ARC_FLAGS_H
+
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+#include "reglc_graph.h"
+
+namespace RLC {
+
+/**
+ * Arc flags of the transport graph for the searches following a DFA.
+ *
+ * Nodes are split in regions of `region_size` consecutive ids, that are compact as nodes are numbered along a
+ * Hilbert curve (see Transport::Graph::internal_node). The flag of an edge for a region is set if the edge
+ * may be on a shortest path, starting at any time, to a node of the region.
+ *
+ * Flags are computed by backward searches from every boundary vertex (b, q) of the region, b being a node
+ * with an incoming edge from another region. An edge from (u, p) to (v, p') is flagged if its minimal duration
+ * plus the lower bound from (v, p') does not exceed an upper bound from (u, p), obtained by the edges of
+ * constant duration. With a DFA whose edges all have constant durations, those are the usual arc flags; with
+ * public transport, edges that can only be followed by vehicles keep more flags.
+ */
+class ArcFlags
+{
+public:
+    /**
+     * Computes the flags of every region, spread over `threads` threads (0: one per core)
+     */
+    ArcFlags( const Transport::Graph * graph, const DFA & dfa, const int region_size, const int threads = 0 );
+
+    /**
+     * Loads flags written by save(). They must have been computed on a graph with the same id, with a DFA
+     * having the same states and transitions. Throws std::runtime_error otherwise, or if the sizes of the flags
+     * do not fit the graph, as happens once the graph is rebuilt.
+     */
+    ArcFlags( const Transport::Graph * graph, const DFA & dfa, const std::string & filename );
+
+    void save( const std::string & filename ) const;
+
+    const Transport::Graph * graph;
+    const DFA dfa;
+
+    inline int region( const int node ) const { return node / region_size; }
+
+    inline bool is_set( const int edge, const int region ) const {
+        return (flags[region * words_per_region + edge / 64] >> (edge % 64)) & 1;
+    }
+
+    int num_regions() const { return region_count; }
+
+    /**
+     * Number of regions each edge is flagged for, summed over all edges
+     */
+    int num_flags() const;
+
+private:
+    /**
+     * Searches from the boundary vertices of a region, with their buffers (one per thread)
+     */
+    struct RegionSearch;
+
+    /**
+     * Computes the flags of region r
+     */
+    void flag_region( const int r, RegionSearch & search );
+
+    int region_size;
+    int region_count;
+    int words_per_region;
+
+    /**
+     * Flags of region r are the bits of flags[r * words_per_region ..], by edge
+     */
+    std::vector<uint64_t> flags;
+};
+
+} // end namespace RLC
+
+#endif
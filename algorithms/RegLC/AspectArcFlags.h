@@ -0,0 +1,80 @@
+/** Copyright : Arthur Bit-Monnot (2013)  arthur.bit-monnot@laas.fr
+
+This software is a computer program whose purpose is to [describe
+functionalities and technical features of your software].
+
+This software is governed by the CeCILL-B license under French law and
+abiding by the rules of distribution of free software.  You can  use, 
+modify and/ or redistribute the software under the terms of the CeCILL-B
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info". 
+
+As a counterpart to the access to the source code and  rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty  and the software's author,  the holder of the
+economic rights,  and the successive licensors  have only  limited
+liability. 
+
+In this respect, the user's attention is drawn to the risks associated
+with loading,  using,  modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean  that it is complicated to manipulate,  and  that  also
+therefore means  that it is reserved for developers  and  experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or 
+data to be ensured and,  more generally, to use and operate it in the 
+same conditions as regards security. 
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL-B license and that you accept its terms. 
+*/
+
+#ifndef ASPECT_ARC_FLAGS_H
+#define ASPECT_ARC_FLAGS_H
+
+#include "DRegLC.h"
+#include "ArcFlags.h"
+
+namespace RLC {
+
+struct AspectArcFlagsParams {
+    AspectArcFlagsParams( const ArcFlags * flags, const int target ) : flags(flags), target(target) {}
+    const ArcFlags * flags;
+    const int target;
+};
+
+
+/**
+ * Aspect ignoring the edges whose flag is not set for the region of the target.
+ * 
+ * Only valid for a forward search towards `target` following the DFA the flags were computed with.
+ */
+template<typename Base>
+class AspectArcFlags : public Base {
+public:    
+    typedef LISTPARAM<AspectArcFlagsParams, typename Base::ParamType> ParamType;
+    
+    AspectArcFlags( ParamType parameters ) : Base(parameters.next) {
+        AspectArcFlagsParams & p = parameters.value;
+        flags = p.flags;
+        region = flags->region( p.target );
+        BOOST_ASSERT( Base::graph->forward );
+        BOOST_ASSERT( Base::graph->transport->get_id() == flags->graph->get_id() );
+    }
+    virtual ~AspectArcFlags() {}
+    
+    virtual std::pair <bool, int> duration( const RLC::Edge& edge, const float start_sec, const int day ) const override {
+        if( !flags->is_set( edge.first, region ) )
+            return std::pair<bool, int>( false, 0 );
+        return Base::duration( edge, start_sec, day );
+    }
+    
+private:
+    const ArcFlags * flags;
+    int region;
+};
+
+}
+
+#endif
@@ -47,38 +47,18 @@ template<typename Base>
 class AspectStorePreds : public Base {
 public:    
     typedef typename Base::ParamType ParamType;
-    AspectStorePreds( ParamType parameters ) : Base(parameters) { 
-        has_predecessor = new boost::dynamic_bitset<>*[Base::dfa_num_vert];
-        predecessors = new RLC::Edge*[Base::dfa_num_vert];
-        for(int i=0 ; i<Base::dfa_num_vert ; ++i) {
-            has_predecessor[i] = new boost::dynamic_bitset<>(Base::trans_num_vert);
-            predecessors[i] = (RLC::Edge *) malloc(Base::trans_num_vert * sizeof(RLC::Edge));
-        }
-    }
-    virtual ~AspectStorePreds() {
-        for(int i=0 ; i<Base::dfa_num_vert ; ++i) {
-            delete has_predecessor[i];
-            free( predecessors[i] );
-        }
-        delete[] has_predecessor;
-        delete[] predecessors;
-    }
+    AspectStorePreds( ParamType parameters ) : Base(parameters),
+        // flags are reset with the colours of the workspace, the predecessors are never initialized
+        predecessors( Base::workspace->template buffer<RLC::Edge>() ) {}
     
-    inline void clear_pred(const RLC::Vertice v) { has_predecessor[v.second]->reset(v.first); }
+    inline void clear_pred(const RLC::Vertice v) { Base::workspace->set_has_pred(v, false); }
     inline void set_pred(const RLC::Vertice v, const RLC::Edge & pred) { 
-        has_predecessor[v.second]->set(v.first);
-        predecessors[v.second][v.first] = pred; 
+        Base::workspace->set_has_pred(v, true);
+        predecessors[Base::workspace->slot(v)] = pred; 
     }
 
-    inline RLC::Edge get_pred(const RLC::Vertice v) const { return predecessors[v.second][v.first]; }
-    inline bool has_pred(const RLC::Vertice v) const { return has_predecessor[v.second]->test(v.first); }
-    
-    virtual void clear() override {
-        for(int i=0 ; i<Base::dfa_num_vert ; ++i) {
-            has_predecessor[i]->reset();
-        }
-        Base::clear();
-    }
+    inline RLC::Edge get_pred(const RLC::Vertice v) const { return predecessors[Base::workspace->find(v)]; }
+    inline bool has_pred(const RLC::Vertice v) const { return Base::workspace->has_pred(v); }
     
     virtual bool insert_node_with_predecessor(const Vertice & vert, const int arrival, const int cost, const RLC::Edge & pred, const int source) override
     {
@@ -96,7 +76,7 @@ public:
         
         while( has_pred(curr_node) ) {
             cout << curr_node.first << endl;
-            p.edges.push_back(this->graph->transport->edgeIndex( this->get_pred(curr_node).first ));
+            p.edges.push_back( this->get_pred(curr_node).first );
             curr_node = this->graph->source( this->get_pred( curr_node ) );
         }
         
@@ -106,8 +86,7 @@ public:
     }
 
 private:
-    boost::dynamic_bitset<> ** has_predecessor;
-    RLC::Edge **predecessors;
+    std::vector<RLC::Edge> & predecessors;
 };
 
 }
@@ -93,7 +93,7 @@ public:
             path.push_front(curr.first);
         }
         
-        return path;
+        return std::vector<int>(path.begin(), path.end());
     }
     
     int get_path_cost() const {
@@ -51,7 +51,8 @@ struct AspectTargetLandmarkParams {
  * Aspect implementing an A* search towards a single target.
  * 
  * It needs a heuristic H (default is landmark) to provide a lower bound of the distance 
- * between two vertices in the graph.
+ * between two vertices in the graph. The DFA state of the vertex is given to the heuristic, 
+ * StateLandmarks uses it for searches that are not restricted to a single mode.
  */
 template<typename Base = DRegLC, typename H = Landmark>
 class AspectTargetLandmark : public AspectTarget<Base> 
@@ -83,7 +84,7 @@ public:
     
     virtual Label label(RLC::Vertice vert, int time, int cost, int source = -1) const override {
         Label l = Base::label(vert, time, cost, source);
-        l.h = h->dist_lb( vert.first, target, Base::graph->forward ) * Base::cost_factor;
+        l.h = h->dist_lb( vert, target, Base::graph->forward ) * Base::cost_factor;
         
         BOOST_ASSERT( l.valid() );
         return l;
@@ -0,0 +1,130 @@
+/** Copyright : Arthur Bit-Monnot (2013)  arthur.bit-monnot@laas.fr
+
+This software is a computer program whose purpose is to [describe
+functionalities and technical features of your software].
+
+This software is governed by the CeCILL-B license under French law and
+abiding by the rules of distribution of free software.  You can  use, 
+modify and/ or redistribute the software under the terms of the CeCILL-B
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info". 
+
+As a counterpart to the access to the source code and  rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty  and the software's author,  the holder of the
+economic rights,  and the successive licensors  have only  limited
+liability. 
+
+In this respect, the user's attention is drawn to the risks associated
+with loading,  using,  modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean  that it is complicated to manipulate,  and  that  also
+therefore means  that it is reserved for developers  and  experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or 
+data to be ensured and,  more generally, to use and operate it in the 
+same conditions as regards security. 
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL-B license and that you accept its terms. 
+*/
+
+#include "BidirectionalDRegLC.h"
+#include <stdexcept>
+
+namespace RLC {
+
+BidirectionalDRegLC::Search::Search( const AbstractGraph * graph, const int day, BidirectionalDRegLC & owner, Workspace * workspace ) :
+    AspectStorePreds<DRegLC>( DRegLCParams(graph, day, 1, workspace) ),
+    other(NULL),
+    owner(owner),
+    costs(this->workspace->buffer<MeetingCost>())
+{
+}
+
+bool BidirectionalDRegLC::Search::insert_node_impl( const Label & lab )
+{
+    if( !AspectStorePreds<DRegLC>::insert_node_impl(lab) )
+        return false;
+
+    costs[workspace->find(lab.node)].cost = lab.cost;
+    const int other_cost = other->cost( lab.node );
+    if(other_cost >= 0 && lab.cost + other_cost < owner.best_cost) {
+        owner.best_cost = lab.cost + other_cost;
+        owner.meeting = lab.node;
+    }
+    return true;
+}
+
+
+BidirectionalDRegLC::BidirectionalDRegLC( Graph * graph, const int day, const int source, const int target, const int departure_time,
+                                          Workspace * forward_workspace, Workspace * backward_workspace ) :
+    count(0),
+    backward_graph(graph),
+    source(source),
+    target(target),
+    forward(graph, day, *this, forward_workspace),
+    backward(&backward_graph, day, *this, backward_workspace),
+    best_cost(std::numeric_limits<int>::max())
+{
+    if(graph->dfa.accepts_public_transport())
+        throw std::invalid_argument( "Bidirectional search with a public transport DFA" );
+
+    forward.other = &backward;
+    backward.other = &forward;
+
+    BOOST_FOREACH( const int state, graph->dfa_start_states() ) {
+        forward.add_source_node( Vertice(source, state), departure_time, 0 );
+    }
+    BOOST_FOREACH( const int state, graph->dfa_accepting_states() ) {
+        backward.add_source_node( Vertice(target, state), departure_time, 0 );
+    }
+}
+
+bool BidirectionalDRegLC::run()
+{
+    bool forward_turn = true;
+    while( !forward.finished() && !backward.finished() ) {
+        // no itinerary through a vertex that is still to be settled can be better
+        if(forward.best_cost_in_heap() + backward.best_cost_in_heap() >= best_cost)
+            break;
+
+        Search & search = forward_turn ? forward : backward;
+        search.treat_next();
+        ++count;
+        forward_turn = !forward_turn;
+    }
+    return best_cost != std::numeric_limits<int>::max();
+}
+
+int BidirectionalDRegLC::cost() const
+{
+    return best_cost == std::numeric_limits<int>::max() ? -1 : best_cost;
+}
+
+Path BidirectionalDRegLC::get_path() const
+{
+    Path p;
+    p.start_node = source;
+    p.end_node = target;
+    if(cost() < 0)
+        return p;
+
+    Vertice curr = meeting;
+    while( forward.has_pred(curr) ) {
+        const RLC::Edge pred = forward.get_pred( curr );
+        p.edges.push_front( pred.first );
+        curr = backward_graph.forward_graph->source( pred );
+    }
+
+    curr = meeting;
+    while( backward.has_pred(curr) ) {
+        const RLC::Edge pred = backward.get_pred( curr );
+        p.edges.push_back( pred.first );
+        curr = backward_graph.source( pred );
+    }
+    return p;
+}
+
+} // end namespace RLC
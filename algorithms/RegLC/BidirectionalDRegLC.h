@@ -0,0 +1,123 @@
+/** Copyright : Arthur Bit-Monnot (2013)  arthur.bit-monnot@laas.fr
+
+This software is a computer program whose purpose is to [describe
+functionalities and technical features of your software].
+
+This software is governed by the CeCILL-B license under French law and
+abiding by the rules of distribution of free software.  You can  use, 
+modify and/ or redistribute the software under the terms of the CeCILL-B
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info". 
+
+As a counterpart to the access to the source code and  rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty  and the software's author,  the holder of the
+economic rights,  and the successive licensors  have only  limited
+liability. 
+
+In this respect, the user's attention is drawn to the risks associated
+with loading,  using,  modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean  that it is complicated to manipulate,  and  that  also
+therefore means  that it is reserved for developers  and  experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or 
+data to be ensured and,  more generally, to use and operate it in the 
+same conditions as regards security. 
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL-B license and that you accept its terms. 
+*/
+
+#ifndef BIDIRECTIONAL_DREGLC_H
+#define BIDIRECTIONAL_DREGLC_H
+
+#include <vector>
+#include <limits>
+
+#include "DRegLC.h"
+#include "AspectStorePreds.h"
+
+namespace RLC {
+
+/**
+ * Point to point DRegLC searching from both ends of the itinerary.
+ *
+ * A forward DRegLC from the source and a backward one (on a BackwardGraph) from the target in every accepting
+ * state are run alternately. The two searches meet on a vertex of the product graph: the node and the DFA state
+ * must both match. The best itinerary through a vertex labelled by both searches is kept, and the search stops
+ * once the sum of the minimum costs in the two heaps is no better.
+ *
+ * The backward search does not know the arrival time, this is hence only exact when the durations of the edges
+ * accepted by the DFA do not depend on time (car_dfa, bike_dfa, foot_dfa).
+ */
+class BidirectionalDRegLC
+{
+public:
+    /**
+     * The workspaces of the two searches (see WorkspacePool) are optional, each search creates its own otherwise.
+     * Throws std::invalid_argument if the DFA accepts public transport (see DFA::accepts_public_transport).
+     */
+    BidirectionalDRegLC( Graph * graph, const int day, const int source, const int target, const int departure_time = 0,
+                         Workspace * forward_workspace = NULL, Workspace * backward_workspace = NULL );
+
+    /**
+     * Returns true if the target was reached
+     */
+    bool run();
+
+    /**
+     * Cost of the best itinerary, -1 if the target was not reached
+     */
+    int cost() const;
+
+    Path get_path() const;
+
+    /**
+     * Number of vertices settled by both searches
+     */
+    int count;
+
+private:
+    class Search : public AspectStorePreds<DRegLC>
+    {
+    public:
+        Search( const AbstractGraph * graph, const int day, BidirectionalDRegLC & owner, Workspace * workspace );
+
+        /**
+         * Records the cost of every labelled vertex and checks it against the other search
+         */
+        virtual bool insert_node_impl( const Label & lab ) override;
+
+        inline int cost( const Vertice & v ) const { return white(v) ? -1 : costs[workspace->find(v)].cost; }
+
+        const Search * other;
+
+    private:
+        BidirectionalDRegLC & owner;
+
+        struct MeetingCost {
+            int cost;
+        };
+
+        /**
+         * Best known cost of each labelled vertex, in a buffer of the workspace
+         */
+        std::vector<MeetingCost> & costs;
+    };
+
+    BackwardGraph backward_graph;
+    const int source;
+    const int target;
+
+    Search forward;
+    Search backward;
+
+    int best_cost;
+    Vertice meeting;
+};
+
+} // end namespace RLC
+
+#endif
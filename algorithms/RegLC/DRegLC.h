@@ -33,14 +33,16 @@ knowledge of the CeCILL-B license and that you accept its terms.
 #ifndef DREGLC_H
 #define DREGLC_H
 
-#include <boost/heap/fibonacci_heap.hpp>
-#include <boost/heap/d_ary_heap.hpp>
 #include <boost/foreach.hpp> 
 #include <boost/dynamic_bitset.hpp>
+#include <boost/scoped_ptr.hpp>
+#include <type_traits>
 
 #include "utils.h"
 #include "reglc_graph.h"
 #include "LabelSettingAlgo.h"
+#include "DRegQueue.h"
+#include "Workspace.h"
 
 using std::cout;
 using std::cerr;
@@ -52,33 +54,72 @@ namespace RLC {
 
 
 struct DRegLCParams {
-    DRegLCParams( const AbstractGraph * graph, const int day, const int cost_factor = 1 ) : 
+    DRegLCParams( const AbstractGraph * graph, const int day, const int cost_factor = 1, Workspace * workspace = NULL ) : 
     graph(graph), 
     day(day),
-    cost_factor(cost_factor) {}
+    cost_factor(cost_factor),
+    workspace(workspace),
+    mode(Workspace::Dense) {}
+    
+    DRegLCParams( const AbstractGraph * graph, const int day, const int cost_factor, const Workspace::Mode mode ) : 
+    graph(graph), 
+    day(day),
+    cost_factor(cost_factor),
+    workspace(NULL),
+    mode(mode) {}
     
     const AbstractGraph * graph;
     const int day;
     const int cost_factor;
+    
+    /**
+     * Workspace of the graph the search is run on (see WorkspacePool), none to give the search its own
+     */
+    Workspace * const workspace;
+    
+    /**
+     * Mode of the workspace the search creates: Sparse for the searches expected to stay local
+     */
+    const Workspace::Mode mode;
 };
 
-    
-// typedef boost::heap::fibonacci_heap<RLC::Vertice, boost::heap::compare<DRegCompare> > DRegHeap;
-typedef boost::heap::d_ary_heap<
-    Label, 
-    boost::heap::arity<4>,
-    boost::heap::mutable_<true> > DRegHeap;
 
 
 /**
  * Implementation of DRegLC defined by Barret & al.
+ *
+ * The priority queue is a policy (see DRegQueue.h): DRegLC uses a d-ary heap, LazyDRegLC a binary heap without
+ * handles and RadixDRegLC a radix heap.
+ *
+ * The state of the vertices lives in a workspace (see Workspace.h), so that neither the construction nor clear()
+ * go over all the vertices.
+ *
+ * The search loop calls the methods aspects override through self(): with Self = void this is a virtual call,
+ * with the final class StaticDRegLC it is resolved at compile time.
  */
-class DRegLC : public LabelSettingAlgo
+template<typename Queue, typename Self = void>
+class BasicDRegLC : public LabelSettingAlgo
 {
+    typedef typename std::conditional<std::is_void<Self>::value, BasicDRegLC, Self>::type Derived;
+    inline Derived & self() { return static_cast<Derived &>(*this); }
+    inline const Derived & self() const { return static_cast<const Derived &>(*this); }
+
+protected:
+    /**
+     * Workspace created by the search when none was given in the parameters
+     */
+    boost::scoped_ptr<Workspace> own_workspace;
+    Workspace * workspace;
+
 public:
     typedef LISTPARAM<DRegLCParams> ParamType;
 
-    DRegLC( ParamType parameters ) :
+    BasicDRegLC( ParamType parameters ) :
+    own_workspace( parameters.value.workspace == NULL ?
+                   new Workspace( parameters.value.graph->num_transport_vertices(), parameters.value.graph->num_dfa_vertices(),
+                                  parameters.value.mode ) : NULL ),
+    workspace( parameters.value.workspace == NULL ? own_workspace.get() : parameters.value.workspace ),
+    heap( *workspace ),
     success( false )
     {
         DRegLCParams & p = parameters.value;
@@ -89,36 +130,21 @@ public:
         
         trans_num_vert = graph->num_transport_vertices();
         dfa_num_vert = graph->num_dfa_vertices();
+        BOOST_ASSERT( workspace->trans_num_vert == trans_num_vert && workspace->dfa_num_vert == dfa_num_vert );
         
-        references = new DRegHeap::handle_type*[dfa_num_vert];
-        status = new uint*[dfa_num_vert];
-        for(int i=0 ; i<dfa_num_vert ; ++i) {
-            references[i] = new DRegHeap::handle_type[trans_num_vert];
-            status[i] = new uint[trans_num_vert];
-
-            // all vertices are white
-            memset(status[i], 0, trans_num_vert * sizeof(status[0][0]));
-        }
+        // all vertices are white
+        workspace->reset();
     }
-    DRegLC() : trans_num_vert(0), dfa_num_vert(0) {}
+    BasicDRegLC() : own_workspace( new Workspace(0, 0) ), workspace( own_workspace.get() ), heap( *workspace ),
+    trans_num_vert(0), dfa_num_vert(0) {}
     
     
-    virtual ~DRegLC()
-    {
-        for(int i=0 ; i<dfa_num_vert ; ++i) {
-            delete[] references[i];
-            delete[] status[i];
-        }
-        delete[] references;
-        delete[] status;
-    }
+    virtual ~BasicDRegLC() {}
     
     virtual void clear() {
         heap.clear();
-        for(int i=0 ; i<dfa_num_vert ; ++i) {
-            // all vertices are white
-            memset(status[i], 0, trans_num_vert * sizeof(status[0][0]));
-        }
+        // all vertices are white
+        workspace->reset();
         success = false;
     }
     
@@ -134,9 +160,9 @@ public:
      */
     virtual bool run() override
     {    
-        while( !finished() ) 
+        while( !self().finished() ) 
         {
-            treat_next();
+            self().treat_next();
         }
             
         return success;
@@ -151,13 +177,13 @@ public:
         heap.pop();
         set_black(curr.node);
         
-        if( check_termination(curr) ) {
+        if( self().check_termination(curr) ) {
             success = true;
             return curr;
         }
         
-        std::list<RLC::Edge> n_out_edges = graph->out_edges(curr.node);
-        BOOST_FOREACH(RLC::Edge e, n_out_edges) 
+        graph->out_edges(curr.node, n_out_edges);
+        BOOST_FOREACH(const RLC::Edge & e, n_out_edges) 
         {
             RLC::Vertice target = graph->target(e);
             BOOST_ASSERT( target.first < graph->num_transport_vertices() );
@@ -165,7 +191,7 @@ public:
             
             bool has_traffic;
             int edge_cost;
-            boost::tie(has_traffic, edge_cost) = duration(e, curr.time, day);
+            boost::tie(has_traffic, edge_cost) = self().duration(e, curr.time, day);
 
             int target_cost = curr.cost + edge_cost * cost_factor;
             
@@ -182,9 +208,9 @@ public:
             if(has_traffic) {
                 BOOST_ASSERT( edge_cost >= 0 );
                 BOOST_ASSERT( target_cost >= 0 );
-                BOOST_ASSERT( (edge_cost * cost_factor - (curr.cost + curr.h)  + (target_cost + label(target, target_arr, target_cost).h) >= 0) );
+                BOOST_ASSERT( (edge_cost * cost_factor - (curr.cost + curr.h)  + (target_cost + self().label(target, target_arr, target_cost).h) >= 0) );
                 
-                insert_node_with_predecessor(target, target_arr, target_cost, e, curr.source);
+                self().insert_node_with_predecessor(target, target_arr, target_cost, e, curr.source);
             }
         }
         return curr;
@@ -196,11 +222,11 @@ public:
      */
     virtual bool insert_node_with_predecessor(const Vertice & vert, const int arrival, const int cost, const RLC::Edge & pred, const int source)
     {
-        return insert_node( vert, arrival, cost, source );
+        return self().insert_node( vert, arrival, cost, source );
     }
     
     virtual bool insert_node(const Vertice & vert, const int arrival, const int vert_cost, const int source) override {
-        return insert_node_impl(label(vert, arrival, vert_cost, source));
+        return self().insert_node_impl(self().label(vert, arrival, vert_cost, source));
     }
     
     virtual bool insert_node_impl(const Label & lab)
@@ -215,13 +241,10 @@ public:
             
             return true;
         }
-        else if ( grey(lab.node) && lab.cost < (*handle(lab.node)).cost )
+        else if ( grey(lab.node) && lab.cost < heap.cost(lab.node) )
         {
-            BOOST_ASSERT( (*handle(lab.node)).node == lab.node );
-            (*handle(lab.node)) = lab;
-            BOOST_ASSERT( (*handle(lab.node)).cost == lab.cost );
-            
-            heap.update(handle(lab.node));
+            heap.decrease(lab);
+            BOOST_ASSERT( heap.cost(lab.node) == lab.cost );
 
             return true;
         }
@@ -250,23 +273,21 @@ public:
     /**
      * Heap in which the Vertices will be stored
      */
-    DRegHeap heap;
+    Queue heap;
     
     virtual inline int best_cost_in_heap() { 
-        Label best = heap.top();
+        const Label & best = heap.top();
         return best.cost + best.h; 
     }
     
-    inline void put_dij_node(const Label l) { references[l.node.second][l.node.first] = heap.push(l); }
+    inline void put_dij_node(const Label l) { heap.push(l); }
     
-    inline DRegHeap::handle_type handle(const RLC::Vertice v) const { return references[v.second][v.first]; }
-    
-    inline bool white(const RLC::Vertice v) const { return status[v.second][v.first] == 0; }
-    inline bool grey(const RLC::Vertice v) const { return status[v.second][v.first] == 1; }
-    inline bool black(const RLC::Vertice v) const { return status[v.second][v.first] == 2; }
-    inline void set_white(const RLC::Vertice v) { status[v.second][v.first] = 0; }
-    inline void set_grey(const RLC::Vertice v) { status[v.second][v.first] = 1; }
-    inline void set_black(const RLC::Vertice v) { status[v.second][v.first] = 2; }
+    inline bool white(const RLC::Vertice v) const { return workspace->status(v) == 0; }
+    inline bool grey(const RLC::Vertice v) const { return workspace->status(v) == 1; }
+    inline bool black(const RLC::Vertice v) const { return workspace->status(v) == 2; }
+    inline void set_white(const RLC::Vertice v) { workspace->set_status(v, 0); }
+    inline void set_grey(const RLC::Vertice v) { workspace->set_status(v, 1); }
+    inline void set_black(const RLC::Vertice v) { workspace->set_status(v, 2); }
     
     
     bool success;
@@ -285,13 +306,34 @@ protected:
     int day;
     int cost_factor;
     
-    DRegHeap::handle_type **references;
-    uint **status; //TODO : very big for only two bits ...
+    /**
+     * Buffer for the out edges of the node being expanded, reused to avoid an allocation per node
+     */
+    std::vector<RLC::Edge> n_out_edges;
 };
 
+typedef BasicDRegLC<DAryQueue> DRegLC;
+typedef BasicDRegLC<LazyQueue> LazyDRegLC;
+typedef BasicDRegLC<RadixQueue> RadixDRegLC;
 
+/**
+ * DRegLC with its aspects composed at compile time. `Aspects` is an alias template applying them to a base:
+ *
+ *     template<typename B> using TargetPreds = AspectStorePreds<AspectTarget<B>>;
+ *     StaticDRegLC<TargetPreds> dij( params );
+ *
+ * The class being final, the calls of the search loop to the methods the aspects override are not virtual and
+ * can be inlined. It is still a LabelSettingAlgo for the code that handles searches through that interface.
+ */
+template<template<typename> class Aspects, typename Queue = DAryQueue>
+class StaticDRegLC final : public Aspects< BasicDRegLC< Queue, StaticDRegLC<Aspects, Queue> > >
+{
+public:
+    typedef Aspects< BasicDRegLC< Queue, StaticDRegLC<Aspects, Queue> > > Base;
+    typedef typename Base::ParamType ParamType;
 
-
+    StaticDRegLC( ParamType parameters ) : Base(parameters) {}
+};
 
 } // end namespace RLC
 
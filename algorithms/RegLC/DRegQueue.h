@@ -0,0 +1,290 @@
+/** Copyright : Arthur Bit-Monnot (2013)  arthur.bit-monnot@laas.fr
+
+This software is a computer program whose purpose is to [describe
+functionalities and technical features of your software].
+
+This software is governed by the CeCILL-B license under French law and
+abiding by the rules of distribution of free software.  You can  use, 
+modify and/ or redistribute the software under the terms of the CeCILL-B
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info". 
+
+As a counterpart to the access to the source code and  rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty  and the software's author,  the holder of the
+economic rights,  and the successive licensors  have only  limited
+liability. 
+
+In this respect, the user's attention is drawn to the risks associated
+with loading,  using,  modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean  that it is complicated to manipulate,  and  that  also
+therefore means  that it is reserved for developers  and  experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or 
+data to be ensured and,  more generally, to use and operate it in the 
+same conditions as regards security. 
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL-B license and that you accept its terms. 
+*/
+
+#ifndef DREG_QUEUE_H
+#define DREG_QUEUE_H
+
+#include <vector>
+#include <algorithm>
+#include <queue>
+#include <limits>
+#include <boost/heap/d_ary_heap.hpp>
+#include <boost/foreach.hpp>
+
+#include "LabelSettingAlgo.h"
+#include "Workspace.h"
+
+namespace RLC {
+
+/**
+ * Priority queues of DRegLC. A queue holds at most one label per vertex, ordered by cost + h, and provides:
+ *  - push(label) for a vertex that is not in the queue,
+ *  - cost(vertex), the cost of the label of a vertex in the queue,
+ *  - decrease(label), replacing the label of a vertex in the queue by one with a lower cost,
+ *  - top(), pop(), empty() and clear().
+ *
+ * Queues are built on the workspace of the search, from which they take their per vertex arrays.
+ */
+
+typedef boost::heap::d_ary_heap<
+    Label,
+    boost::heap::arity<4>,
+    boost::heap::mutable_<true> > DRegHeap;
+
+/**
+ * Mutable 4-ary heap, a handle being kept for each vertex to update its label
+ */
+class DAryQueue
+{
+public:
+    DAryQueue( Workspace & workspace ) :
+    workspace(workspace),
+    references(workspace.buffer<DRegHeap::handle_type>()) {}
+
+    inline void push( const Label & l ) { references[workspace.slot(l.node)] = heap.push(l); }
+
+    inline int cost( const Vertice & v ) const { return (*references[workspace.find(v)]).cost; }
+
+    inline void decrease( const Label & l ) {
+        DRegHeap::handle_type handle = references[workspace.find(l.node)];
+        BOOST_ASSERT( (*handle).node == l.node );
+        (*handle) = l;
+        heap.update(handle);
+    }
+
+    inline const Label & top() const { return heap.top(); }
+    inline void pop() { heap.pop(); }
+    inline bool empty() const { return heap.empty(); }
+    inline void clear() { heap.clear(); }
+
+private:
+    DAryQueue( const DAryQueue & );
+    DAryQueue & operator=( const DAryQueue & );
+
+    Workspace & workspace;
+    DRegHeap heap;
+    std::vector<DRegHeap::handle_type> & references;
+};
+
+/**
+ * Cost of the current label of each vertex for the queues without handles, where a decrease adds a new entry
+ * and leaves the previous one in the queue. An entry is outdated if the cost of its vertex changed since it was
+ * added, or if the vertex was popped (cost -1).
+ *
+ * The array of the workspace is not initialized: DRegLC only asks for the cost of a vertex in the queue.
+ */
+class QueueCosts
+{
+public:
+    QueueCosts( Workspace & workspace ) :
+    workspace(workspace),
+    costs(workspace.buffer<int>()) {}
+
+    inline int get( const Vertice & v ) const { return costs[workspace.find(v)]; }
+    inline void set( const Vertice & v, const int cost ) { costs[workspace.slot(v)] = cost; }
+    inline bool outdated( const Label & l ) const { return costs[workspace.find(l.node)] != l.cost; }
+
+private:
+    Workspace & workspace;
+    std::vector<int> & costs;
+};
+
+/**
+ * Binary heap with lazy deletion: a decrease pushes the new label and the outdated one is dropped when it comes out
+ */
+class LazyQueue
+{
+public:
+    LazyQueue( Workspace & workspace ) :
+    costs(workspace),
+    size(0) {}
+
+    inline void push( const Label & l ) {
+        ++size;
+        decrease( l );
+    }
+
+    inline int cost( const Vertice & v ) const { return costs.get(v); }
+
+    inline void decrease( const Label & l ) {
+        costs.set( l.node, l.cost );
+        heap.push( l );
+    }
+
+    inline const Label & top() {
+        drop_outdated();
+        return heap.top();
+    }
+
+    inline void pop() {
+        drop_outdated();
+        costs.set( heap.top().node, -1 );
+        heap.pop();
+        --size;
+    }
+
+    inline bool empty() const { return size == 0; }
+
+    inline void clear() {
+        heap = std::priority_queue<Label>();
+        size = 0;
+    }
+
+private:
+    inline void drop_outdated() {
+        BOOST_ASSERT( size > 0 );
+        while( costs.outdated(heap.top()) )
+            heap.pop();
+    }
+
+    QueueCosts costs;
+
+    /**
+     * Label::operator< puts the lowest cost + h on top
+     */
+    std::priority_queue<Label> heap;
+
+    /**
+     * Number of vertices in the queue, outdated entries excluded
+     */
+    int size;
+};
+
+/**
+ * Monotone radix heap of Ahuja & al., with lazy deletion as LazyQueue.
+ *
+ * Keys are unsigned integers that never go below the last key popped, which holds as long as the heuristic
+ * of the labels is consistent (the assertion of DRegLC::treat_next). An entry goes to the bucket of the highest
+ * bit in which its key differs from the last key popped; when the first bucket is empty, the next non empty
+ * bucket is redistributed around its minimum, each entry moving to a lower bucket.
+ *
+ * With an inconsistent heuristic (stale landmarks, arc flags combined with a heuristic...) a key can be lower
+ * than the last key popped. It is then raised to that key, which puts the entry on top of the queue as a binary
+ * heap would, instead of in a bucket that does not match its key.
+ */
+class RadixQueue
+{
+public:
+    RadixQueue( Workspace & workspace ) :
+    costs(workspace),
+    last(0),
+    size(0) {}
+
+    inline void push( const Label & l ) {
+        ++size;
+        decrease( l );
+    }
+
+    inline int cost( const Vertice & v ) const { return costs.get(v); }
+
+    inline void decrease( const Label & l ) {
+        const Entry e = { std::max( key(l), last ), l };
+        costs.set( l.node, l.cost );
+        buckets[bucket(e.key)].push_back( e );
+    }
+
+    inline const Label & top() {
+        refill();
+        return buckets[0].back().label;
+    }
+
+    inline void pop() {
+        refill();
+        costs.set( buckets[0].back().label.node, -1 );
+        buckets[0].pop_back();
+        --size;
+    }
+
+    inline bool empty() const { return size == 0; }
+
+    inline void clear() {
+        for(int b=0 ; b<NUM_BUCKETS ; ++b)
+            buckets[b].clear();
+        last = 0;
+        size = 0;
+    }
+
+private:
+    static const int NUM_BUCKETS = std::numeric_limits<unsigned int>::digits + 1;
+
+    struct Entry {
+        unsigned int key;
+        Label label;
+    };
+
+    inline static unsigned int key( const Label & l ) { return l.cost + l.h; }
+    inline bool outdated( const Entry & e ) const { return costs.outdated( e.label ); }
+
+    inline int bucket( const unsigned int key ) const {
+        return key == last ? 0 : std::numeric_limits<unsigned int>::digits - __builtin_clz(key ^ last);
+    }
+
+    /**
+     * Makes sure that the last entry of the first bucket is a valid one
+     */
+    void refill() {
+        BOOST_ASSERT( size > 0 );
+        for(;;) {
+            while( !buckets[0].empty() && outdated(buckets[0].back()) )
+                buckets[0].pop_back();
+            if( !buckets[0].empty() )
+                return;
+
+            int b = 1;
+            while( buckets[b].empty() )
+                ++b;
+            BOOST_ASSERT( b < NUM_BUCKETS );
+
+            unsigned int min_key = std::numeric_limits<unsigned int>::max();
+            BOOST_FOREACH( const Entry & e, buckets[b] ) {
+                if( !outdated(e) && e.key < min_key )
+                    min_key = e.key;
+            }
+            if( min_key != std::numeric_limits<unsigned int>::max() )
+                last = min_key;
+            BOOST_FOREACH( const Entry & e, buckets[b] ) {
+                if( !outdated(e) )
+                    buckets[bucket(e.key)].push_back( e );
+            }
+            buckets[b].clear();
+        }
+    }
+
+    QueueCosts costs;
+    std::vector<Entry> buckets[NUM_BUCKETS];
+    unsigned int last;
+    int size;
+};
+
+} // end namespace RLC
+
+#endif
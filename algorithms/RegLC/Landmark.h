@@ -38,6 +38,7 @@ knowledge of the CeCILL-B license and that you accept its terms.
 #include <boost/concept_check.hpp>
 #include <limits>
 #include <graph_wrapper.h>
+#include "reglc_graph.h"
 #include "Area.h"
 
 #define INF (std::numeric_limits<int>::max() / 3)
@@ -87,6 +88,13 @@ public:
     void set_hminus( const int node, const int dist ) {  hminus[node] = dist; }
     
     
+    /**
+     * Returns a lower bound of the distance between source and target, the DFA state is ignored
+     */
+    int dist_lb( const Vertice & source, const int target, const bool is_forward ) const {
+        return dist_lb( source.first, target, is_forward );
+    }
+    
     /**
      * Returns a lower bound of the distance between source and target
      */
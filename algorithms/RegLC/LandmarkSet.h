@@ -71,6 +71,13 @@ public:
         }
     }
     
+    /**
+     * Lower bound of the distance between source and target, the DFA state is ignored
+     */
+    int dist_lb( const Vertice & source, const int target, const bool is_forward ) const {
+        return dist_lb( source.first, target, is_forward );
+    }
+    
     int dist_lb( const int source, const int target, const bool is_forward ) const {
         int best = 0;
         int * p_pot_src = potentials + potential_index(source, 0);
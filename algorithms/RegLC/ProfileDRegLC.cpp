@@ -0,0 +1,272 @@
+/** Copyright : Arthur Bit-Monnot (2013)  arthur.bit-monnot@laas.fr
+
+This software is a computer program whose purpose is to [describe
+functionalities and technical features of your software].
+
+This software is governed by the CeCILL-B license under French law and
+abiding by the rules of distribution of free software.  You can  use, 
+modify and/ or redistribute the software under the terms of the CeCILL-B
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info". 
+
+As a counterpart to the access to the source code and  rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty  and the software's author,  the holder of the
+economic rights,  and the successive licensors  have only  limited
+liability. 
+
+In this respect, the user's attention is drawn to the risks associated
+with loading,  using,  modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean  that it is complicated to manipulate,  and  that  also
+therefore means  that it is reserved for developers  and  experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or 
+data to be ensured and,  more generally, to use and operate it in the 
+same conditions as regards security. 
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL-B license and that you accept its terms. 
+*/
+
+#include "ProfileDRegLC.h"
+
+#include <boost/foreach.hpp>
+#include <algorithm>
+#include <limits>
+
+namespace RLC {
+
+namespace {
+
+inline bool by_departure( const ProfileEntry & a, const ProfileEntry & b )
+{
+    return a.first_departure < b.first_departure || (a.first_departure == b.first_departure && a.last_departure < b.last_departure);
+}
+
+} // end anonymous namespace
+
+ProfileDRegLC::ProfileDRegLC( const AbstractGraph * graph, const int day, const int earliest, const int latest, const int target ) :
+    count(0), bound(std::numeric_limits<int>::max()), graph(graph), day(day), earliest(earliest), latest(latest), target(target),
+    num_transport_vertices(graph->num_transport_vertices()),
+    lines(graph->transport->day_timetable(day)),
+    slots(graph->num_transport_vertices() * graph->num_dfa_vertices(), -1)
+{
+    BOOST_ASSERT( graph->forward );
+    BOOST_ASSERT( earliest <= latest );
+    BOOST_FOREACH( const int state, graph->dfa_accepting_states() ) {
+        target_vertices.push_back( Vertice(target, state) );
+    }
+}
+
+void ProfileDRegLC::add_source_node( const Vertice & vert )
+{
+    Piece piece;
+    piece.begin = earliest;
+    piece.end = latest;
+    piece.duration = 0;
+    piece.parent = -1;
+    piece.edge = -1;
+    piece.node = vert.first;
+    piece.alive = true;
+    insert( vert, piece );
+}
+
+int ProfileDRegLC::slot( const Vertice & vert )
+{
+    int & s = slots[vert.second * num_transport_vertices + vert.first];
+    if(s < 0) {
+        s = profiles.size();
+        profiles.push_back( VertexProfile() );
+        slot_vertices.push_back( vert );
+    }
+    return s;
+}
+
+bool ProfileDRegLC::dominates( const Piece & p, const Piece & q ) const
+{
+    if(p.end < q.end)
+        return false;
+
+    // the difference of the two functions is linear between those departures
+    const int departures[] = { earliest, q.end, p.begin, q.begin };
+    BOOST_FOREACH( const int t, departures ) {
+        if(t >= earliest && t <= q.end && arrival(p, t) > arrival(q, t))
+            return false;
+    }
+    return true;
+}
+
+void ProfileDRegLC::insert( const Vertice & vert, const Piece & piece )
+{
+    ++count;
+    // useless if it cannot do better than the target
+    BOOST_FOREACH( const Vertice & v, target_vertices ) {
+        const int s = slots[v.second * num_transport_vertices + v.first];
+        if(s < 0)
+            continue;
+        BOOST_FOREACH( const int i, profiles[s].pieces ) {
+            if(pieces[i].alive && dominates(pieces[i], piece))
+                return;
+        }
+    }
+
+    const int s = slot( vert );
+    std::vector<int> & vertex_pieces = profiles[s].pieces;
+    BOOST_FOREACH( const int i, vertex_pieces ) {
+        if(pieces[i].alive && dominates(pieces[i], piece))
+            return;
+    }
+
+    uint kept = 0;
+    for(uint i=0 ; i<vertex_pieces.size() ; ++i) {
+        Piece & other = pieces[vertex_pieces[i]];
+        if(other.alive && dominates(piece, other))
+            other.alive = false;
+        if(other.alive)
+            vertex_pieces[kept++] = vertex_pieces[i];
+    }
+    vertex_pieces.resize( kept );
+
+    if(vert.first == target && graph->is_accepting(vert) && piece.end >= latest)
+        bound = std::min( bound, arrival(piece, latest) );
+    vertex_pieces.push_back( pieces.size() );
+    profiles[s].pending.push_back( pieces.size() );
+    pieces.push_back( piece );
+    queue.push( QueueItem(piece.begin + piece.duration, s) );
+}
+
+void ProfileDRegLC::run()
+{
+    while( !queue.empty() ) {
+        const QueueItem curr = queue.top();
+        queue.pop();
+        // every arrival left is later than the one at the target for any departure
+        if(curr.first >= bound)
+            break;
+        scan( curr.second );
+    }
+}
+
+void ProfileDRegLC::scan( const int s )
+{
+    std::vector<int> pending;
+    pending.swap( profiles[s].pending );
+    if(pending.empty())
+        return;
+
+    graph->out_edges( slot_vertices[s], n_out_edges );
+    BOOST_FOREACH( const RLC::Edge & e, n_out_edges ) {
+        BOOST_FOREACH( const int i, pending ) {
+            if(pieces[i].alive)
+                relax( i, e );
+        }
+    }
+}
+
+void ProfileDRegLC::relax( const int i, const RLC::Edge & edge )
+{
+    const Transport::Graph * transport = graph->transport;
+    const Vertice next = graph->target( edge );
+
+    Piece piece;
+    piece.parent = i;
+    piece.edge = edge.first;
+    piece.node = next.first;
+    piece.alive = true;
+
+    // the piece is copied since inserting can reallocate the pieces
+    const Piece p = pieces[i];
+    const int index = transport->timetable_index( edge.first );
+    if(index >= 0) {
+        if(!lines)
+            return;
+        // one piece per line that can be caught, up to the first one leaving after the latest arrival
+        int first = lines->begin( index );
+        int last = lines->end( index );
+        const int ready = p.begin + p.duration;
+        while(first < last) {
+            const int middle = (first + last) / 2;
+            if(lines->departure( middle ) < ready)
+                first = middle + 1;
+            else
+                last = middle;
+        }
+        for(int l=first ; l<lines->end( index ) ; ++l) {
+            piece.begin = piece.end = std::min( p.end, lines->departure( l ) - p.duration );
+            piece.duration = lines->arrival( l ) - piece.begin;
+            insert( next, piece );
+            if(lines->departure( l ) > p.end + p.duration)
+                break;
+        }
+    } else if(transport->frequency_windows( edge.first, day, windows )) {
+        // as in Graph::duration, a window is used from the end of the ones starting before it and is not waited for
+        int reach = std::numeric_limits<int>::min();
+        BOOST_FOREACH( const Transport::FrequencyEntry & f, windows ) {
+            const int first = std::max( p.begin, std::max( f.start, reach ) - p.duration );
+            const int last = std::min( p.end, f.end - 1 - p.duration );
+            reach = std::max( reach, f.end );
+            if(first > last)
+                continue;
+            piece.begin = first;
+            piece.end = last;
+            piece.duration = p.duration + f.duration;
+            insert( next, piece );
+        }
+    } else {
+        bool has_traffic;
+        int duration;
+        boost::tie(has_traffic, duration) = graph->duration( edge, p.begin, day );
+        if(!has_traffic)
+            return;
+        piece.begin = p.begin;
+        piece.end = p.end;
+        piece.duration = p.duration + duration;
+        insert( next, piece );
+    }
+}
+
+std::vector<ProfileEntry> ProfileDRegLC::profile() const
+{
+    std::vector<int> reached;
+    BOOST_FOREACH( const Vertice & v, target_vertices ) {
+        const int s = slots[v.second * num_transport_vertices + v.first];
+        if(s < 0)
+            continue;
+        BOOST_FOREACH( const int i, profiles[s].pieces ) {
+            if(pieces[i].alive)
+                reached.push_back( i );
+        }
+    }
+
+    // pieces reaching the target in different states might dominate each other, identical ones are kept once
+    std::vector<int> best;
+    for(uint i=0 ; i<reached.size() ; ++i) {
+        bool dominated = false;
+        for(uint j=0 ; j<reached.size() && !dominated ; ++j) {
+            const Piece & p = pieces[reached[j]];
+            dominated = j != i && dominates(p, pieces[reached[i]]) && (j < i || !dominates(pieces[reached[i]], p));
+        }
+        if(!dominated)
+            best.push_back( reached[i] );
+    }
+
+    std::vector<ProfileEntry> entries;
+    BOOST_FOREACH( const int i, best ) {
+        ProfileEntry entry;
+        entry.first_departure = pieces[i].begin;
+        entry.last_departure = pieces[i].end;
+        entry.duration = pieces[i].duration;
+        entry.path.end_node = target;
+        int curr = i;
+        for(; pieces[curr].parent >= 0 ; curr = pieces[curr].parent)
+            entry.path.edges.push_front( pieces[curr].edge );
+        entry.path.start_node = pieces[curr].node;
+        entries.push_back( entry );
+    }
+    std::sort( entries.begin(), entries.end(), by_departure );
+    return entries;
+}
+
+} // end namespace RLC
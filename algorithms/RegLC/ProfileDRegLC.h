@@ -0,0 +1,176 @@
+/** Copyright : Arthur Bit-Monnot (2013)  arthur.bit-monnot@laas.fr
+
+This software is a computer program whose purpose is to [describe
+functionalities and technical features of your software].
+
+This software is governed by the CeCILL-B license under French law and
+abiding by the rules of distribution of free software.  You can  use, 
+modify and/ or redistribute the software under the terms of the CeCILL-B
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info". 
+
+As a counterpart to the access to the source code and  rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty  and the software's author,  the holder of the
+economic rights,  and the successive licensors  have only  limited
+liability. 
+
+In this respect, the user's attention is drawn to the risks associated
+with loading,  using,  modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean  that it is complicated to manipulate,  and  that  also
+therefore means  that it is reserved for developers  and  experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or 
+data to be ensured and,  more generally, to use and operate it in the 
+same conditions as regards security. 
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL-B license and that you accept its terms. 
+*/
+
+#ifndef PROFILE_DREGLC_H
+#define PROFILE_DREGLC_H
+
+#include <vector>
+#include <queue>
+#include <boost/shared_ptr.hpp>
+
+#include "reglc_graph.h"
+#include "../Interface/Path.h"
+
+namespace RLC {
+
+/**
+ * Part of a travel time profile: leaving at a time t <= last_departure arrives at max(t, first_departure) + duration,
+ * leaving before first_departure hence means waiting for it.
+ *
+ * A single connection has first_departure == last_departure, walking or riding a frequency gives a window.
+ */
+struct ProfileEntry {
+    int first_departure;
+    int last_departure;
+    int duration;
+    Path path;
+};
+
+/**
+ * Profile variant of DRegLC: computes the arrival time at a target for every departure in [earliest, latest]
+ * with a single search.
+ *
+ * Labels are piecewise-linear arrival functions, stored as sets of pieces (see ProfileEntry). Traversing an edge
+ * composes every piece with the duration function of the edge: constant durations shift it, timetables turn it
+ * into one piece per line that can be caught and frequencies clip it to their windows. Pieces of a vertex that
+ * are dominated by another piece of that vertex or of the target are discarded.
+ *
+ * Since a function can be improved after it has been propagated, this is a label correcting algorithm: a vertex
+ * is scanned again whenever it receives new pieces, only those being propagated.
+ */
+class ProfileDRegLC
+{
+public:
+    ProfileDRegLC( const AbstractGraph * graph, const int day, const int earliest, const int latest, const int target );
+
+    /**
+     * The source can be left at any time in [earliest, latest]
+     */
+    void add_source_node( const Vertice & vert );
+
+    void run();
+
+    /**
+     * Non dominated pieces of the arrival function at the target, by increasing departure
+     */
+    std::vector<ProfileEntry> profile() const;
+
+    /**
+     * Number of pieces built
+     */
+    int count;
+
+private:
+    /**
+     * Latest arrival at the target over the departure interval
+     */
+    int bound;
+
+    struct Piece {
+        int begin;
+        int end;
+        int duration;
+
+        /**
+         * Piece it was built from (-1 for a source) and edge of the transport graph traversed
+         */
+        int parent;
+        int edge;
+        int node;
+        bool alive;
+    };
+
+    struct VertexProfile {
+        std::vector<int> pieces;
+
+        /**
+         * Pieces not propagated yet
+         */
+        std::vector<int> pending;
+    };
+
+    inline int arrival( const Piece & p, const int departure ) const {
+        return std::max(departure, p.begin) + p.duration;
+    }
+
+    bool dominates( const Piece & p, const Piece & q ) const;
+
+    /**
+     * Adds a piece to a vertex unless it is dominated, removes the pieces it dominates
+     */
+    void insert( const Vertice & vert, const Piece & piece );
+
+    void scan( const int slot );
+
+    /**
+     * Extends `piece` along `edge` and inserts the result at the target of the edge
+     */
+    void relax( const int piece, const RLC::Edge & edge );
+
+    int slot( const Vertice & vert );
+
+    const AbstractGraph * graph;
+    const int day;
+    const int earliest;
+    const int latest;
+    const int target;
+    const int num_transport_vertices;
+
+    boost::shared_ptr<const Transport::DayTimetable> lines;
+
+    std::vector<Piece> pieces;
+    std::vector<VertexProfile> profiles;
+    std::vector<Vertice> slot_vertices;
+
+    /**
+     * Index in profiles of each vertex (dfa state major), -1 if it was not reached
+     */
+    std::vector<int> slots;
+
+    /**
+     * Vertices of the target in an accepting state
+     */
+    std::vector<Vertice> target_vertices;
+
+    /**
+     * Vertices with pending pieces, by earliest arrival of the piece that was inserted
+     */
+    typedef std::pair<int, int> QueueItem;
+    std::priority_queue< QueueItem, std::vector<QueueItem>, std::greater<QueueItem> > queue;
+
+    std::vector<RLC::Edge> n_out_edges;
+    std::vector<Transport::FrequencyEntry> windows;
+};
+
+} // end namespace RLC
+
+#endif
@@ -0,0 +1,140 @@
+/** Copyright : Arthur Bit-Monnot (2013)  arthur.bit-monnot@laas.fr
+
+This software is a computer program whose purpose is to [describe
+functionalities and technical features of your software].
+
+This software is governed by the CeCILL-B license under French law and
+abiding by the rules of distribution of free software.  You can  use, 
+modify and/ or redistribute the software under the terms of the CeCILL-B
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info". 
+
+As a counterpart to the access to the source code and  rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty  and the software's author,  the holder of the
+economic rights,  and the successive licensors  have only  limited
+liability. 
+
+In this respect, the user's attention is drawn to the risks associated
+with loading,  using,  modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean  that it is complicated to manipulate,  and  that  also
+therefore means  that it is reserved for developers  and  experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or 
+data to be ensured and,  more generally, to use and operate it in the 
+same conditions as regards security. 
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL-B license and that you accept its terms. 
+*/
+
+#include "StateLandmarks.h"
+
+#include <limits>
+#include <boost/foreach.hpp>
+
+#include "DRegLC.h"
+#include "AspectMinCost.h"
+
+namespace RLC {
+
+StateLandmarks::StateLandmarks( const Transport::Graph * trans, const DFA & dfa, const std::vector<int> & nodes ) :
+    graph_id(trans->get_id()),
+    graph(trans),
+    dfa(dfa),
+    nodes(nodes),
+    num_transport_vertices(trans->num_vertices()),
+    start_states(),
+    accepting_states(dfa.accepting_states)
+{
+    // the day is not used by minimal durations
+    const int day = 0;
+    RLC::Graph g( trans, dfa );
+    RLC::BackwardGraph bg( &g );
+    start_states = g.dfa_start_states();
+
+    const int num_states = g.num_dfa_vertices();
+    potentials.assign( num_states * num_transport_vertices * nodes.size() * 2, -1 );
+
+    // both graphs have the same vertices, every search reuses the same workspace
+    Workspace workspace( num_transport_vertices, num_states );
+
+    for(uint l=0 ; l<nodes.size() ; ++l) {
+        // offset 0: distance to the landmark (backward search), 1: distance from it (forward search)
+        for(int offset=0 ; offset<2 ; ++offset) {
+            const AbstractGraph * graph = offset == 0 ? (const AbstractGraph *) &bg : (const AbstractGraph *) &g;
+            AspectMinCost<DRegLC> algo( DRegLCParams(graph, day, 1, &workspace) );
+            for(int q=0 ; q<num_states ; ++q) {
+                algo.add_source_node( Vertice(nodes[l], q), 0, 0 );
+            }
+
+            while( !algo.finished() ) {
+                const Label lab = algo.treat_next();
+                potentials[potential_index(lab.node.first, lab.node.second, l) + offset] = lab.cost;
+            }
+        }
+    }
+}
+
+namespace {
+
+/**
+ * Greatest of the distances, -1 if one of them is unreachable
+ */
+inline int max_distance( const int current, const int distance )
+{
+    return (current < 0 || distance < 0) ? -1 : std::max( current, distance );
+}
+
+/**
+ * Smallest of the reachable distances, -1 if there is none
+ */
+inline int min_distance( const int current, const int distance )
+{
+    if(distance < 0)
+        return current;
+    return current < 0 ? distance : std::min( current, distance );
+}
+
+} // end anonymous namespace
+
+int StateLandmarks::dist_lb( const Vertice & source, const int target, const bool is_forward ) const
+{
+    // vertices of the target the search can end in
+    const std::set<int> & target_states = is_forward ? accepting_states : start_states;
+
+    int best = 0;
+    for(uint l=0 ; l<nodes.size() ; ++l) {
+        const int * p_src = &potentials[potential_index(source.first, source.second, l)];
+
+        // a target state that cannot reach (resp. be reached from) the landmark cannot be reached from
+        // (resp. reach) a vertex that can reach (resp. be reached from) it: it is ignored by the minimums
+        int to_max = 0, to_min = -1, from_max = 0, from_min = -1;
+        BOOST_FOREACH( const int q, target_states ) {
+            const int * p_target = &potentials[potential_index(target, q, l)];
+            to_max = max_distance( to_max, p_target[0] );
+            to_min = min_distance( to_min, p_target[0] );
+            from_max = max_distance( from_max, p_target[1] );
+            from_min = min_distance( from_min, p_target[1] );
+        }
+
+        if(is_forward) {
+            // d(s, t) >= d(s, l) - d(t, l)  and  d(s, t) >= d(l, t) - d(l, s)
+            if(p_src[0] >= 0 && to_max >= 0)
+                best = std::max( best, p_src[0] - to_max );
+            if(p_src[1] >= 0 && from_min >= 0)
+                best = std::max( best, from_min - p_src[1] );
+        } else {
+            // the search goes backward from s to t: d(t, s) >= d(t, l) - d(s, l)  and  d(t, s) >= d(l, s) - d(l, t)
+            if(p_src[0] >= 0 && to_min >= 0)
+                best = std::max( best, to_min - p_src[0] );
+            if(p_src[1] >= 0 && from_max >= 0)
+                best = std::max( best, p_src[1] - from_max );
+        }
+    }
+    return best;
+}
+
+} // end namespace RLC
@@ -0,0 +1,97 @@
+/** Copyright : Arthur Bit-Monnot (2013)  arthur.bit-monnot@laas.fr
+
+This software is a computer program whose purpose is to [describe
+functionalities and technical features of your software].
+
+This software is governed by the CeCILL-B license under French law and
+abiding by the rules of distribution of free software.  You can  use, 
+modify and/ or redistribute the software under the terms of the CeCILL-B
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info". 
+
+As a counterpart to the access to the source code and  rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty  and the software's author,  the holder of the
+economic rights,  and the successive licensors  have only  limited
+liability. 
+
+In this respect, the user's attention is drawn to the risks associated
+with loading,  using,  modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean  that it is complicated to manipulate,  and  that  also
+therefore means  that it is reserved for developers  and  experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or 
+data to be ensured and,  more generally, to use and operate it in the 
+same conditions as regards security. 
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL-B license and that you accept its terms. 
+*/
+
+#ifndef STATE_LANDMARKS_H
+#define STATE_LANDMARKS_H
+
+#include <string>
+#include <vector>
+
+#include "reglc_graph.h"
+
+namespace RLC {
+
+/**
+ * State dependent landmarks (SDALT): lower bounds of the cost between two vertices of the product of the
+ * transport graph with a DFA.
+ *
+ * For each landmark node l, the distances are computed from every vertex (v, q) to the set of vertices (l, *)
+ * and from that set to every vertex, following the transitions of the DFA. Edges cost their minimal duration,
+ * so the bounds stay admissible (and consistent) whatever the departure time of a public transport edge.
+ * The bound to a target holds for all of its accepting states (its start states for a backward search).
+ *
+ * Can be used as the heuristic of AspectTargetLandmark, searches must use the same DFA.
+ *
+ * The distances take #states x #nodes x #landmarks x 2 ints: 16 landmarks on bike_pt_dfa (3 states) over a
+ * million nodes take 384 MB.
+ */
+class StateLandmarks
+{
+public:
+    /**
+     * Computes the distances with the landmarks in `nodes`
+     */
+    StateLandmarks( const Transport::Graph * trans, const DFA & dfa, const std::vector<int> & nodes );
+
+    /**
+     * Id of the graph those landmarks are applied to
+     */
+    const std::string graph_id;
+
+    const Transport::Graph * graph;
+    const DFA dfa;
+
+    std::vector<int> nodes;
+
+    /**
+     * Returns a lower bound of the distance between source and target, whose DFA state is unknown
+     */
+    int dist_lb( const Vertice & source, const int target, const bool is_forward ) const;
+
+private:
+    const int num_transport_vertices;
+    std::set<int> start_states;
+    std::set<int> accepting_states;
+
+    /**
+     * For each vertex and landmark: distance to the landmark then from the landmark, -1 if unreachable
+     */
+    std::vector<int> potentials;
+
+    inline int potential_index( const int node, const int state, const int landmark ) const {
+        return ((state * num_transport_vertices + node) * nodes.size() + landmark) * 2;
+    }
+};
+
+} // end namespace RLC
+
+#endif
@@ -0,0 +1,147 @@
+/** Copyright : Arthur Bit-Monnot (2013)  arthur.bit-monnot@laas.fr
+
+This software is a computer program whose purpose is to [describe
+functionalities and technical features of your software].
+
+This software is governed by the CeCILL-B license under French law and
+abiding by the rules of distribution of free software.  You can  use, 
+modify and/ or redistribute the software under the terms of the CeCILL-B
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info". 
+
+As a counterpart to the access to the source code and  rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty  and the software's author,  the holder of the
+economic rights,  and the successive licensors  have only  limited
+liability. 
+
+In this respect, the user's attention is drawn to the risks associated
+with loading,  using,  modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean  that it is complicated to manipulate,  and  that  also
+therefore means  that it is reserved for developers  and  experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or 
+data to be ensured and,  more generally, to use and operate it in the 
+same conditions as regards security. 
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL-B license and that you accept its terms. 
+*/
+
+#include <algorithm>
+#include <boost/foreach.hpp>
+
+#include "Workspace.h"
+
+namespace RLC {
+
+Workspace::Workspace( const int trans_num_vert, const int dfa_num_vert, const Mode mode ) :
+    trans_num_vert(trans_num_vert),
+    dfa_num_vert(dfa_num_vert),
+    mode(mode),
+    capacity(0)
+{
+    if(mode == Dense) {
+        resize( trans_num_vert * dfa_num_vert );
+    } else {
+        resize( 1024 );
+        table.assign( 2048, -1 );
+    }
+}
+
+void Workspace::reset()
+{
+    if(mode == Dense) {
+        // clearing slots one by one costs a random access each: past about one touched slot per 16 words of
+        // colours (512 slots), filling both arrays is cheaper
+        if(touched.size() * 16 > colours.size()) {
+            std::fill( colours.begin(), colours.end(), 0 );
+            std::fill( preds.begin(), preds.end(), 0 );
+        } else {
+            BOOST_FOREACH( const int s, touched ) {
+                colours[s >> 5] &= ~(uint64_t(3) << ((s & 31) << 1));
+                preds[s >> 6] &= ~(uint64_t(1) << (s & 63));
+            }
+        }
+        touched.clear();
+    } else {
+        std::fill( colours.begin(), colours.begin() + (keys.size() + 31) / 32, 0 );
+        std::fill( preds.begin(), preds.begin() + (keys.size() + 63) / 64, 0 );
+        std::fill( table.begin(), table.end(), -1 );
+        keys.clear();
+    }
+}
+
+int Workspace::add_key( const int key )
+{
+    const int s = keys.size();
+    if(s == capacity)
+        resize( 2 * capacity );
+    keys.push_back( key );
+
+    // the table is kept at most half full
+    if(2 * keys.size() > table.size()) {
+        table.assign( 2 * table.size(), -1 );
+        for(uint i=0 ; i<keys.size() ; ++i) {
+            uint h = hash(keys[i]);
+            while(table[h] >= 0)
+                h = (h + 1) & (table.size() - 1);
+            table[h] = i;
+        }
+    } else {
+        uint h = hash(key);
+        while(table[h] >= 0)
+            h = (h + 1) & (table.size() - 1);
+        table[h] = s;
+    }
+    return s;
+}
+
+void Workspace::resize( const int capacity )
+{
+    this->capacity = capacity;
+    colours.resize( (capacity + 31) / 32, 0 );
+    preds.resize( (capacity + 63) / 64, 0 );
+    for(uint i=0 ; i<buffers.size() ; ++i) {
+        buffers[i].second->resize( capacity );
+    }
+}
+
+
+WorkspacePool::~WorkspacePool()
+{
+    BOOST_FOREACH( Workspace * workspace, free_workspaces ) {
+        delete workspace;
+    }
+}
+
+boost::shared_ptr<Workspace> WorkspacePool::acquire( const AbstractGraph * graph, const Workspace::Mode mode )
+{
+    const int trans_num_vert = graph->num_transport_vertices();
+    const int dfa_num_vert = graph->num_dfa_vertices();
+    Workspace * workspace = NULL;
+    {
+        std::lock_guard<std::mutex> lock( mutex );
+        for(uint i=0 ; i<free_workspaces.size() ; ++i) {
+            const Workspace * w = free_workspaces[i];
+            if(w->trans_num_vert == trans_num_vert && w->dfa_num_vert == dfa_num_vert && w->mode == mode) {
+                workspace = free_workspaces[i];
+                free_workspaces.erase( free_workspaces.begin() + i );
+                break;
+            }
+        }
+    }
+    if(workspace == NULL)
+        workspace = new Workspace( trans_num_vert, dfa_num_vert, mode );
+    return boost::shared_ptr<Workspace>( workspace, [this]( Workspace * w ) { release( w ); } );
+}
+
+void WorkspacePool::release( Workspace * workspace )
+{
+    std::lock_guard<std::mutex> lock( mutex );
+    free_workspaces.push_back( workspace );
+}
+
+} // end namespace RLC
@@ -0,0 +1,219 @@
+/** Copyright : Arthur Bit-Monnot (2013)  arthur.bit-monnot@laas.fr
+
+This software is a computer program whose purpose is to [describe
+functionalities and technical features of your software].
+
+This software is governed by the CeCILL-B license under French law and
+abiding by the rules of distribution of free software.  You can  use, 
+modify and/ or redistribute the software under the terms of the CeCILL-B
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info". 
+
+As a counterpart to the access to the source code and  rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty  and the software's author,  the holder of the
+economic rights,  and the successive licensors  have only  limited
+liability. 
+
+In this respect, the user's attention is drawn to the risks associated
+with loading,  using,  modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean  that it is complicated to manipulate,  and  that  also
+therefore means  that it is reserved for developers  and  experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or 
+data to be ensured and,  more generally, to use and operate it in the 
+same conditions as regards security. 
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL-B license and that you accept its terms. 
+*/
+
+#ifndef RLC_WORKSPACE_H
+#define RLC_WORKSPACE_H
+
+#include <vector>
+#include <typeinfo>
+#include <mutex>
+#include <stdint.h>
+#include <boost/shared_ptr.hpp>
+
+#include "reglc_graph.h"
+
+namespace RLC {
+
+/**
+ * Per vertex (node, DFA state) memory of a DRegLC search, kept from one search to the next.
+ *
+ * Each vertex the search reaches gets a slot. The colour of a slot (white, grey or black) takes two bits and
+ * whether it has a predecessor one more, in packed arrays. The other buffers (queue handles or costs,
+ * predecessors) hold one element per slot, are allocated on first use and never cleared, a search only reading
+ * the entries of the vertices it reached. Starting a search only clears the bits of the vertices reached by the
+ * previous one.
+ *
+ * In Dense mode the slot of a vertex is its index and every array covers the whole graph. In Sparse mode,
+ * meant for the searches that stay around their sources (areas, isochrones, pruned layers), slots are given in
+ * the order vertices are reached through an open-addressing hash table, so the memory follows the number of
+ * vertices reached.
+ *
+ * A workspace is used by one search at a time.
+ */
+class Workspace
+{
+public:
+    enum Mode { Dense, Sparse };
+
+    Workspace( const int trans_num_vert, const int dfa_num_vert, const Mode mode = Dense );
+
+    const int trans_num_vert;
+    const int dfa_num_vert;
+    const Mode mode;
+
+    /**
+     * Starts a new search: every vertex is white and has no predecessor
+     */
+    void reset();
+
+    inline int index( const Vertice & v ) const { return v.second * trans_num_vert + v.first; }
+
+    /**
+     * Slot of the vertex, -1 if it was not reached in sparse mode
+     */
+    inline int find( const Vertice & v ) const {
+        return mode == Dense ? index(v) : find_key( index(v) );
+    }
+
+    /**
+     * Slot of the vertex, given one if it had none
+     */
+    inline int slot( const Vertice & v ) {
+        if(mode == Dense)
+            return index(v);
+        const int s = find_key( index(v) );
+        return s >= 0 ? s : add_key( index(v) );
+    }
+
+    inline uint status( const Vertice & v ) const {
+        const int s = find(v);
+        return s < 0 ? 0 : (colours[s >> 5] >> ((s & 31) << 1)) & 3;
+    }
+    inline void set_status( const Vertice & v, const uint status ) {
+        const int s = slot(v);
+        touch( s );
+        uint64_t & word = colours[s >> 5];
+        const int shift = (s & 31) << 1;
+        word = (word & ~(uint64_t(3) << shift)) | (uint64_t(status) << shift);
+    }
+
+    inline bool has_pred( const Vertice & v ) const {
+        const int s = find(v);
+        return s >= 0 && (preds[s >> 6] >> (s & 63)) & 1;
+    }
+    inline void set_has_pred( const Vertice & v, const bool has_pred ) {
+        const int s = slot(v);
+        touch( s );
+        if(has_pred)
+            preds[s >> 6] |= uint64_t(1) << (s & 63);
+        else
+            preds[s >> 6] &= ~(uint64_t(1) << (s & 63));
+    }
+
+    /**
+     * Buffer of one T per slot, the same one being returned for every call with that type. It grows with the
+     * number of slots in sparse mode, so it must be indexed again after a new slot was given.
+     */
+    template<typename T>
+    std::vector<T> & buffer() {
+        for(uint i=0 ; i<buffers.size() ; ++i) {
+            if(*buffers[i].first == typeid(T))
+                return static_cast<Buffer<T> *>(buffers[i].second.get())->data;
+        }
+        Buffer<T> * b = new Buffer<T>();
+        b->resize( capacity );
+        buffers.push_back( std::make_pair(&typeid(T), boost::shared_ptr<AbstractBuffer>(b)) );
+        return b->data;
+    }
+
+private:
+    Workspace( const Workspace & );
+    Workspace & operator=( const Workspace & );
+
+    struct AbstractBuffer {
+        virtual ~AbstractBuffer() {}
+        virtual void resize( const int size ) = 0;
+    };
+
+    template<typename T>
+    struct Buffer : public AbstractBuffer {
+        std::vector<T> data;
+        virtual void resize( const int size ) { data.resize( size ); }
+    };
+
+    /**
+     * Records a slot the first time one of its bits is set in this search
+     */
+    inline void touch( const int s ) {
+        if(mode == Dense && ((colours[s >> 5] >> ((s & 31) << 1)) & 3) == 0 && !((preds[s >> 6] >> (s & 63)) & 1))
+            touched.push_back( s );
+    }
+
+    inline int find_key( const int key ) const {
+        for(uint h = hash(key) ; ; h = (h + 1) & (table.size() - 1)) {
+            const int s = table[h];
+            if(s < 0 || keys[s] == key)
+                return s;
+        }
+    }
+
+    inline uint hash( const int key ) const { return (uint(key) * 2654435761u) & (table.size() - 1); }
+
+    int add_key( const int key );
+    void resize( const int capacity );
+
+    /**
+     * Number of slots of the arrays
+     */
+    int capacity;
+
+    std::vector<uint64_t> colours;
+    std::vector<uint64_t> preds;
+
+    /**
+     * Dense mode: slots whose bits were set since the last reset
+     */
+    std::vector<int> touched;
+
+    /**
+     * Sparse mode: slot of each entry of the hash table (-1 if empty), and vertex index of each slot
+     */
+    std::vector<int> table;
+    std::vector<int> keys;
+
+    std::vector< std::pair<const std::type_info *, boost::shared_ptr<AbstractBuffer> > > buffers;
+};
+
+/**
+ * Workspaces shared by the searches of successive queries and of several threads
+ */
+class WorkspacePool
+{
+public:
+    ~WorkspacePool();
+
+    /**
+     * A workspace for the graph that no other search uses, created if none is free. It goes back to the pool
+     * when the last copy of the pointer is released, which must happen before the pool is destroyed.
+     */
+    boost::shared_ptr<Workspace> acquire( const AbstractGraph * graph, const Workspace::Mode mode = Workspace::Dense );
+
+private:
+    void release( Workspace * workspace );
+
+    std::mutex mutex;
+    std::vector<Workspace *> free_workspaces;
+};
+
+} // end namespace RLC
+
+#endif
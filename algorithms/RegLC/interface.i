@@ -3,6 +3,9 @@
 
 %{
  #include "reglc_graph.h"
+ #include "ProfileDRegLC.h"
+ #include "ArcFlags.h"
+ #include "StateLandmarks.h"
 %}
 
 %rename(RLC_Compare) RLC::Compare;
@@ -10,5 +13,16 @@
 %rename(RLC_Edge)    RLC::Edge;
 %rename(RLC_Graph)   RLC::Graph;
 
+// Searches are run through the functions of ItinerariesRequests.h
+%ignore RLC::ProfileDRegLC;
+
+// Built from the node ids of the input data by state_landmarks (see Interface/interface.i)
+%ignore RLC::StateLandmarks::StateLandmarks;
+
 // Parse the original header file
-%include "reglc_graph.h"
\ No newline at end of file
+%include "reglc_graph.h"
+%include "ProfileDRegLC.h"
+%include "ArcFlags.h"
+%include "StateLandmarks.h"
+
+%template(ProfileList) std::vector<RLC::ProfileEntry>;
\ No newline at end of file
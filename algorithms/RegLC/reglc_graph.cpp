@@ -55,6 +55,17 @@ start_state(start), accepting_states(accepting)
     }
 }
 
+bool DFA::accepts_public_transport() const
+{
+    boost::graph_traits<Graph_t>::edge_iterator it, end;
+    for(tie(it, end) = boost::edges(graph) ; it != end ; ++it) {
+        const int mode = graph[*it].type;
+        if(mode == SubwayEdge || mode == BusEdge || mode == TramEdge)
+            return true;
+    }
+    return false;
+}
+
 DFA foot_subway_dfa()
 {
     DfaEdgeList edges;
@@ -185,25 +196,25 @@ RLC::Vertice Graph::target( const RLC::Edge & edge) const
     return RLC::Vertice(transport->target( edge.first ), boost::target(edge.second, dfa.graph));
 }
 
-std::list<RLC::Edge> Graph::out_edges( const RLC::Vertice & vertice) const
+void Graph::out_edges( const RLC::Vertice & vertice, std::vector<RLC::Edge> & edges ) const
 {
-    std::list<RLC::Edge> edges;
+    edges.clear();
     
-    Graph_t::out_edge_iterator g_ei, g_end, dfa_beg, dfa_end, dfa_it;
-    tie(g_ei,g_end) = boost::out_edges(vertice.first, transport->g);
+    const Transport::CsrGraph & csr = transport->csr();
+    Graph_t::out_edge_iterator dfa_beg, dfa_end, dfa_it;
     tie(dfa_beg,dfa_end) = boost::out_edges(vertice.second, dfa.graph);
-    dfa_it = dfa_beg;
     
-    while(g_ei != g_end && dfa_it != dfa_end) {
-        while(dfa_it != dfa_end) {
-            if(transport->map(*g_ei).type == dfa.graph[*dfa_it].type)
-                edges.push_back(RLC::Edge(*g_ei, *dfa_it));
-            ++dfa_it;
+    // only the edges whose mode is accepted by the DFA transition are considered
+    for(dfa_it = dfa_beg ; dfa_it != dfa_end ; ++dfa_it) {
+        const int mode = dfa.graph[*dfa_it].type;
+        if(mode >= Transport::CsrGraph::num_modes)
+            continue;
+        
+        const int end = csr.out_end(vertice.first, mode);
+        for(int e = csr.out_begin(vertice.first, mode) ; e != end ; ++e) {
+            edges.push_back(RLC::Edge(e, *dfa_it));
         }
-        ++g_ei;
-        dfa_it = dfa_beg;
     }
-    return edges;
 }
 
 std::pair<bool, int> Graph::duration( const RLC::Edge & edge, const float start_sec, const int day) const
@@ -257,25 +268,24 @@ Vertice BackwardGraph::target ( const Edge & edge ) const
     return forward_graph->source( edge );
 }
 
-list< Edge > BackwardGraph::out_edges ( const Vertice & vertice ) const
+void BackwardGraph::out_edges ( const Vertice & vertice, std::vector<RLC::Edge> & edges ) const
 {
-    std::list<RLC::Edge> edges;
+    edges.clear();
     
-    Graph_t::in_edge_iterator g_ei, g_end, dfa_beg, dfa_end, dfa_it;
-    tie(g_ei,g_end) = boost::in_edges(vertice.first, forward_graph->transport->g);
+    const Transport::CsrGraph & csr = forward_graph->transport->csr();
+    Graph_t::in_edge_iterator dfa_beg, dfa_end, dfa_it;
     tie(dfa_beg,dfa_end) = boost::in_edges(vertice.second, forward_graph->dfa.graph);
-    dfa_it = dfa_beg;
     
-    while(g_ei != g_end && dfa_it != dfa_end) {
-        while(dfa_it != dfa_end) {
-            if(forward_graph->transport->map(*g_ei).type == forward_graph->dfa.graph[*dfa_it].type)
-                edges.push_back(RLC::Edge(*g_ei, *dfa_it));
-            ++dfa_it;
+    for(dfa_it = dfa_beg ; dfa_it != dfa_end ; ++dfa_it) {
+        const int mode = forward_graph->dfa.graph[*dfa_it].type;
+        if(mode >= Transport::CsrGraph::num_modes)
+            continue;
+        
+        const int end = csr.in_end(vertice.first, mode);
+        for(int i = csr.in_begin(vertice.first, mode) ; i != end ; ++i) {
+            edges.push_back(RLC::Edge(csr.in_edge_id[i], *dfa_it));
         }
-        ++g_ei;
-        dfa_it = dfa_beg;
     }
-    return edges;
 }
 
 std::pair<bool, int> BackwardGraph::duration ( const Edge & edge, const float start_sec, const int day ) const
@@ -50,6 +50,11 @@ public:
     int start_state;
     std::set<int> accepting_states;
     Graph_t graph;
+    
+    /**
+     * Returns true if a transition accepts a timetabled mode (subway, bus or tram)
+     */
+    bool accepts_public_transport() const;
 };
 
 DFA foot_subway_dfa();
@@ -70,10 +75,10 @@ typedef std::pair<int, int> Vertice;
 
 /**
  * An edge in the DRegLC algorithm
- *  - First : edge in the transportation graph
+ *  - First : id of the edge in the transportation graph (see Transport::CsrGraph)
  *  - Second : edge in the DFA
  */
-typedef std::pair<edge_t, edge_t> Edge;
+typedef std::pair<int, edge_t> Edge;
 
 class AbstractGraph {
 public:
@@ -101,10 +106,21 @@ public:
      */
     virtual RLC::Vertice target( const RLC::Edge & ) const = 0;
     
+    /**
+     * Fills `edges` with every outgoing edge of a node.
+     * 
+     * `edges` is cleared first, this allows search algorithms to reuse the same buffer for every expansion.
+     */
+    virtual void out_edges( const RLC::Vertice &, std::vector<RLC::Edge> & edges ) const = 0;
+    
     /**
      * Return a list containing every outgoing edge of a node
      */
-    virtual std::list<RLC::Edge> out_edges( const RLC::Vertice & ) const = 0;
+    std::list<RLC::Edge> out_edges( const RLC::Vertice & vertice ) const {
+        std::vector<RLC::Edge> edges;
+        out_edges( vertice, edges );
+        return std::list<RLC::Edge>( edges.begin(), edges.end() );
+    }
     
     /**
      * Returns the cost (duration) of trip starting at the source node of the edge at time
@@ -148,9 +164,10 @@ public:
     RLC::Vertice target( const RLC::Edge & ) const;
     
     /**
-     * Return a list containing every outgoing edge of a node
+     * Fills `edges` with every outgoing edge of a node
      */
-    std::list<RLC::Edge> out_edges(const RLC::Vertice & ) const;
+    using AbstractGraph::out_edges;
+    void out_edges( const RLC::Vertice &, std::vector<RLC::Edge> & edges ) const;
     
     /**
      * Returns the arrival time of trip starting at the source node of the edge at time
@@ -207,9 +224,10 @@ public:
     RLC::Vertice target( const RLC::Edge & ) const;
     
     /**
-     * Return a list containing every outgoing edge of a node
+     * Fills `edges` with every outgoing edge of a node
      */
-    std::list<RLC::Edge> out_edges( const RLC::Vertice & ) const;
+    using AbstractGraph::out_edges;
+    void out_edges( const RLC::Vertice &, std::vector<RLC::Edge> & edges ) const;
     
     /**
      * Returns the arrival time of trip starting at the source node of the edge at time
@@ -5,4 +5,6 @@
 %include RegLC/interface.i
 %include MultipleParticipants/interface.i
 %include utils/interface.i
+%include PublicTransport/interface.i
+%include Hierarchies/interface.i
 %include Interface/interface.i
\ No newline at end of file
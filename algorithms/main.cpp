@@ -63,9 +63,9 @@ int main()
 //     Area * toulouse = toulouse_area(g);
 //     Area * bordeaux = bordeaux_area(g);
     
-    int src1 = 10;
-    int src2 = 644;
-    int dest = 235;//20; //693;
+    int src1 = g->internal_node(10);
+    int src2 = g->internal_node(644);
+    int dest = g->internal_node(235);//20; //693;
     
     int time = 50000;
     int day = 10;
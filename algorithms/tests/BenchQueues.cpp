@@ -0,0 +1,160 @@
+/** Copyright : Arthur Bit-Monnot (2013)  arthur.bit-monnot@laas.fr
+
+This software is a computer program whose purpose is to [describe
+functionalities and technical features of your software].
+
+This software is governed by the CeCILL-B license under French law and
+abiding by the rules of distribution of free software.  You can  use, 
+modify and/ or redistribute the software under the terms of the CeCILL-B
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info". 
+
+As a counterpart to the access to the source code and  rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty  and the software's author,  the holder of the
+economic rights,  and the successive licensors  have only  limited
+liability. 
+
+In this respect, the user's attention is drawn to the risks associated
+with loading,  using,  modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean  that it is complicated to manipulate,  and  that  also
+therefore means  that it is reserved for developers  and  experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or 
+data to be ensured and,  more generally, to use and operate it in the 
+same conditions as regards security. 
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL-B license and that you accept its terms. 
+*/
+
+/**
+ * Compares the priority queues of DRegLC on random car and public transport queries, and the d-ary heap with a
+ * workspace created for each query, a sparse one or aspects composed at compile time against the virtual
+ * aspects on a dense workspace reused by all the queries.
+ *
+ * Returns EXIT_FAILURE if a query finds another cost than the d-ary heap.
+ *
+ * Usage: BenchQueues <graph dump> [queries] [day] [time]
+ */
+
+#include <stdlib.h>
+#include <iostream>
+using std::cerr;
+using std::cout;
+using std::endl;
+#include <time.h>
+
+#include "GraphFactory.h"
+#include "reglc_graph.h"
+#include "DRegLC.h"
+#include "AspectTarget.h"
+#include "Workspace.h"
+
+struct Query {
+    int source;
+    int target;
+};
+
+struct Result {
+    Result() : construction(0), seconds(0), settled(0) {}
+
+    /**
+     * Time spent building the search objects, included in `seconds`
+     */
+    double construction;
+    double seconds;
+    long settled;
+    std::vector<int> costs;
+};
+
+/**
+ * Runs the queries, each search using its own workspace if `workspace` is NULL
+ */
+template<typename Algo>
+Result run_queries( const RLC::Graph & g, const std::vector<Query> & queries, const int day, const int time, RLC::Workspace * workspace )
+{
+    Result result;
+    BOOST_FOREACH( const Query & q, queries ) {
+        clock_t start = clock();
+        typename Algo::ParamType p( RLC::DRegLCParams(&g, day, 1, workspace), RLC::AspectTargetParams(q.target) );
+        Algo algo( p );
+        result.construction += double(clock() - start) / CLOCKS_PER_SEC;
+        BOOST_FOREACH( const int s, g.dfa_start_states() ) {
+            algo.add_source_node( RLC::Vertice(q.source, s), time, 0 );
+        }
+        while( !algo.finished() ) {
+            algo.treat_next();
+            ++result.settled;
+        }
+        result.seconds += double(clock() - start) / CLOCKS_PER_SEC;
+        result.costs.push_back( algo.get_path_cost() );
+    }
+    return result;
+}
+
+/**
+ * Prints the time of the queries, returns the number of queries whose cost differs from the reference
+ */
+int print( const std::string & name, const Result & result, const Result & reference )
+{
+    const int num_queries = result.costs.size();
+    cout << "    " << name << ": " << result.seconds * 1000 / num_queries << " ms per query (construction "
+         << result.construction * 1000 / num_queries << " ms)" << endl;
+
+    int mismatches = 0;
+    for(int i=0 ; i<num_queries ; ++i) {
+        if(result.costs[i] != reference.costs[i])
+            ++mismatches;
+    }
+    if(mismatches > 0)
+        cerr << "    " << mismatches << " queries with a different cost" << endl;
+    return mismatches;
+}
+
+/**
+ * Returns the number of queries for which a queue or workspace does not find the cost of the d-ary heap
+ */
+int compare( const std::string & name, const Transport::Graph * trans, const RLC::DFA & dfa, const int num_queries, const int day, const int time )
+{
+    RLC::Graph g( trans, dfa );
+    std::vector<Query> queries;
+    for(int i=0 ; i<num_queries ; ++i) {
+        Query q = { rand() % trans->num_vertices(), rand() % trans->num_vertices() };
+        queries.push_back( q );
+    }
+
+    RLC::Workspace workspace( g.num_transport_vertices(), g.num_dfa_vertices() );
+    const Result dary = run_queries<RLC::AspectTarget<RLC::DRegLC>>( g, queries, day, time, &workspace );
+    cout << name << ": " << num_queries << " queries, " << dary.settled / num_queries << " labels per query" << endl;
+    print( "d-ary heap", dary, dary );
+    int mismatches = print( "d-ary heap, workspace per query", run_queries<RLC::AspectTarget<RLC::DRegLC>>( g, queries, day, time, NULL ), dary );
+    RLC::Workspace sparse( g.num_transport_vertices(), g.num_dfa_vertices(), RLC::Workspace::Sparse );
+    mismatches += print( "d-ary heap, sparse workspace", run_queries<RLC::AspectTarget<RLC::DRegLC>>( g, queries, day, time, &sparse ), dary );
+    mismatches += print( "d-ary heap, static aspects", run_queries<RLC::StaticDRegLC<RLC::AspectTarget>>( g, queries, day, time, &workspace ), dary );
+    mismatches += print( "lazy heap", run_queries<RLC::AspectTarget<RLC::LazyDRegLC>>( g, queries, day, time, &workspace ), dary );
+    mismatches += print( "radix heap", run_queries<RLC::AspectTarget<RLC::RadixDRegLC>>( g, queries, day, time, &workspace ), dary );
+    mismatches += print( "radix heap, static aspects", run_queries<RLC::StaticDRegLC<RLC::AspectTarget, RLC::RadixQueue>>( g, queries, day, time, &workspace ), dary );
+    return mismatches;
+}
+
+int main(int argc, char ** argv)
+{
+    if(argc < 2) {
+        cerr << "Usage: " << argv[0] << " <graph dump> [queries] [day] [time]" << endl;
+        return EXIT_FAILURE;
+    }
+    const int num_queries = argc > 2 ? atoi(argv[2]) : 100;
+    const int day = argc > 3 ? atoi(argv[3]) : 10;
+    const int time = argc > 4 ? atoi(argv[4]) : 8 * 3600;
+
+    Transport::GraphFactory gf( argv[1], true );
+    const Transport::Graph * trans = gf.get();
+
+    srand( 42 );
+    int mismatches = compare( "car", trans, RLC::car_dfa(), num_queries, day, time );
+    mismatches += compare( "public transport", trans, RLC::pt_foot_dfa(), num_queries, day, time );
+    return mismatches == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,478 @@
+/** Copyright : Arthur Bit-Monnot (2013)  arthur.bit-monnot@laas.fr
+
+This software is a computer program whose purpose is to [describe
+functionalities and technical features of your software].
+
+This software is governed by the CeCILL-B license under French law and
+abiding by the rules of distribution of free software.  You can  use, 
+modify and/ or redistribute the software under the terms of the CeCILL-B
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info". 
+
+As a counterpart to the access to the source code and  rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty  and the software's author,  the holder of the
+economic rights,  and the successive licensors  have only  limited
+liability. 
+
+In this respect, the user's attention is drawn to the risks associated
+with loading,  using,  modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean  that it is complicated to manipulate,  and  that  also
+therefore means  that it is reserved for developers  and  experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or 
+data to be ensured and,  more generally, to use and operate it in the 
+same conditions as regards security. 
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL-B license and that you accept its terms. 
+*/
+
+/**
+ * Consistency checks of the public transport engines on a synthetic graph (see SyntheticGraph.h). The arrival
+ * times of random queries are compared with the ones of DRegLC on pt_foot_dfa, or of RAPTOR for the structures
+ * computed for a single day, and the paths returned are followed on the graph. Walking is not bounded, so that
+ * every engine answers the same question.
+ *
+ * With the default walking bound of the footpaths, the engines answer a more restricted question than DRegLC:
+ * they must then agree with each other, never arrive before DRegLC and return paths reaching the target.
+ *
+ * The engines ignore frequencies, which are checked on a second graph: the duration of their edges must be the one
+ * of a linear scan of their windows on the previous, current and next day.
+ *
+ * Returns EXIT_FAILURE if a query differs.
+ *
+ * Usage: CheckPublicTransport [queries]
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <unistd.h>
+#include <iostream>
+#include <stdexcept>
+#include <bitset>
+using std::cout;
+using std::endl;
+
+#include "GraphFactory.h"
+#include "reglc_graph.h"
+#include "DRegLC.h"
+#include "AspectTarget.h"
+#include "ProfileDRegLC.h"
+#include "ConnectionScan.h"
+#include "Raptor.h"
+#include "TransferPatterns.h"
+#include "TransferShortcuts.h"
+
+#include "SyntheticGraph.h"
+
+const int WIDTH = 30;
+const int HEIGHT = 30;
+const int ROUTES = 12;
+const int STOPS = 15;
+const int FREQUENCY_ROUTES = 3;
+
+/**
+ * Walking duration bound of the footpaths, longer than any walk on the grid
+ */
+const int MAX_WALKING = 24 * 3600;
+
+/**
+ * Rides allowed to RAPTOR, more than any earliest arrival itinerary on the grid uses
+ */
+const int MAX_RIDES = 16;
+
+struct Query {
+    int source;
+    int target;
+    int departure;
+    int day;
+};
+
+std::vector<Query> random_queries( const Transport::Graph * trans, const int num_queries )
+{
+    std::vector<Query> queries;
+    for(int i=0 ; i<num_queries ; ++i) {
+        Query q;
+        q.source = trans->internal_node( rand() % (WIDTH * HEIGHT) );
+        q.target = trans->internal_node( rand() % (WIDTH * HEIGHT) );
+        q.departure = 3600 * (rand() % 24);
+        q.day = 10 + rand() % 3;
+        queries.push_back( q );
+    }
+    return queries;
+}
+
+/**
+ * Earliest arrival found by DRegLC, -1 if the target is not reachable
+ */
+int dreglc_arrival( const RLC::Graph & g, const Query & q )
+{
+    typedef RLC::AspectTarget<RLC::DRegLC> Algo;
+    Algo::ParamType p( RLC::DRegLCParams(&g, q.day), RLC::AspectTargetParams(q.target) );
+    Algo dij( p );
+    dij.add_source_node( RLC::Vertice(q.source, g.dfa.start_state), q.departure, 0 );
+    dij.run();
+    return dij.success ? q.departure + dij.get_path_cost() : -1;
+}
+
+int report( const std::string & name, const int mismatches, const int num_queries )
+{
+    cout << name << ": " << num_queries - mismatches << "/" << num_queries << " queries consistent" << endl;
+    return mismatches;
+}
+
+int check_csa( const PT::Footpaths & footpaths, const std::vector<Query> & queries, const std::vector<int> & reference )
+{
+    int mismatches = 0;
+    for(unsigned int i=0 ; i<queries.size() ; ++i) {
+        const Query & q = queries[i];
+        PT::ConnectionTimetable timetable( footpaths, q.day );
+        PT::ConnectionScan csa( timetable, q.target );
+        csa.add_source_node( RLC::Vertice(q.source, 0), q.departure, 0 );
+        csa.run();
+
+        bool consistent = csa.arrival() == reference[i];
+        if(csa.arrival() >= 0) {
+            const Path path = csa.get_path_to( q.target );
+            consistent = consistent && arrival_along( footpaths.graph, path, q.source, q.target, q.departure, q.day ) == csa.arrival();
+        }
+        if(!consistent)
+            ++mismatches;
+    }
+    return report( "connection scan", mismatches, queries.size() );
+}
+
+/**
+ * True if the journeys are a Pareto set by increasing number of rides, whose paths reach the target at their arrival
+ */
+bool consistent_journeys( const Transport::Graph * trans, const std::vector<PT::Journey> & journeys, const Query & q )
+{
+    for(unsigned int j=0 ; j<journeys.size() ; ++j) {
+        const PT::Journey & journey = journeys[j];
+        if(arrival_along( trans, journey.path, q.source, q.target, journey.departure, q.day ) != journey.arrival)
+            return false;
+        if(j > 0 && (journey.rides <= journeys[j-1].rides || journey.arrival >= journeys[j-1].arrival))
+            return false;
+    }
+    return true;
+}
+
+/**
+ * The earliest arrival of RAPTOR must be the one of DRegLC. Each journey of rRAPTOR over the next half hour must
+ * arrive as early as the best one of RAPTOR leaving at its departure with at most as many rides.
+ */
+int check_raptor( const PT::Footpaths & footpaths, const std::vector<Query> & queries, const std::vector<int> & reference )
+{
+    int mismatches = 0;
+    for(unsigned int i=0 ; i<queries.size() ; ++i) {
+        const Query & q = queries[i];
+        PT::RaptorTimetable timetable( footpaths, q.day );
+        PT::Raptor raptor( timetable, q.source, q.target, MAX_RIDES );
+        const std::vector<PT::Journey> journeys = raptor.run( q.departure );
+
+        bool consistent = (journeys.empty() ? -1 : journeys.back().arrival) == reference[i]
+                          && consistent_journeys( footpaths.graph, journeys, q );
+
+        // range queries are much longer, only some of them are checked
+        PT::Raptor range( timetable, q.source, q.target, MAX_RIDES );
+        std::vector<PT::Journey> range_journeys;
+        if(i % 10 == 0)
+            range_journeys = range.run_range( q.departure, q.departure + 1800 );
+        BOOST_FOREACH( const PT::Journey & journey, range_journeys ) {
+            PT::Raptor single( timetable, q.source, q.target, MAX_RIDES );
+            int best = -1;
+            BOOST_FOREACH( const PT::Journey & other, single.run(journey.departure) ) {
+                if(other.rides <= journey.rides)
+                    best = other.arrival;
+            }
+            consistent = consistent && best == journey.arrival
+                         && arrival_along( footpaths.graph, journey.path, q.source, q.target, journey.departure, q.day ) == journey.arrival;
+        }
+        if(!consistent)
+            ++mismatches;
+    }
+    return report( "raptor", mismatches, queries.size() );
+}
+
+/**
+ * The profile over the next hour gives, every 5 minutes, the arrival of DRegLC leaving at that time.
+ * The path of each entry reaches the target at its arrival when leaving at its last departure.
+ *
+ * DRegLC does not wait for the window of a frequency. With `frequencies`, the profile may hence arrive earlier by
+ * leaving the source later: it must then give the arrival of DRegLC leaving at that later time.
+ */
+int check_profile( const RLC::Graph & g, const std::vector<Query> & queries, const std::string & name = "profile",
+                   const bool frequencies = false )
+{
+    int mismatches = 0;
+    BOOST_FOREACH( const Query & q, queries ) {
+        RLC::ProfileDRegLC profile( &g, q.day, q.departure, q.departure + 3600, q.target );
+        profile.add_source_node( RLC::Vertice(q.source, g.dfa.start_state) );
+        profile.run();
+        const std::vector<RLC::ProfileEntry> entries = profile.profile();
+
+        bool consistent = true;
+        BOOST_FOREACH( const RLC::ProfileEntry & entry, entries ) {
+            const int arrival = arrival_along( g.transport, entry.path, q.source, q.target, entry.last_departure, q.day );
+            consistent = consistent && arrival == entry.last_departure + entry.duration;
+        }
+        for(int departure = q.departure ; departure <= q.departure + 3600 ; departure += 300) {
+            int best = -1;
+            int best_departure = departure;
+            BOOST_FOREACH( const RLC::ProfileEntry & entry, entries ) {
+                const int arrival = std::max( departure, entry.first_departure ) + entry.duration;
+                if(entry.last_departure >= departure && (best < 0 || arrival < best)) {
+                    best = arrival;
+                    best_departure = std::max( departure, entry.first_departure );
+                }
+            }
+            Query at = q;
+            at.departure = departure;
+            const int arrival = dreglc_arrival( g, at );
+            if(frequencies && best >= 0 && (arrival < 0 || arrival > best)) {
+                at.departure = best_departure;
+                consistent = consistent && best == dreglc_arrival( g, at );
+            } else {
+                consistent = consistent && best == arrival;
+            }
+        }
+        if(!consistent)
+            ++mismatches;
+    }
+    return report( name, mismatches, queries.size() );
+}
+
+/**
+ * Duration of a ride of the frequency route `r` leaving at `time` on `day`, -1 if there is none: the window of the
+ * previous, current or next day starting first among those containing the time, scanning all of them
+ */
+int scanned_duration( const int r, const int time, const int day )
+{
+    int start = 0;
+    int duration = -1;
+    BOOST_FOREACH( const SyntheticFrequency & f, synthetic_frequencies(r) ) {
+        const std::bitset<128> services( f.services );
+        for(int shift=-1 ; shift<=1 ; ++shift) {
+            const int offset = shift * 24 * 3600;
+            if(day + shift < 0 || day + shift >= 128 || !services[day + shift])
+                continue;
+            if(f.start + offset <= time && time < f.end + offset && (duration < 0 || f.start + offset < start)) {
+                start = f.start + offset;
+                duration = f.duration;
+            }
+        }
+    }
+    return duration;
+}
+
+/**
+ * Durations of the frequency edges every 301 s over 30 hours, on days at the bounds of the services and
+ * in between
+ */
+int check_frequencies( const Transport::Graph * trans )
+{
+    const int days[] = { 0, 1, 10, 64, 127 };
+    std::vector<Transport::FrequencyEntry> windows;
+    int lookups = 0;
+    int mismatches = 0;
+    for(int e=0 ; e<trans->csr().num_edges() ; ++e) {
+        if(!trans->frequency_windows( e, 0, windows ))
+            continue;
+        const int r = (trans->original_node( trans->source(e) ) - WIDTH * HEIGHT) / STOPS - ROUTES;
+        BOOST_FOREACH( const int day, days ) {
+            for(int time=0 ; time<30*3600 ; time+=301) {
+                const std::pair<bool, int> duration = trans->duration_forward( e, time, day );
+                const int expected = scanned_duration( r, time, day );
+                if(duration.first != (expected >= 0) || (duration.first && duration.second != expected))
+                    ++mismatches;
+                ++lookups;
+            }
+        }
+    }
+    return report( "frequency windows", mismatches, lookups );
+}
+
+/**
+ * Name of a new empty file, to be removed by the caller
+ */
+std::string temporary_file()
+{
+    char name[] = "/tmp/check-public-transport-XXXXXX";
+    const int fd = mkstemp( name );
+    if(fd < 0)
+        throw std::runtime_error( "Unable to create a temporary file" );
+    close( fd );
+    return name;
+}
+
+/**
+ * True if `load` refuses its file by throwing a std::runtime_error
+ */
+template<typename Load>
+bool rejects( Load load )
+{
+    try {
+        load();
+    } catch( const std::runtime_error & ) {
+        return true;
+    }
+    return false;
+}
+
+/**
+ * Transfer patterns are only optimal on the day they were computed for: the queries are all run on that day and
+ * compared with RAPTOR. The patterns are saved and loaded back, the queries using the loaded ones, which must
+ * refuse the footpaths they do not fit.
+ */
+int check_transfer_patterns( const PT::Footpaths & footpaths, const std::vector<const PT::Footpaths *> & refused,
+                             const std::vector<Query> & queries, const std::string & name = "transfer patterns" )
+{
+    const int day = 10;
+    const std::string filename = temporary_file();
+    PT::TransferPatterns( footpaths, day, MAX_RIDES ).save( filename );
+    const PT::TransferPatterns patterns( footpaths, filename );
+    const PT::RaptorTimetable timetable( footpaths, day );
+    PT::TransferPatternsQuery query( patterns, day );
+    int mismatches = 0;
+    BOOST_FOREACH( const PT::Footpaths * other, refused ) {
+        if(!rejects( [&]() { const PT::TransferPatterns p( *other, filename ); } )) {
+            cout << name << ": file loaded with footpaths it does not fit" << endl;
+            ++mismatches;
+        }
+    }
+    remove( filename.c_str() );
+    BOOST_FOREACH( const Query & q, queries ) {
+        PT::Raptor raptor( timetable, q.source, q.target, MAX_RIDES );
+        const std::vector<PT::Journey> journeys = raptor.run( q.departure );
+        const PT::Journey journey = query.run( q.source, q.target, q.departure );
+
+        bool consistent = journey.arrival == (journeys.empty() ? -1 : journeys.back().arrival);
+        if(journey.arrival >= 0)
+            consistent = consistent && arrival_along( footpaths.graph, journey.path, q.source, q.target, q.departure, day ) == journey.arrival;
+        if(!consistent)
+            ++mismatches;
+    }
+    return report( name, mismatches, queries.size() );
+}
+
+/**
+ * RAPTOR on the shortcuts computed for a day must give the same journeys as on all the footpaths, on that day.
+ * The shortcuts are saved and loaded back, the queries using the loaded ones, which must refuse another graph
+ * built under the same id.
+ */
+int check_transfer_shortcuts( const PT::Footpaths & footpaths, const Transport::Graph * rebuilt, const std::vector<Query> & queries )
+{
+    const int day = 10;
+    const std::string filename = temporary_file();
+    PT::TransferShortcuts( footpaths.graph, day, MAX_WALKING, MAX_WALKING ).save( filename );
+    const PT::TransferShortcuts shortcuts( footpaths.graph, filename, MAX_WALKING );
+    const PT::RaptorTimetable timetable( footpaths, day );
+    const PT::RaptorTimetable shortcuts_timetable( shortcuts, day );
+    int mismatches = 0;
+    if(!rejects( [&]() { const PT::TransferShortcuts s( rebuilt, filename, MAX_WALKING ); } )) {
+        cout << "transfer shortcuts: file loaded with another graph" << endl;
+        ++mismatches;
+    }
+    remove( filename.c_str() );
+    BOOST_FOREACH( const Query & q, queries ) {
+        const std::vector<PT::Journey> journeys = PT::Raptor( timetable, q.source, q.target, MAX_RIDES ).run( q.departure );
+        const std::vector<PT::Journey> shortcut_journeys = PT::Raptor( shortcuts_timetable, q.source, q.target, MAX_RIDES ).run( q.departure );
+
+        bool consistent = journeys.size() == shortcut_journeys.size();
+        for(unsigned int j=0 ; consistent && j<journeys.size() ; ++j) {
+            consistent = journeys[j].arrival == shortcut_journeys[j].arrival && journeys[j].rides == shortcut_journeys[j].rides;
+        }
+        Query on_day = q;
+        on_day.day = day;
+        if(!consistent || !consistent_journeys( footpaths.graph, shortcut_journeys, on_day ))
+            ++mismatches;
+    }
+    return report( "transfer shortcuts", mismatches, queries.size() );
+}
+
+/**
+ * CSA and RAPTOR on the footpaths built with the default walking bound must find the same arrival, never before
+ * the one of DRegLC, along paths that reach the target at that time
+ */
+int check_default_walking( const PT::Footpaths & footpaths, const std::vector<Query> & queries, const std::vector<int> & reference )
+{
+    int mismatches = 0;
+    int as_early = 0;
+    for(unsigned int i=0 ; i<queries.size() ; ++i) {
+        const Query & q = queries[i];
+        PT::ConnectionTimetable csa_timetable( footpaths, q.day );
+        PT::ConnectionScan csa( csa_timetable, q.target );
+        csa.add_source_node( RLC::Vertice(q.source, 0), q.departure, 0 );
+        csa.run();
+        PT::RaptorTimetable raptor_timetable( footpaths, q.day );
+        const std::vector<PT::Journey> journeys = PT::Raptor( raptor_timetable, q.source, q.target, MAX_RIDES ).run( q.departure );
+
+        const int arrival = csa.arrival();
+        bool consistent = arrival == (journeys.empty() ? -1 : journeys.back().arrival)
+                          && consistent_journeys( footpaths.graph, journeys, q );
+        if(arrival >= 0) {
+            const Path path = csa.get_path_to( q.target );
+            consistent = consistent && reference[i] >= 0 && arrival >= reference[i]
+                         && arrival_along( footpaths.graph, path, q.source, q.target, q.departure, q.day ) == arrival;
+        }
+        if(arrival == reference[i])
+            ++as_early;
+        if(!consistent)
+            ++mismatches;
+    }
+    cout << "default walking: " << as_early << "/" << queries.size() << " queries as early as DRegLC" << endl;
+    return report( "default walking", mismatches, queries.size() );
+}
+
+int main(int argc, char ** argv)
+{
+    const int num_queries = argc > 1 ? atoi(argv[1]) : 100;
+
+    Transport::GraphFactory * factory = synthetic_graph( WIDTH, HEIGHT, ROUTES, STOPS );
+    const Transport::Graph * trans = factory->get();
+    PT::Footpaths footpaths( trans, MAX_WALKING );
+
+    srand( 11 );
+    const std::vector<Query> queries = random_queries( trans, num_queries );
+    RLC::Graph g( trans, RLC::pt_foot_dfa() );
+    std::vector<int> reference;
+    BOOST_FOREACH( const Query & q, queries ) {
+        reference.push_back( dreglc_arrival(g, q) );
+    }
+
+    int mismatches = 0;
+    mismatches += check_csa( footpaths, queries, reference );
+    mismatches += check_raptor( footpaths, queries, reference );
+    mismatches += check_profile( g, queries );
+
+    // files must be refused by the footpaths of another graph built under the same id, as when the graph is
+    // rebuilt from its database, and the patterns by footpaths with fewer transfers than their hops use
+    Transport::GraphFactory * rebuilt_factory = synthetic_graph( 4, 4, 1, 3 );
+    const PT::Footpaths rebuilt_footpaths( rebuilt_factory->get(), MAX_WALKING );
+    const PT::Footpaths default_footpaths( trans );
+    std::vector<const PT::Footpaths *> refused( 1, &rebuilt_footpaths );
+    refused.push_back( &default_footpaths );
+
+    mismatches += check_transfer_patterns( footpaths, refused, queries );
+    mismatches += check_transfer_shortcuts( footpaths, rebuilt_factory->get(), queries );
+
+    mismatches += check_default_walking( default_footpaths, queries, reference );
+    refused.pop_back();
+    mismatches += check_transfer_patterns( default_footpaths, refused, queries, "transfer patterns (default walking)" );
+
+    Transport::GraphFactory * frequency_factory = synthetic_graph( WIDTH, HEIGHT, ROUTES, STOPS, FREQUENCY_ROUTES );
+    const Transport::Graph * frequency_trans = frequency_factory->get();
+    mismatches += check_frequencies( frequency_trans );
+    srand( 11 );
+    const std::vector<Query> frequency_queries = random_queries( frequency_trans, num_queries );
+    const RLC::Graph frequency_g( frequency_trans, RLC::pt_foot_dfa() );
+    mismatches += check_profile( frequency_g, frequency_queries, "profile (frequencies)", true );
+
+    delete frequency_factory;
+    delete rebuilt_factory;
+    delete factory;
+    return mismatches == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
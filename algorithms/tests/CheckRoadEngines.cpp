@@ -0,0 +1,781 @@
+/** Copyright : Arthur Bit-Monnot (2013)  arthur.bit-monnot@laas.fr
+
+This software is a computer program whose purpose is to [describe
+functionalities and technical features of your software].
+
+This software is governed by the CeCILL-B license under French law and
+abiding by the rules of distribution of free software.  You can  use, 
+modify and/ or redistribute the software under the terms of the CeCILL-B
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info". 
+
+As a counterpart to the access to the source code and  rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty  and the software's author,  the holder of the
+economic rights,  and the successive licensors  have only  limited
+liability. 
+
+In this respect, the user's attention is drawn to the risks associated
+with loading,  using,  modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean  that it is complicated to manipulate,  and  that  also
+therefore means  that it is reserved for developers  and  experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or 
+data to be ensured and,  more generally, to use and operate it in the 
+same conditions as regards security. 
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL-B license and that you accept its terms. 
+*/
+
+/**
+ * Consistency checks of the speed-up techniques of road searches on a synthetic graph (see SyntheticGraph.h).
+ * For the car, bike and foot modes, the costs of random queries are compared with the ones of DRegLC, and the
+ * paths returned are followed on the graph. Arc flags are also checked on pt_foot_dfa, and the state dependent
+ * landmarks on the multimodal DFAs, searching forward and backward. Files written by the preprocessings are loaded
+ * back and must answer the same queries, those of another graph being refused, and so must a mapped graph with an
+ * edge out of range. The other priority queues of
+ * DRegLC must find the costs of the d-ary heap on car_dfa and pt_foot_dfa, and the areas, isochrones and paths
+ * of searches on sparse workspaces the ones found on dense workspaces. Aspects composed at compile time must find
+ * the costs and paths of the virtual ones.
+ *
+ * Returns EXIT_FAILURE if a query differs.
+ *
+ * Usage: CheckRoadEngines [queries]
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <unistd.h>
+#include <iostream>
+#include <fstream>
+#include <stdexcept>
+#include <algorithm>
+using std::cout;
+using std::endl;
+
+#include "GraphFactory.h"
+#include "reglc_graph.h"
+#include "DRegLC.h"
+#include "AspectTarget.h"
+#include "BidirectionalDRegLC.h"
+#include "ArcFlags.h"
+#include "AspectArcFlags.h"
+#include "AspectStorePreds.h"
+#include "AspectMaxCostPruning.h"
+#include "AspectMinCost.h"
+#include "StateLandmarks.h"
+#include "AspectTargetLandmark.h"
+#include "ContractionHierarchy.h"
+#include "Overlay.h"
+#include "HubLabels.h"
+#include "ItinerariesRequests.h"
+#include "Area.h"
+#include "node_filter_utils.h"
+
+#include <boost/archive/binary_oarchive.hpp>
+#include <boost/scoped_ptr.hpp>
+
+#include "SyntheticGraph.h"
+
+const int WIDTH = 50;
+const int HEIGHT = 50;
+const int DAY = 10;
+
+struct RoadMode {
+    std::string name;
+    EdgeMode edge_mode;
+    RLC::DFA dfa;
+};
+
+struct Query {
+    int source;
+    int target;
+};
+
+std::vector<Query> random_queries( const Transport::Graph * trans, const int num_queries )
+{
+    std::vector<Query> queries;
+    for(int i=0 ; i<num_queries ; ++i) {
+        Query q = { trans->internal_node( rand() % (WIDTH * HEIGHT) ), trans->internal_node( rand() % (WIDTH * HEIGHT) ) };
+        queries.push_back( q );
+    }
+    return queries;
+}
+
+/**
+ * Cost found by DRegLC, -1 if the target is not reachable
+ */
+int dreglc_cost( const RLC::Graph & g, const Query & q, const int departure = 0 )
+{
+    typedef RLC::AspectTarget<RLC::DRegLC> Algo;
+    Algo::ParamType p( RLC::DRegLCParams(&g, DAY), RLC::AspectTargetParams(q.target) );
+    Algo dij( p );
+    dij.add_source_node( RLC::Vertice(q.source, g.dfa.start_state), departure, 0 );
+    dij.run();
+    return dij.success ? dij.get_path_cost() : -1;
+}
+
+/**
+ * Name of a new empty file, to be removed by the caller
+ */
+std::string temporary_file()
+{
+    char name[] = "/tmp/check-road-engines-XXXXXX";
+    const int fd = mkstemp( name );
+    if(fd < 0)
+        throw std::runtime_error( "Unable to create a temporary file" );
+    close( fd );
+    return name;
+}
+
+/**
+ * Name of a new file holding a serialized archive that is not a preprocessing, to be removed by the caller
+ */
+std::string foreign_archive()
+{
+    const std::string filename = temporary_file();
+    std::ofstream ofile( filename.c_str() );
+    boost::archive::binary_oarchive oArchive( ofile );
+    oArchive << std::string( "#check-road-engines" );
+    return filename;
+}
+
+/**
+ * True if `load` refuses its file by throwing a std::runtime_error
+ */
+template<typename Load>
+bool rejects( Load load )
+{
+    try {
+        load();
+    } catch( const std::runtime_error & ) {
+        return true;
+    }
+    return false;
+}
+
+/**
+ * True if the cost is the reference one and, when the target was reached, the path reaches it at that cost
+ */
+bool consistent_result( const Transport::Graph * trans, const Query & q, const int cost, const Path & path, const int reference )
+{
+    if(cost != reference)
+        return false;
+    return cost < 0 || arrival_along( trans, path, q.source, q.target, 0, DAY ) == cost;
+}
+
+int report( const std::string & name, const std::string & mode, const int mismatches, const int num_queries )
+{
+    cout << name << " (" << mode << "): " << num_queries - mismatches << "/" << num_queries << " queries consistent" << endl;
+    return mismatches;
+}
+
+int check_bidirectional( RLC::Graph & g, const RoadMode & mode, const std::vector<Query> & queries, const std::vector<int> & reference )
+{
+    int mismatches = 0;
+    for(unsigned int i=0 ; i<queries.size() ; ++i) {
+        RLC::BidirectionalDRegLC bidirectional( &g, DAY, queries[i].source, queries[i].target );
+        bidirectional.run();
+        if(!consistent_result( g.transport, queries[i], bidirectional.cost(), bidirectional.get_path(), reference[i] ))
+            ++mismatches;
+    }
+    return report( "bidirectional", mode.name, mismatches, queries.size() );
+}
+
+/**
+ * The hierarchy is also saved and loaded back, which must refuse a graph with another id, another graph with the
+ * same id and a file of another kind
+ */
+int check_contraction_hierarchy( const CH::ContractionHierarchy & hierarchy, const Transport::Graph * other, const Transport::Graph * rebuilt, const RoadMode & mode, const std::vector<Query> & queries, const std::vector<int> & reference )
+{
+    const std::string filename = temporary_file();
+    const std::string foreign = foreign_archive();
+    hierarchy.save( filename );
+    const CH::ContractionHierarchy loaded( hierarchy.graph, filename );
+
+    int mismatches = 0;
+    if(loaded.mode != hierarchy.mode || loaded.num_shortcuts() != hierarchy.num_shortcuts()
+       || !rejects( [&]() { const CH::ContractionHierarchy h( other, filename ); } )
+       || !rejects( [&]() { const CH::ContractionHierarchy h( rebuilt, filename ); } )
+       || !rejects( [&]() { const CH::ContractionHierarchy h( hierarchy.graph, foreign ); } )) {
+        cout << "contraction hierarchy (" << mode.name << "): file not loaded back as saved" << endl;
+        ++mismatches;
+    }
+    remove( filename.c_str() );
+    remove( foreign.c_str() );
+
+    const CH::ContractionHierarchy * hierarchies[] = { &hierarchy, &loaded };
+    for(unsigned int i=0 ; i<queries.size() ; ++i) {
+        bool consistent = true;
+        BOOST_FOREACH( const CH::ContractionHierarchy * h, hierarchies ) {
+            boost::shared_ptr<CH::Query> query = h->acquire_query();
+            const int cost = query->run( queries[i].source, queries[i].target );
+            consistent = consistent && consistent_result( h->graph, queries[i], cost, query->get_path(), reference[i] );
+        }
+        if(!consistent)
+            ++mismatches;
+    }
+    return report( "contraction hierarchy", mode.name, mismatches, queries.size() );
+}
+
+/**
+ * The labels are also saved and mapped back, which must refuse a graph with another id, another graph with the same
+ * id, a file of another kind, a file with an unknown mode and a truncated file
+ */
+int check_hub_labels( const CH::ContractionHierarchy & hierarchy, const Transport::Graph * other, const Transport::Graph * rebuilt, const RoadMode & mode, const std::vector<Query> & queries, const std::vector<int> & reference )
+{
+    const CH::HubLabels labels( hierarchy );
+    const std::string filename = temporary_file();
+    labels.save( filename );
+
+    int mismatches = 0;
+    {
+        const CH::HubLabels mapped( hierarchy.graph, filename );
+        for(unsigned int i=0 ; i<queries.size() ; ++i) {
+            if(labels.distance( queries[i].source, queries[i].target ) != reference[i]
+               || mapped.distance( queries[i].source, queries[i].target ) != reference[i])
+                ++mismatches;
+        }
+        if(mapped.mode != labels.mode) {
+            cout << "hub labels (" << mode.name << "): mapped with another mode" << endl;
+            ++mismatches;
+        }
+    }
+
+    const std::string invalid = temporary_file();
+    {
+        std::ofstream ofile( invalid.c_str() );
+        ofile << std::string( 4096, 'x' );
+    }
+    // the mode follows the magic and the version in the header
+    const std::string unknown_mode = temporary_file();
+    {
+        std::ifstream saved( filename.c_str(), std::ios::binary );
+        std::ofstream ofile( unknown_mode.c_str(), std::ios::binary );
+        ofile << saved.rdbuf();
+        const boost::int32_t mode_value = Transport::CsrGraph::num_modes;
+        ofile.seekp( 12 );
+        ofile.write( reinterpret_cast<const char *>(&mode_value), sizeof(mode_value) );
+    }
+    if(!rejects( [&]() { const CH::HubLabels loaded( other, filename ); } )
+       || !rejects( [&]() { const CH::HubLabels loaded( rebuilt, filename ); } )
+       || !rejects( [&]() { const CH::HubLabels loaded( hierarchy.graph, invalid ); } )
+       || !rejects( [&]() { const CH::HubLabels loaded( hierarchy.graph, unknown_mode ); } )) {
+        cout << "hub labels (" << mode.name << "): file of another graph or kind mapped" << endl;
+        ++mismatches;
+    }
+    std::ifstream saved( filename.c_str(), std::ios::binary | std::ios::ate );
+    if(truncate( filename.c_str(), saved.tellg() / 2 ) != 0
+       || !rejects( [&]() { const CH::HubLabels loaded( hierarchy.graph, filename ); } )) {
+        cout << "hub labels (" << mode.name << "): truncated file mapped" << endl;
+        ++mismatches;
+    }
+    remove( filename.c_str() );
+    remove( invalid.c_str() );
+    remove( unknown_mode.c_str() );
+
+    // car_distance refuses the labels of another mode
+    if(mode.edge_mode != CarEdge) {
+        try {
+            car_distance( labels, 0, 1 );
+            cout << "hub labels (" << mode.name << "): used as car distances" << endl;
+            ++mismatches;
+        } catch( const std::invalid_argument & ) {
+        }
+    }
+    return report( "hub labels", mode.name, mismatches, queries.size() );
+}
+
+/**
+ * The partition is saved and loaded back, which must refuse a graph with another id, another graph with the same id
+ * and a file of another kind. The overlay is built on the loaded partition, keeping its own copy of it.
+ */
+int check_overlay( const Transport::Graph * trans, const Transport::Graph * other, const Transport::Graph * rebuilt, const RoadMode & mode, const std::vector<Query> & queries, const std::vector<int> & reference )
+{
+    std::vector<int> cell_sizes;
+    cell_sizes.push_back( 16 );
+    cell_sizes.push_back( 128 );
+    cell_sizes.push_back( 1024 );
+    const CH::Partition partition( trans, cell_sizes );
+    const std::string filename = temporary_file();
+    const std::string foreign = foreign_archive();
+    partition.save( filename );
+    const CH::Partition loaded( trans, filename );
+
+    int mismatches = 0;
+    bool same_cells = loaded.num_levels() == partition.num_levels();
+    for(int l=0 ; l<partition.num_levels() && same_cells ; ++l) {
+        same_cells = loaded.num_cells(l) == partition.num_cells(l);
+        for(int v=0 ; v<trans->num_vertices() && same_cells ; ++v)
+            same_cells = loaded.cell(l, v) == partition.cell(l, v);
+    }
+    if(!same_cells || !rejects( [&]() { const CH::Partition p( other, filename ); } )
+       || !rejects( [&]() { const CH::Partition p( rebuilt, filename ); } )
+       || !rejects( [&]() { const CH::Partition p( trans, foreign ); } )) {
+        cout << "overlay (" << mode.name << "): partition not loaded back as saved" << endl;
+        ++mismatches;
+    }
+    remove( filename.c_str() );
+    remove( foreign.c_str() );
+
+    CH::Overlay overlay( loaded, mode.edge_mode );
+    overlay.customize();
+
+    for(unsigned int i=0 ; i<queries.size() ; ++i) {
+        boost::shared_ptr<CH::OverlayQuery> query = overlay.acquire_query();
+        const int cost = query->run( queries[i].source, queries[i].target );
+        if(!consistent_result( trans, queries[i], cost, query->get_path(), reference[i] ))
+            ++mismatches;
+    }
+    return report( "overlay", mode.name, mismatches, queries.size() );
+}
+
+/**
+ * DFA with the states and transitions of `dfa`, each transition accepting the next mode instead of its own
+ */
+RLC::DFA other_modes( const RLC::DFA & dfa )
+{
+    RLC::DfaEdgeList edges;
+    boost::graph_traits<Graph_t>::edge_iterator it, end;
+    for(boost::tie(it, end) = boost::edges(dfa.graph) ; it != end ; ++it) {
+        const int mode = (dfa.graph[*it].type + 1) % Transport::CsrGraph::num_modes;
+        edges.push_back( RLC::DfaEdge(std::make_pair(boost::source(*it, dfa.graph), boost::target(*it, dfa.graph)), mode) );
+    }
+    return RLC::DFA( dfa.start_state, dfa.accepting_states, edges );
+}
+
+/**
+ * DRegLC pruned by the arc flags must find the cost of DRegLC, leaving at `departure` + 97 s per query.
+ * The flags are saved and loaded back, which must refuse a graph with another id, another graph with the same id,
+ * a DFA with another number of states or other transitions and a file of another kind. Queries use the loaded flags.
+ */
+int check_arc_flags( const RLC::Graph & g, const Transport::Graph * other, const Transport::Graph * rebuilt, const std::string & mode, const std::vector<Query> & queries, const int departure )
+{
+    typedef RLC::AspectArcFlags<RLC::AspectTarget<RLC::DRegLC>> Algo;
+    const RLC::ArcFlags built( g.transport, g.dfa, 256 );
+    const std::string filename = temporary_file();
+    const std::string foreign = foreign_archive();
+    built.save( filename );
+    const RLC::ArcFlags flags( g.transport, g.dfa, filename );
+
+    int mismatches = 0;
+    bool same_flags = flags.num_regions() == built.num_regions() && flags.num_flags() == built.num_flags();
+    for(int e=0 ; e<g.transport->csr().num_edges() && same_flags ; ++e) {
+        for(int r=0 ; r<built.num_regions() && same_flags ; ++r)
+            same_flags = flags.is_set(e, r) == built.is_set(e, r);
+    }
+    // bike_pt_dfa has three states, the checked DFAs one
+    if(!same_flags || !rejects( [&]() { const RLC::ArcFlags f( other, g.dfa, filename ); } )
+       || !rejects( [&]() { const RLC::ArcFlags f( rebuilt, g.dfa, filename ); } )
+       || !rejects( [&]() { const RLC::ArcFlags f( g.transport, RLC::bike_pt_dfa(), filename ); } )
+       || !rejects( [&]() { const RLC::ArcFlags f( g.transport, other_modes(g.dfa), filename ); } )
+       || !rejects( [&]() { const RLC::ArcFlags f( g.transport, g.dfa, foreign ); } )) {
+        cout << "arc flags (" << mode << "): file not loaded back as saved" << endl;
+        ++mismatches;
+    }
+    remove( filename.c_str() );
+    remove( foreign.c_str() );
+
+    for(unsigned int i=0 ; i<queries.size() ; ++i) {
+        const Query & q = queries[i];
+        const int query_departure = departure + 97 * i;
+        Algo::ParamType p( RLC::DRegLCParams(&g, DAY), RLC::AspectTargetParams(q.target), RLC::AspectArcFlagsParams(&flags, q.target) );
+        Algo dij( p );
+        dij.add_source_node( RLC::Vertice(q.source, g.dfa.start_state), query_departure, 0 );
+        dij.run();
+        if((dij.success ? dij.get_path_cost() : -1) != dreglc_cost( g, q, query_departure ))
+            ++mismatches;
+    }
+    return report( "arc flags", mode, mismatches, queries.size() );
+}
+
+/**
+ * Cost of a search on `g` from `from` in all its start states, -1 if the target of the algorithm is not reachable
+ */
+template<typename Algo>
+int search_cost( const typename Algo::ParamType & p, const RLC::AbstractGraph & g, const int from, const int time )
+{
+    Algo dij( p );
+    BOOST_FOREACH( const int q, g.dfa_start_states() ) {
+        dij.add_source_node( RLC::Vertice(from, q), time, 0 );
+    }
+    dij.run();
+    return dij.success ? dij.get_path_cost() : -1;
+}
+
+/**
+ * Number of queries for which DRegLC with another priority queue does not find the cost of the d-ary heap,
+ * leaving at `departure` + 97 s per query
+ */
+template<typename Algo>
+int queue_mismatches( const RLC::Graph & g, const std::vector<Query> & queries, const int departure )
+{
+    typedef RLC::AspectTarget<RLC::DRegLC> Reference;
+    int mismatches = 0;
+    for(unsigned int i=0 ; i<queries.size() ; ++i) {
+        const Query & q = queries[i];
+        const int query_departure = departure + 97 * i;
+        const int reference = search_cost<Reference>( Reference::ParamType(RLC::DRegLCParams(&g, DAY), RLC::AspectTargetParams(q.target)), g, q.source, query_departure );
+        const int cost = search_cost<Algo>( typename Algo::ParamType(RLC::DRegLCParams(&g, DAY), RLC::AspectTargetParams(q.target)), g, q.source, query_departure );
+        if(cost != reference)
+            ++mismatches;
+    }
+    return mismatches;
+}
+
+int check_queues( const RLC::Graph & g, const std::string & mode, const std::vector<Query> & queries, const int departure )
+{
+    return report( "radix heap", mode, queue_mismatches<RLC::AspectTarget<RLC::RadixDRegLC>>( g, queries, departure ), queries.size() )
+        + report( "lazy heap", mode, queue_mismatches<RLC::AspectTarget<RLC::LazyDRegLC>>( g, queries, departure ), queries.size() );
+}
+
+/**
+ * A decrease leaves the previous entry of the vertex in the lazy heap: neither it nor an entry of a vertex
+ * already popped may come out, on both kinds of workspaces
+ */
+int check_lazy_queue_drops_outdated()
+{
+    const RLC::Workspace::Mode modes[] = { RLC::Workspace::Dense, RLC::Workspace::Sparse };
+    int errors = 0;
+    BOOST_FOREACH( const RLC::Workspace::Mode workspace_mode, modes ) {
+        RLC::Workspace workspace( 3, 1, workspace_mode );
+        workspace.reset();
+        RLC::LazyQueue queue( workspace );
+        const RLC::Vertice a( 0, 0 ), b( 1, 0 ), c( 2, 0 );
+        queue.push( RLC::Label(a, 0, 30) );
+        queue.push( RLC::Label(b, 0, 20) );
+        queue.push( RLC::Label(c, 0, 40) );
+        queue.decrease( RLC::Label(a, 0, 10) );
+        queue.decrease( RLC::Label(c, 0, 15) );
+
+        // (a, 30) is still in the heap once a is popped, (c, 40) once every vertex is
+        const RLC::Label expected[] = { RLC::Label(a, 0, 10), RLC::Label(c, 0, 15), RLC::Label(b, 0, 20) };
+        bool consistent = true;
+        BOOST_FOREACH( const RLC::Label & l, expected ) {
+            consistent = consistent && !queue.empty() && queue.top().node == l.node && queue.top().cost == l.cost;
+            if(!queue.empty())
+                queue.pop();
+        }
+        if(!consistent || !queue.empty()) {
+            cout << "lazy heap: outdated entry popped" << endl;
+            ++errors;
+        }
+    }
+    return errors;
+}
+
+/**
+ * Edges of the predecessors stored by a search from the target back to the source, empty if it was not reached
+ */
+template<typename Algo>
+std::vector<int> stored_path( const Algo & dij, const RLC::Graph & g, const int target )
+{
+    std::vector<int> edges;
+    BOOST_FOREACH( const int s, g.dfa_accepting_states() ) {
+        RLC::Vertice v( target, s );
+        if(!dij.black(v))
+            continue;
+        for( ; dij.has_pred(v) ; v = g.source(dij.get_pred(v)) )
+            edges.push_back( dij.get_pred(v).first );
+    }
+    return edges;
+}
+
+/**
+ * Transport nodes of the labels settled by a search pruned at `max_cost` around the source, on a dense workspace,
+ * sorted
+ */
+template<typename Algo>
+std::vector<int> dense_area( const RLC::Graph & g, const int source, const int start_time, const int max_cost )
+{
+    Algo dij( typename Algo::ParamType(RLC::DRegLCParams(&g, 0, 1, RLC::Workspace::Dense), RLC::AspectMaxCostPruningParams(max_cost)) );
+    BOOST_FOREACH( const int q, g.dfa_start_states() ) {
+        dij.add_source_node( RLC::Vertice(source, q), start_time, 0 );
+    }
+    std::vector<int> nodes;
+    while( !dij.finished() ) {
+        nodes.push_back( dij.treat_next().node.first );
+    }
+    std::sort( nodes.begin(), nodes.end() );
+    return nodes;
+}
+
+/**
+ * Areas and isochrones are built on sparse workspaces, which grow while the search runs: they must hold the nodes
+ * the same search finds on a dense workspace. Paths stored on a sparse workspace must also be the dense ones.
+ */
+int check_sparse_workspace( const Transport::Graph * trans, const std::string & mode, const RLC::DFA & dfa, const std::vector<Query> & queries, const int time )
+{
+    typedef RLC::AspectMaxCostPruning<RLC::AspectMinCost<RLC::DRegLC>> MinCostAlgo;
+    typedef RLC::AspectMaxCostPruning<RLC::DRegLC> Algo;
+    typedef RLC::AspectStorePreds<RLC::AspectTarget<RLC::DRegLC>> PathAlgo;
+    const RLC::Graph g( trans, dfa );
+    const int max_costs[] = { 600, 3600 };
+
+    int mismatches = 0;
+    for(unsigned int i=0 ; i<queries.size() ; ++i) {
+        const Query & q = queries[i];
+        bool consistent = true;
+        BOOST_FOREACH( const int max_cost, max_costs ) {
+            const std::vector<int> min_cost_nodes = dense_area<MinCostAlgo>( g, q.source, 0, max_cost );
+            const std::vector<int> nodes = dense_area<Algo>( g, q.source, time, max_cost );
+
+            boost::scoped_ptr<Area> area( build_area_around_nodes(trans, std::vector<int>(1, q.source), max_cost, dfa) );
+            std::vector<int> area_nodes = area->get_nodes();
+            std::sort( area_nodes.begin(), area_nodes.end() );
+            area.reset( build_area_around_nodes_with_start_time(trans, std::vector<int>(1, q.source), time, max_cost, dfa) );
+            std::vector<int> timed_area_nodes = area->get_nodes();
+            std::sort( timed_area_nodes.begin(), timed_area_nodes.end() );
+            consistent = consistent && area_nodes == min_cost_nodes && timed_area_nodes == nodes;
+
+            boost::scoped_ptr<NodeSet> reached( isochrone(&g, q.source, max_cost) );
+            for(int v=0 ; v<trans->num_vertices() && consistent ; ++v)
+                consistent = reached->isIn(v) == std::binary_search( min_cost_nodes.begin(), min_cost_nodes.end(), v );
+        }
+
+        std::vector<int> paths[2];
+        int costs[2];
+        const RLC::Workspace::Mode workspace_modes[] = { RLC::Workspace::Dense, RLC::Workspace::Sparse };
+        for(int m=0 ; m<2 ; ++m) {
+            PathAlgo dij( PathAlgo::ParamType(RLC::DRegLCParams(&g, DAY, 1, workspace_modes[m]), RLC::AspectTargetParams(q.target)) );
+            BOOST_FOREACH( const int s, g.dfa_start_states() ) {
+                dij.add_source_node( RLC::Vertice(q.source, s), time, 0 );
+            }
+            dij.run();
+            costs[m] = dij.success ? dij.get_path_cost() : -1;
+            paths[m] = stored_path( dij, g, q.target );
+        }
+        consistent = consistent && costs[0] == costs[1] && paths[0] == paths[1];
+        if(!consistent)
+            ++mismatches;
+    }
+    return report( "sparse workspace", mode, mismatches, queries.size() );
+}
+
+template<typename B> using TargetPreds = RLC::AspectStorePreds<RLC::AspectTarget<B>>;
+
+/**
+ * Aspects composed at compile time must find the cost and path of the same aspects chained by virtual calls,
+ * leaving at `departure` + 97 s per query, with the d-ary and the radix heap
+ */
+int check_static_aspects( const RLC::Graph & g, const std::string & mode, const std::vector<Query> & queries, const int departure )
+{
+    typedef RLC::AspectStorePreds<RLC::AspectTarget<RLC::DRegLC>> VirtualAlgo;
+    typedef RLC::StaticDRegLC<TargetPreds> StaticAlgo;
+    int mismatches = 0;
+    for(unsigned int i=0 ; i<queries.size() ; ++i) {
+        const Query & q = queries[i];
+        const int query_departure = departure + 97 * i;
+        VirtualAlgo virtual_dij( VirtualAlgo::ParamType(RLC::DRegLCParams(&g, DAY), RLC::AspectTargetParams(q.target)) );
+        StaticAlgo static_dij( StaticAlgo::ParamType(RLC::DRegLCParams(&g, DAY), RLC::AspectTargetParams(q.target)) );
+        BOOST_FOREACH( const int s, g.dfa_start_states() ) {
+            virtual_dij.add_source_node( RLC::Vertice(q.source, s), query_departure, 0 );
+            static_dij.add_source_node( RLC::Vertice(q.source, s), query_departure, 0 );
+        }
+        virtual_dij.run();
+        static_dij.run();
+        bool consistent = virtual_dij.success == static_dij.success
+            && (!virtual_dij.success || virtual_dij.get_path_cost() == static_dij.get_path_cost())
+            && stored_path( virtual_dij, g, q.target ) == stored_path( static_dij, g, q.target );
+
+        typedef RLC::AspectTarget<RLC::RadixDRegLC> RadixAlgo;
+        typedef RLC::StaticDRegLC<RLC::AspectTarget, RLC::RadixQueue> StaticRadixAlgo;
+        consistent = consistent
+            && search_cost<RadixAlgo>( RadixAlgo::ParamType(RLC::DRegLCParams(&g, DAY), RLC::AspectTargetParams(q.target)), g, q.source, query_departure )
+               == search_cost<StaticRadixAlgo>( StaticRadixAlgo::ParamType(RLC::DRegLCParams(&g, DAY), RLC::AspectTargetParams(q.target)), g, q.source, query_departure );
+        if(!consistent)
+            ++mismatches;
+    }
+    return report( "static aspects", mode, mismatches, queries.size() );
+}
+
+/**
+ * DRegLC guided by state dependent landmarks on the corners of the grid must find the cost of DRegLC, forward
+ * from the source leaving at `time` + 97 s per query, and backward from the target arriving at the same time
+ */
+int check_state_landmarks( const Transport::Graph * trans, const std::string & mode, const RLC::DFA & dfa, const std::vector<Query> & queries, const int time )
+{
+    typedef RLC::AspectTarget<RLC::DRegLC> Algo;
+    typedef RLC::AspectTargetLandmark<RLC::DRegLC, RLC::StateLandmarks> LandmarkAlgo;
+
+    std::vector<int> corners;
+    corners.push_back( trans->internal_node( 0 ) );
+    corners.push_back( trans->internal_node( WIDTH - 1 ) );
+    corners.push_back( trans->internal_node( WIDTH * (HEIGHT - 1) ) );
+    corners.push_back( trans->internal_node( WIDTH * HEIGHT - 1 ) );
+    const RLC::StateLandmarks landmarks( trans, dfa, corners );
+
+    RLC::Graph g( trans, dfa );
+    RLC::BackwardGraph bg( &g );
+    int mismatches = 0;
+    for(unsigned int i=0 ; i<queries.size() ; ++i) {
+        const int query_time = time + 97 * i;
+        bool consistent = true;
+        for(int forward=0 ; forward<2 ; ++forward) {
+            const RLC::AbstractGraph * graph = forward ? (const RLC::AbstractGraph *) &g : (const RLC::AbstractGraph *) &bg;
+            const int from = forward ? queries[i].source : queries[i].target;
+            const int to = forward ? queries[i].target : queries[i].source;
+            const int reference = search_cost<Algo>( Algo::ParamType(RLC::DRegLCParams(graph, DAY), RLC::AspectTargetParams(to)), *graph, from, query_time );
+            const int cost = search_cost<LandmarkAlgo>( LandmarkAlgo::ParamType(RLC::DRegLCParams(graph, DAY),
+                    RLC::AspectTargetLandmarkParams<RLC::StateLandmarks>(to, &landmarks)), *graph, from, query_time );
+            consistent = consistent && cost == reference;
+        }
+        if(!consistent)
+            ++mismatches;
+    }
+    return report( "state landmarks", mode, mismatches, queries.size() );
+}
+
+/**
+ * The graph is saved in the mapped format and mapped back with the same edges, a copy of the file holding the
+ * head of an edge out of range must be refused
+ */
+int check_mapped_graph( Transport::GraphFactory * factory )
+{
+    const Transport::Graph * trans = factory->get();
+    const std::string filename = temporary_file();
+    factory->save_to_mmap( filename );
+    int errors = 0;
+    {
+        Transport::GraphFactory mapped_factory( filename, true );
+        const Transport::Graph * mapped = mapped_factory.get();
+        bool same_edges = mapped->num_vertices() == trans->num_vertices() && mapped->csr().num_edges() == trans->csr().num_edges();
+        for(int e=0 ; e<trans->csr().num_edges() && same_edges ; ++e)
+            same_edges = mapped->csr().head[e] == trans->csr().head[e] && mapped->csr().tail[e] == trans->csr().tail[e];
+        if(!same_edges) {
+            cout << "mapped graph: not mapped back as saved" << endl;
+            ++errors;
+        }
+    }
+
+    // offsets of the sections follow the magic, the version, the number of sections and the number of road and
+    // public transport edges; the heads are the fourth section
+    {
+        std::fstream file( filename.c_str(), std::ios::in | std::ios::out | std::ios::binary );
+        boost::uint64_t head_offset = 0;
+        file.seekg( 24 + 3 * sizeof(head_offset) );
+        file.read( reinterpret_cast<char *>(&head_offset), sizeof(head_offset) );
+        const int head = trans->num_vertices();
+        file.seekp( head_offset );
+        file.write( reinterpret_cast<const char *>(&head), sizeof(head) );
+    }
+    if(!rejects( [&]() { Transport::GraphFactory mapped_factory( filename, true ); } )) {
+        cout << "mapped graph: head out of range mapped" << endl;
+        ++errors;
+    }
+    remove( filename.c_str() );
+    return errors;
+}
+
+/**
+ * Public transport durations depend on the arrival time, unknown to the backward search
+ */
+int check_bidirectional_rejects_public_transport( const Transport::Graph * trans )
+{
+    RLC::Graph g( trans, RLC::pt_foot_dfa() );
+    try {
+        RLC::BidirectionalDRegLC bidirectional( &g, DAY, 0, 1 );
+    } catch( const std::invalid_argument & ) {
+        return 0;
+    }
+    cout << "bidirectional: public transport DFA accepted" << endl;
+    return 1;
+}
+
+/**
+ * An overlay is only queried once customized, with one duration per edge
+ */
+int check_overlay_rejects_misuse( const Transport::Graph * trans )
+{
+    CH::Overlay overlay( CH::Partition(trans, std::vector<int>(1, 16)), CarEdge );
+    int errors = 0;
+    try {
+        overlay.acquire_query()->run( 3, 500 );
+        cout << "overlay: queried before its customization" << endl;
+        ++errors;
+    } catch( const std::logic_error & ) {
+    }
+    try {
+        overlay.customize( std::vector<int>(1, 0) );
+        cout << "overlay: customized with too few durations" << endl;
+        ++errors;
+    } catch( const std::invalid_argument & ) {
+    }
+    return errors;
+}
+
+int main(int argc, char ** argv)
+{
+    const int num_queries = argc > 1 ? atoi(argv[1]) : 100;
+
+    Transport::GraphFactory * factory = synthetic_graph( WIDTH, HEIGHT, 12, 20 );
+    const Transport::Graph * trans = factory->get();
+
+    // files written for the graph must be refused by this one
+    Transport::GraphFactory * other_factory = synthetic_graph( 4, 4, 1, 3 );
+    other_factory->set_id( "other synthetic" );
+    const Transport::Graph * other = other_factory->get();
+
+    // nor can they fit another graph built under the same id, as when the graph is rebuilt from its database
+    Transport::GraphFactory * rebuilt_factory = synthetic_graph( 4, 4, 1, 3 );
+    const Transport::Graph * rebuilt = rebuilt_factory->get();
+
+    const RoadMode modes[] = {
+        { "car", CarEdge, RLC::car_dfa() },
+        { "bike", BikeEdge, RLC::bike_dfa() },
+        { "foot", FootEdge, RLC::foot_dfa() }
+    };
+
+    int mismatches = 0;
+    BOOST_FOREACH( const RoadMode & mode, modes ) {
+        RLC::Graph g( trans, mode.dfa );
+        srand( 7 );
+        const std::vector<Query> queries = random_queries( trans, num_queries );
+        std::vector<int> reference;
+        BOOST_FOREACH( const Query & q, queries ) {
+            reference.push_back( dreglc_cost(g, q) );
+        }
+
+        mismatches += check_bidirectional( g, mode, queries, reference );
+        const CH::ContractionHierarchy hierarchy( trans, mode.edge_mode );
+        mismatches += check_contraction_hierarchy( hierarchy, other, rebuilt, mode, queries, reference );
+        mismatches += check_hub_labels( hierarchy, other, rebuilt, mode, queries, reference );
+        mismatches += check_overlay( trans, other, rebuilt, mode, queries, reference );
+        mismatches += check_arc_flags( g, other, rebuilt, mode.name, queries, 0 );
+    }
+
+    // arc flags are also computed for the public transport DFAs, whose durations depend on the departure
+    RLC::Graph pt_graph( trans, RLC::pt_foot_dfa() );
+    srand( 7 );
+    mismatches += check_arc_flags( pt_graph, other, rebuilt, "public transport", random_queries(trans, num_queries), 6 * 3600 );
+
+    // DRegLC on the other priority queues
+    srand( 7 );
+    const std::vector<Query> queue_queries = random_queries( trans, num_queries );
+    const RLC::Graph car_graph( trans, RLC::car_dfa() );
+    mismatches += check_queues( car_graph, "car", queue_queries, 0 );
+    mismatches += check_queues( pt_graph, "public transport", queue_queries, 6 * 3600 );
+    mismatches += check_lazy_queue_drops_outdated();
+    mismatches += check_sparse_workspace( trans, "car", RLC::car_dfa(), queue_queries, 0 );
+    mismatches += check_sparse_workspace( trans, "public transport", RLC::pt_foot_dfa(), queue_queries, 6 * 3600 );
+    mismatches += check_static_aspects( car_graph, "car", queue_queries, 0 );
+    mismatches += check_static_aspects( pt_graph, "public transport", queue_queries, 6 * 3600 );
+
+    mismatches += check_mapped_graph( factory );
+    mismatches += check_bidirectional_rejects_public_transport( trans );
+    mismatches += check_overlay_rejects_misuse( trans );
+
+    srand( 7 );
+    const std::vector<Query> multimodal_queries = random_queries( trans, num_queries );
+    mismatches += check_state_landmarks( trans, "public transport", RLC::pt_foot_dfa(), multimodal_queries, 6 * 3600 );
+    mismatches += check_state_landmarks( trans, "bike and public transport", RLC::bike_pt_dfa(), multimodal_queries, 6 * 3600 );
+    mismatches += check_state_landmarks( trans, "public transport and car", RLC::pt_car_dfa(), multimodal_queries, 6 * 3600 );
+
+    delete rebuilt_factory;
+    delete other_factory;
+    delete factory;
+    return mismatches == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,192 @@
+/** Copyright : Arthur Bit-Monnot (2013)  arthur.bit-monnot@laas.fr
+
+This software is a computer program whose purpose is to [describe
+functionalities and technical features of your software].
+
+This software is governed by the CeCILL-B license under French law and
+abiding by the rules of distribution of free software.  You can  use, 
+modify and/ or redistribute the software under the terms of the CeCILL-B
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info". 
+
+As a counterpart to the access to the source code and  rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty  and the software's author,  the holder of the
+economic rights,  and the successive licensors  have only  limited
+liability. 
+
+In this respect, the user's attention is drawn to the risks associated
+with loading,  using,  modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean  that it is complicated to manipulate,  and  that  also
+therefore means  that it is reserved for developers  and  experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or 
+data to be ensured and,  more generally, to use and operate it in the 
+same conditions as regards security. 
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL-B license and that you accept its terms. 
+*/
+
+#ifndef SYNTHETIC_GRAPH_H
+#define SYNTHETIC_GRAPH_H
+
+#include <stdlib.h>
+#include <string>
+#include <vector>
+#include <boost/foreach.hpp>
+
+#include "GraphFactory.h"
+#include "../Interface/Path.h"
+
+/**
+ * Services of a line: 128 days, the last character being the first day (see Transport::Graph)
+ */
+inline std::string synthetic_services( const unsigned int seed )
+{
+    std::string services( 128, '0' );
+    for(int d=0 ; d<128 ; ++d) {
+        if(((seed >> (d % 7)) & 1) || d % 3 == 0)
+            services[127 - d] = '1';
+    }
+    return services;
+}
+
+/**
+ * Frequency window of the rides of a synthetic route (see DurationPT::append_frequency)
+ */
+struct SyntheticFrequency
+{
+    int start;
+    int end;
+    int duration;
+    std::string services;
+};
+
+/**
+ * Windows of every ride of the frequency route `r`. A faster window overlaps the morning peak of a longer one,
+ * the afternoon window overlaps its end and the evening window runs past midnight.
+ */
+inline std::vector<SyntheticFrequency> synthetic_frequencies( const int r )
+{
+    const int shift = (r * 7 % 30) * 60;
+    const SyntheticFrequency windows[] = {
+        { 5 * 3600 + shift, 12 * 3600 + shift, 240, synthetic_services(r * 4) },
+        { 7 * 3600 + shift, 9 * 3600 + shift, 150, synthetic_services(r * 4 + 1) },
+        { 11 * 3600 + shift, 20 * 3600 + shift, 200, synthetic_services(r * 4 + 2) },
+        { 21 * 3600 + shift, 27 * 3600 + shift, 300, synthetic_services(r * 4 + 3) }
+    };
+    return std::vector<SyntheticFrequency>( windows, windows + 4 );
+}
+
+/**
+ * Random graph for the consistency checks, identical from one run to the next.
+ *
+ * Nodes [0, width*height) are a street grid, each street having foot, bike and (most of the time) car edges in
+ * both directions. Each of the `routes` routes has `stops` stop nodes following a diagonal of the grid, linked to
+ * their street node by transfer edges. Subway, bus and tram routes alternate, each ride between two stops having
+ * 60 timetabled departures a day in each direction, running on days that differ from one departure to the next.
+ * The `frequency_routes` routes that follow are alike, their rides having the windows of synthetic_frequencies.
+ *
+ * The node ids are those of the factory, Transport::Graph::internal_node gives the ones used by the searches.
+ */
+inline Transport::GraphFactory * synthetic_graph( const int width, const int height, const int routes, const int stops,
+                                                  const int frequency_routes = 0 )
+{
+    srand( 42 );
+    const int streets = width * height;
+    Transport::GraphFactory * factory = new Transport::GraphFactory( streets + (routes + frequency_routes) * stops );
+    factory->set_id( "synthetic" );
+
+    for(int y=0 ; y<height ; ++y) {
+        for(int x=0 ; x<width ; ++x) {
+            const int n = y * width + x;
+            factory->set_coord( n, 1.0 + x * 0.001, 43.0 + y * 0.001 );
+            const int neighbours[2] = { x + 1 < width ? n + 1 : -1, y + 1 < height ? n + width : -1 };
+            BOOST_FOREACH( const int m, neighbours ) {
+                if(m < 0)
+                    continue;
+                const int length = 60 + rand() % 60;
+                factory->add_road_edge( n, m, FootEdge, length );
+                factory->add_road_edge( m, n, FootEdge, length );
+                factory->add_road_edge( n, m, BikeEdge, length / 3 );
+                factory->add_road_edge( m, n, BikeEdge, length / 3 );
+                if(rand() % 10)
+                    factory->add_road_edge( n, m, CarEdge, length / 6 + 1 );
+                if(rand() % 10)
+                    factory->add_road_edge( m, n, CarEdge, length / 6 + 1 );
+            }
+        }
+    }
+
+    for(int r=0 ; r<routes ; ++r) {
+        const EdgeMode mode = (EdgeMode) (SubwayEdge + r % 3);
+        const int first_stop = streets + r * stops;
+        const int start_x = rand() % width;
+        const int start_y = rand() % height;
+        for(int s=0 ; s<stops ; ++s) {
+            const int n = first_stop + s;
+            const int x = (start_x + s * 3) % width;
+            const int y = (start_y + s * 2) % height;
+            factory->set_coord( n, 1.0 + x * 0.001, 43.0 + y * 0.001 );
+            factory->add_public_transport_edge( y * width + x, n, 30, TransferEdge );
+            factory->add_public_transport_edge( n, y * width + x, 30, TransferEdge );
+            if(s + 1 == stops)
+                continue;
+            for(int t=0 ; t<60 ; ++t) {
+                const float departure = 4 * 3600 + t * 1500 + s * 240 + (r * 37) % 300;
+                factory->add_public_transport_edge( n, n + 1, TimetableDur, departure, departure + 200, 0,
+                                                    synthetic_services(r * 7 + t), mode );
+                factory->add_public_transport_edge( n + 1, n, TimetableDur, departure + 30, departure + 230, 0,
+                                                    synthetic_services(r * 5 + t), mode );
+            }
+        }
+    }
+
+    for(int r=0 ; r<frequency_routes ; ++r) {
+        const EdgeMode mode = (EdgeMode) (SubwayEdge + r % 3);
+        const int first_stop = streets + (routes + r) * stops;
+        const int start_x = rand() % width;
+        const int start_y = rand() % height;
+        for(int s=0 ; s<stops ; ++s) {
+            const int n = first_stop + s;
+            const int x = (start_x + s * 2) % width;
+            const int y = (start_y + s * 3) % height;
+            factory->set_coord( n, 1.0 + x * 0.001, 43.0 + y * 0.001 );
+            factory->add_public_transport_edge( y * width + x, n, 30, TransferEdge );
+            factory->add_public_transport_edge( n, y * width + x, 30, TransferEdge );
+            if(s + 1 == stops)
+                continue;
+            BOOST_FOREACH( const SyntheticFrequency & f, synthetic_frequencies(r) ) {
+                factory->add_public_transport_edge( n, n + 1, FrequencyDur, f.start, f.end, f.duration, f.services, mode );
+                factory->add_public_transport_edge( n + 1, n, FrequencyDur, f.start, f.end, f.duration, f.services, mode );
+            }
+        }
+    }
+    return factory;
+}
+
+/**
+ * Arrival time when following the edges of `path` from `source` at `departure` on `day`, taking the first
+ * departure of each timetabled edge. -1 if the edges do not form a path from `source` to `target`.
+ */
+inline int arrival_along( const Transport::Graph * graph, const Path & path, const int source, const int target,
+                          const int departure, const int day )
+{
+    int node = source;
+    int time = departure;
+    BOOST_FOREACH( const int e, path.edges ) {
+        if(graph->source(e) != node)
+            return -1;
+        const std::pair<bool, int> duration = graph->duration_forward( e, time, day );
+        if(!duration.first)
+            return -1;
+        time += duration.second;
+        node = graph->target(e);
+    }
+    return node == target ? time : -1;
+}
+
+#endif
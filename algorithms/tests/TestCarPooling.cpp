@@ -72,7 +72,7 @@ void run_test(std::string directory, const Transport::Graph * trans, int car_sta
     
     if( toulouse->isIn(passenger_start_node) ) {
         area_start = toulouse;
-        car_start_node = 209194;
+        car_start_node = trans->internal_node(209194);
     } else if( bordeaux->isIn(passenger_start_node) ) {
         area_start = bordeaux;
     } else {
@@ -81,7 +81,7 @@ void run_test(std::string directory, const Transport::Graph * trans, int car_sta
     
     if( toulouse->isIn(passenger_arrival_node) ) {
         area_dest = toulouse;
-        car_arrival_node = 209194;
+        car_arrival_node = trans->internal_node(209194);
     } else if( bordeaux->isIn(passenger_arrival_node) )
         area_dest = bordeaux;
     else
@@ -90,10 +90,10 @@ void run_test(std::string directory, const Transport::Graph * trans, int car_sta
     
     out->step_in();
     
-    out->add("car-start", car_start_node);
-    out->add("passenger-start", passenger_start_node);
-    out->add("car-arrival", car_arrival_node);
-    out->add("passenger-arrival", passenger_arrival_node);
+    out->add("car-start", trans->original_node(car_start_node));
+    out->add("passenger-start", trans->original_node(passenger_start_node));
+    out->add("car-arrival", trans->original_node(car_arrival_node));
+    out->add("passenger-arrival", trans->original_node(passenger_arrival_node));
     out->add("time", time);
     out->add("day", day);
     
@@ -143,7 +143,7 @@ void run_test(std::string directory, const Transport::Graph * trans, int car_sta
         out->step_in("node-details");
         {
             out->step_in("pass-arr");
-            out->add("node", passenger_arrival_node);
+            out->add("node", trans->original_node(passenger_arrival_node));
             out->step_in("5");
             out->add("cost", cs.get_cost(4, passenger_arrival_node));
             out->add("arrival", cs.arrival(4, passenger_arrival_node));
@@ -154,7 +154,7 @@ void run_test(std::string directory, const Transport::Graph * trans, int car_sta
         int drop_off = cs.get_source(4, passenger_arrival_node);
         {
             out->step_in("drop_off");
-            out->add("node", drop_off);
+            out->add("node", trans->original_node(drop_off));
             
             out->step_in("5");
             out->add("cost", cs.get_cost(4, drop_off));
@@ -177,7 +177,7 @@ void run_test(std::string directory, const Transport::Graph * trans, int car_sta
         int pick_up = cs.get_source(2, drop_off);
         {
             out->step_in("pick-up");
-            out->add("node", drop_off);
+            out->add("node", trans->original_node(drop_off));
             
             out->step_in("3");
             out->add("cost", cs.get_cost(2, pick_up));
@@ -254,7 +254,7 @@ void run_test(std::string directory, const Transport::Graph * trans, int car_sta
         out->step_in("node-details");
         {
             out->step_in("pass-arr");
-            out->add("node", passenger_arrival_node);
+            out->add("node", trans->original_node(passenger_arrival_node));
             out->step_in("5");
             out->add("cost", cs.get_cost(4, passenger_arrival_node));
             out->add("arrival", cs.arrival(4, passenger_arrival_node));
@@ -265,7 +265,7 @@ void run_test(std::string directory, const Transport::Graph * trans, int car_sta
         int drop_off = cs.get_source(4, passenger_arrival_node);
         {
             out->step_in("drop_off");
-            out->add("node", drop_off);
+            out->add("node", trans->original_node(drop_off));
             
             out->step_in("5");
             out->add("cost", cs.get_cost(4, drop_off));
@@ -288,7 +288,7 @@ void run_test(std::string directory, const Transport::Graph * trans, int car_sta
         int pick_up = cs.get_source(2, drop_off);
         {
             out->step_in("pick-up");
-            out->add("node", drop_off);
+            out->add("node", trans->original_node(drop_off));
             
             out->step_in("3");
             out->add("cost", cs.get_cost(2, pick_up));
@@ -367,7 +367,7 @@ void run_test(std::string directory, const Transport::Graph * trans, int car_sta
         out->step_in("node-details");
         {
             out->step_in("pass-arr");
-            out->add("node", passenger_arrival_node);
+            out->add("node", trans->original_node(passenger_arrival_node));
             out->step_in("5");
             out->add("cost", cs.get_cost(4, passenger_arrival_node));
             out->add("arrival", cs.arrival(4, passenger_arrival_node));
@@ -378,7 +378,7 @@ void run_test(std::string directory, const Transport::Graph * trans, int car_sta
         int drop_off = cs.get_source(4, passenger_arrival_node);
         {
             out->step_in("drop_off");
-            out->add("node", drop_off);
+            out->add("node", trans->original_node(drop_off));
             
             out->step_in("5");
             out->add("cost", cs.get_cost(4, drop_off));
@@ -401,7 +401,7 @@ void run_test(std::string directory, const Transport::Graph * trans, int car_sta
         int pick_up = cs.get_source(2, drop_off);
         {
             out->step_in("pick-up");
-            out->add("node", drop_off);
+            out->add("node", trans->original_node(drop_off));
             
             out->step_in("3");
             out->add("cost", cs.get_cost(2, pick_up));
@@ -484,7 +484,7 @@ void run_test(std::string directory, const Transport::Graph * trans, int car_sta
         out->step_in("node-details");
         {
             out->step_in("pass-arr");
-            out->add("node", passenger_arrival_node);
+            out->add("node", trans->original_node(passenger_arrival_node));
             out->step_in("5");
             out->add("cost", cs.get_cost(4, passenger_arrival_node));
             out->add("arrival", cs.arrival(4, passenger_arrival_node));
@@ -495,7 +495,7 @@ void run_test(std::string directory, const Transport::Graph * trans, int car_sta
         int drop_off = cs.get_source(4, passenger_arrival_node);
         {
             out->step_in("drop_off");
-            out->add("node", drop_off);
+            out->add("node", trans->original_node(drop_off));
             
             out->step_in("5");
             out->add("cost", cs.get_cost(4, drop_off));
@@ -518,7 +518,7 @@ void run_test(std::string directory, const Transport::Graph * trans, int car_sta
         int pick_up = cs.get_source(2, drop_off);
         {
             out->step_in("pick-up");
-            out->add("node", drop_off);
+            out->add("node", trans->original_node(drop_off));
             
             out->step_in("3");
             out->add("cost", cs.get_cost(2, pick_up));
@@ -598,7 +598,7 @@ void run_test(std::string directory, const Transport::Graph * trans, int car_sta
         out->step_in("node-details");
         {
             out->step_in("pass-arr");
-            out->add("node", passenger_arrival_node);
+            out->add("node", trans->original_node(passenger_arrival_node));
             out->step_in("5");
             out->add("cost", cs.get_cost(4, passenger_arrival_node));
             out->add("arrival", cs.arrival(4, passenger_arrival_node));
@@ -609,7 +609,7 @@ void run_test(std::string directory, const Transport::Graph * trans, int car_sta
         int drop_off = cs.get_source(4, passenger_arrival_node);
         {
             out->step_in("drop_off");
-            out->add("node", drop_off);
+            out->add("node", trans->original_node(drop_off));
             
             out->step_in("5");
             out->add("cost", cs.get_cost(4, drop_off));
@@ -632,7 +632,7 @@ void run_test(std::string directory, const Transport::Graph * trans, int car_sta
         int pick_up = cs.get_source(2, drop_off);
         {
             out->step_in("pick-up");
-            out->add("node", drop_off);
+            out->add("node", trans->original_node(drop_off));
             
             out->step_in("3");
             out->add("cost", cs.get_cost(2, pick_up));
@@ -729,6 +729,11 @@ void new_test(const Transport::Graph * g, bool from_bordeaux)
     }
     
     
+    // configurations are written with the ids of the input data
+    bordeaux1 = g->original_node(bordeaux1);
+    bordeaux2 = g->original_node(bordeaux2);
+    toulouse1 = g->original_node(toulouse1);
+    
     if( from_bordeaux )
         cout << bordeaux1 <<" "<< bordeaux2 <<" "<< toulouse1 <<" "<< albi <<" 32140 10 1 0" <<endl;
     else
@@ -839,14 +844,15 @@ int main(int argc, char ** argv)
       int landmarks_nodes[3] = { 269647, 546063, 294951 };
       std::vector<const Landmark *> lms;
       BOOST_FOREACH( int n, landmarks_nodes ) {
-        lms.push_back( RLC::create_car_landmark(transport, n) );
+        lms.push_back( RLC::create_car_landmark(transport, transport->internal_node(n)) );
       }
       lmset = new RLC::LandmarkSet( lms, transport );
       
     while ( !indata.eof() ) { // keep reading until end-of-file
       indata >> passenger_start_node >> car_start_node >> passenger_arrival_node >> car_arrival_node
 	     >> time >> day >> dfa_car >> dfa_passenger; 
-      run_test("1", transport, car_start_node, passenger_start_node, car_arrival_node, passenger_arrival_node, 
+      run_test("1", transport, transport->internal_node(car_start_node), transport->internal_node(passenger_start_node), 
+	       transport->internal_node(car_arrival_node), transport->internal_node(passenger_arrival_node), 
 	       time, day, *dfas[dfa_car], *dfas[dfa_passenger]);
     }
     
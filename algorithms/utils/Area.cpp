@@ -50,7 +50,7 @@ void Area::init_num_car_accessible()
 }
 
 
-Area * build_area_around ( const Transport::Graph* trans, int start, int end, int max_cost, DFA dfa )
+Area * build_area_around_nodes ( const Transport::Graph* trans, const std::vector<int> & sources, int max_cost, DFA dfa )
 {
     Area * area = new Area(trans, trans->num_vertices());
     
@@ -60,14 +60,14 @@ Area * build_area_around ( const Transport::Graph* trans, int start, int end, in
     typedef AspectMaxCostPruning<AspectMinCost<DRegLC> > Dij;
     
     Dij::ParamType p(
-        DRegLCParams( &g, 0, 1 ),
+        DRegLCParams( &g, 0, 1, Workspace::Sparse ),
         AspectMaxCostPruningParams( max_cost )
     );
     
     Dij dij( p );
-    for(int i=start ; i <= end ; ++i) {
+    BOOST_FOREACH( int source, sources ) {
         BOOST_FOREACH( int state, g.dfa_start_states() ) {
-            dij.add_source_node( RLC::Vertice(i, state), 0, 0 );
+            dij.add_source_node( RLC::Vertice(source, state), 0, 0 );
         }
     }
     while( !dij.finished() ) {
@@ -78,7 +78,25 @@ Area * build_area_around ( const Transport::Graph* trans, int start, int end, in
     return area;
 }
 
+Area * build_area_around ( const Transport::Graph* trans, int start, int end, int max_cost, DFA dfa )
+{
+    std::vector<int> sources;
+    for(int i=start ; i <= end ; ++i) {
+        sources.push_back( i );
+    }
+    return build_area_around_nodes( trans, sources, max_cost, dfa );
+}
+
 Area * build_area_around_with_start_time ( const Transport::Graph* trans, int start, int end, int start_time, int max_cost, DFA dfa )
+{
+    std::vector<int> sources;
+    for(int i=start ; i <= end ; ++i) {
+        sources.push_back( i );
+    }
+    return build_area_around_nodes_with_start_time( trans, sources, start_time, max_cost, dfa );
+}
+
+Area * build_area_around_nodes_with_start_time ( const Transport::Graph* trans, const std::vector<int> & sources, int start_time, int max_cost, DFA dfa )
 {
     Area * area = new Area(trans, trans->num_vertices());
     
@@ -88,14 +106,14 @@ Area * build_area_around_with_start_time ( const Transport::Graph* trans, int st
     typedef AspectMaxCostPruning<DRegLC> Dij;
     
     Dij::ParamType p(
-        DRegLCParams( &g, 0, 1 ),
+        DRegLCParams( &g, 0, 1, Workspace::Sparse ),
         AspectMaxCostPruningParams( max_cost )
     );
     
     Dij dij( p );
-    for(int i=start ; i <= end ; ++i) {
+    BOOST_FOREACH( int source, sources ) {
         BOOST_FOREACH( int state, g.dfa_start_states() ) {
-            dij.add_source_node( RLC::Vertice(i, state), start_time, 0 );
+            dij.add_source_node( RLC::Vertice(source, state), start_time, 0 );
         }
     }
     while( !dij.finished() ) {
@@ -108,32 +126,43 @@ Area * build_area_around_with_start_time ( const Transport::Graph* trans, int st
 
 /*** NOTE : the areas defined here after are dependent on the graph 
  * They are used for the `sud-ouest` configuration
+ * 
+ * Nodes ids are the ones of the input data, they are converted to the ones of the renumbered graph.
  */
 
+static Area * build_area_around_original ( const Transport::Graph* g, int start, int end, int max_cost )
+{
+    std::vector<int> sources;
+    for(int i=start ; i <= end ; ++i) {
+        sources.push_back( g->internal_node(i) );
+    }
+    return build_area_around_nodes( g, sources, max_cost, RLC::pt_foot_dfa() );
+}
+
 Area * toulouse_area ( const Transport::Graph* g )
 {
-    Area * area = build_area_around( g, 608327, 618191, 600);
+    Area * area = build_area_around_original( g, 608327, 618191, 600);
     area->init();
     return area;
 }
 
 Area * toulouse_area_small ( const Transport::Graph* g )
 {
-    Area * area = build_area_around( g, 608327, 618191, 600);
+    Area * area = build_area_around_original( g, 608327, 618191, 600);
     area->init();
     return area;
 }
 
 Area * bordeaux_area ( const Transport::Graph* g )
 {
-    Area * area = build_area_around( g, 618192, 629765, 600);
+    Area * area = build_area_around_original( g, 618192, 629765, 600);
     area->init();
     return area;
 }
 
 Area * bordeaux_area_small ( const Transport::Graph* g )
 {
-    Area * area = build_area_around( g, 629421, 629765, 600);
+    Area * area = build_area_around_original( g, 629421, 629765, 600);
     area->init();
     return area;
 }
@@ -92,9 +92,14 @@ private:
 };
 
 
+/**
+ * Builds the area of nodes reachable within `max_cost` from any node in [start, end] (ids of the graph)
+ */
 Area * build_area_around ( const Transport::Graph * g, int start, int end, int max_cost, RLC::DFA dfa = RLC::pt_foot_dfa() );
+Area * build_area_around_nodes ( const Transport::Graph * g, const std::vector<int> & sources, int max_cost, RLC::DFA dfa = RLC::pt_foot_dfa() );
 
 Area * build_area_around_with_start_time ( const Transport::Graph * g, int start, int end, int start_time, int max_cost, RLC::DFA dfa = RLC::pt_foot_dfa() );
+Area * build_area_around_nodes_with_start_time ( const Transport::Graph * g, const std::vector<int> & sources, int start_time, int max_cost, RLC::DFA dfa = RLC::pt_foot_dfa() );
 
 Area * toulouse_area ( const Transport::Graph * g );
 Area * toulouse_area_small ( const Transport::Graph * g );
@@ -4,8 +4,132 @@
 %{
  #include "node_filter_utils.h"
  #include "Area.h"
+
+/**
+ * Graph ids of nodes given with the ids of the input data
+ */
+static std::vector<int> internal_nodes( const Transport::Graph * trans, const std::vector<int> & nodes )
+{
+    std::vector<int> res;
+    for(unsigned int i=0 ; i<nodes.size() ; ++i) {
+        res.push_back( trans->internal_node(nodes[i]) );
+    }
+    return res;
+}
+
+/**
+ * Graph ids of the nodes whose ids in the input data are in [start, end]
+ */
+static std::vector<int> internal_range( const Transport::Graph * trans, const int start, const int end )
+{
+    std::vector<int> res;
+    for(int node=start ; node <= end ; ++node) {
+        res.push_back( trans->internal_node(node) );
+    }
+    return res;
+}
+
+static NodeList original_nodes( const Transport::Graph * trans, const NodeList & nodes )
+{
+    NodeList res;
+    for(NodeList::const_iterator it=nodes.begin() ; it!=nodes.end() ; ++it) {
+        res.push_back( trans->original_node(*it) );
+    }
+    return res;
+}
+
+/**
+ * Visualization with the node ids of the input data (edge ids are not renumbered)
+ */
+static VisualResult original_visualization( const Transport::Graph * trans, VisualResult vres )
+{
+    vres.a_nodes = original_nodes( trans, vres.a_nodes );
+    vres.b_nodes = original_nodes( trans, vres.b_nodes );
+    vres.c_nodes = original_nodes( trans, vres.c_nodes );
+    return vres;
+}
 %}
 
+// Python uses the node ids of the input data (see Transport::Graph::internal_node).
+// The isochrone filter is indexed by graph ids for the searches, only its visualization is exported.
+%ignore isochrone;
+%ignore show_isochrone;
+%rename(show_isochrone) original_show_isochrone;
+%ignore rectangle_containing;
+%rename(rectangle_containing) original_rectangle_containing;
+%ignore build_area_around;
+%rename(build_area_around) original_build_area_around;
+%ignore build_area_around_nodes;
+%rename(build_area_around_nodes) original_build_area_around_nodes;
+%ignore build_area_around_with_start_time;
+%rename(build_area_around_with_start_time) original_build_area_around_with_start_time;
+%ignore build_area_around_nodes_with_start_time;
+%rename(build_area_around_nodes_with_start_time) original_build_area_around_nodes_with_start_time;
+%ignore Area::nodes;
+%ignore Area::ns;
+%ignore Area::add_node;
+%ignore Area::get;
+%ignore Area::get_nodes;
+%ignore Area::isIn;
+%ignore Area::get_res;
+%rename(add_node) Area::original_add_node;
+%rename(get) Area::original_get;
+%rename(get_nodes) Area::original_get_nodes;
+%rename(isIn) Area::original_isIn;
+%rename(get_res) Area::original_get_res;
+
 // Parse the original header file
 %include "node_filter_utils.h"
-%include "Area.h"
\ No newline at end of file
+%include "Area.h"
+
+%extend Area {
+    void original_add_node( const int n ) { $self->add_node( $self->g->internal_node(n) ); }
+    int original_get( const int i ) const { return $self->g->original_node( $self->get(i) ); }
+    std::vector<int> original_get_nodes() const {
+        std::vector<int> res;
+        for(int i=0 ; i<$self->size() ; ++i) {
+            res.push_back( $self->g->original_node( $self->get(i) ) );
+        }
+        return res;
+    }
+    bool original_isIn( const int node ) const { return $self->isIn( $self->g->internal_node(node) ); }
+    VisualResult original_get_res() { return original_visualization( $self->g, $self->get_res() ); }
+}
+
+%inline %{
+VisualResult original_show_isochrone( const RLC::AbstractGraph * g, const int center, const int max_time )
+{
+    const Transport::Graph * trans = g->transport;
+    return original_visualization( trans, show_isochrone( g, trans->internal_node(center), max_time ) );
+}
+
+BBNodeFilter * original_rectangle_containing( const Transport::Graph * trans, const int node1, const int node2, const float margin )
+{
+    return rectangle_containing( trans, trans->internal_node(node1), trans->internal_node(node2), margin );
+}
+
+BBNodeFilter * original_rectangle_containing( const Transport::Graph * trans, const std::vector<int> nodes, const float margin )
+{
+    return rectangle_containing( trans, internal_nodes(trans, nodes), margin );
+}
+
+Area * original_build_area_around( const Transport::Graph * g, int start, int end, int max_cost, RLC::DFA dfa = RLC::pt_foot_dfa() )
+{
+    return build_area_around_nodes( g, internal_range(g, start, end), max_cost, dfa );
+}
+
+Area * original_build_area_around_nodes( const Transport::Graph * g, const std::vector<int> & sources, int max_cost, RLC::DFA dfa = RLC::pt_foot_dfa() )
+{
+    return build_area_around_nodes( g, internal_nodes(g, sources), max_cost, dfa );
+}
+
+Area * original_build_area_around_with_start_time( const Transport::Graph * g, int start, int end, int start_time, int max_cost, RLC::DFA dfa = RLC::pt_foot_dfa() )
+{
+    return build_area_around_nodes_with_start_time( g, internal_range(g, start, end), start_time, max_cost, dfa );
+}
+
+Area * original_build_area_around_nodes_with_start_time( const Transport::Graph * g, const std::vector<int> & sources, int start_time, int max_cost, RLC::DFA dfa = RLC::pt_foot_dfa() )
+{
+    return build_area_around_nodes_with_start_time( g, internal_nodes(g, sources), start_time, max_cost, dfa );
+}
+%}
@@ -45,7 +45,7 @@ NodeSet * isochrone ( const RLC::AbstractGraph * g, const int center, const int
     NodeSet * ns = new NodeSet( g->transport->num_vertices() );
     
     Dij::ParamType p(
-        DRegLCParams( g, 0, 1 ),
+        DRegLCParams( g, 0, 1, Workspace::Sparse ),
         AspectMaxCostPruningParams( max_time )
     );
     
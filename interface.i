@@ -4,6 +4,22 @@
 %include "std_vector.i"
 %include "std_list.i"
 %include "std_set.i"
+%include "exception.i"
+
+%{
+#include <stdexcept>
+%}
+
+// Errors of the C++ code are raised as Python exceptions instead of aborting the interpreter
+%exception {
+    try {
+        $action
+    } catch( const std::invalid_argument & e ) {
+        SWIG_exception( SWIG_ValueError, e.what() );
+    } catch( const std::exception & e ) {
+        SWIG_exception( SWIG_RuntimeError, e.what() );
+    }
+}
 
 %include lib/core/mumoro.i
 %include algorithms/interface.i
\ No newline at end of file
@@ -0,0 +1,131 @@
+/** Copyright : Arthur Bit-Monnot (2013)  arthur.bit-monnot@laas.fr
+
+This software is a computer program whose purpose is to [describe
+functionalities and technical features of your software].
+
+This software is governed by the CeCILL-B license under French law and
+abiding by the rules of distribution of free software.  You can  use, 
+modify and/ or redistribute the software under the terms of the CeCILL-B
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info". 
+
+As a counterpart to the access to the source code and  rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty  and the software's author,  the holder of the
+economic rights,  and the successive licensors  have only  limited
+liability. 
+
+In this respect, the user's attention is drawn to the risks associated
+with loading,  using,  modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean  that it is complicated to manipulate,  and  that  also
+therefore means  that it is reserved for developers  and  experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or 
+data to be ensured and,  more generally, to use and operate it in the 
+same conditions as regards security. 
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL-B license and that you accept its terms. 
+*/
+
+#include "csr_graph.h"
+
+#include <limits>
+#include <stdexcept>
+
+namespace Transport {
+
+namespace {
+/**
+ * Fills the per mode offsets of a node whose edges in [begin, end) are sorted by mode.
+ * `edge_at(i)` gives the id of the i-th edge of the range.
+ */
+template<typename EdgeAt>
+void fill_mode_offsets( const std::vector<unsigned char> & type, const int begin, const int end,
+                        EdgeAt edge_at, boost::uint16_t * offsets )
+{
+    // Offsets are 16 bits wide: a larger degree would wrap them and corrupt the ranges of the node
+    if( end - begin > std::numeric_limits<boost::uint16_t>::max() )
+        throw std::runtime_error( "A node has too many edges to be frozen" );
+    
+    int i = begin;
+    for(int m=0 ; m<CsrGraph::num_modes ; ++m) {
+        while(i < end && type[edge_at(i)] < m)
+            ++i;
+        offsets[m] = i - begin;
+    }
+}
+
+struct Identity {
+    inline int operator()( const int i ) const { return i; }
+};
+
+struct InEdgeAt {
+    const std::vector<int> & in_edge_id;
+    InEdgeAt( const std::vector<int> & ids ) : in_edge_id(ids) {}
+    inline int operator()( const int i ) const { return in_edge_id[i]; }
+};
+}
+
+void CsrGraph::build( std::vector<int> & first_out, std::vector<int> & head, std::vector<int> & tail,
+                      std::vector<unsigned char> & type, std::vector<int> & duration_index )
+{
+    const int n = first_out.size() - 1;
+    const int m = head.size();
+    
+    std::vector<boost::uint16_t> out_mode_offset( n * num_modes );
+    for(int v=0 ; v<n ; ++v) {
+        fill_mode_offsets( type, first_out[v], first_out[v+1], Identity(), &out_mode_offset[v * num_modes] );
+    }
+    
+    std::vector<int> first_in( n + 1, 0 );
+    for(int e=0 ; e<m ; ++e) {
+        first_in[ head[e] + 1 ]++;
+    }
+    for(int v=0 ; v<n ; ++v) {
+        first_in[v+1] += first_in[v];
+    }
+    
+    // Edges are bucketed by mode first, then by target. Inside the range of a node, in-edges
+    // thus end up sorted by mode and, for a given mode, by increasing id.
+    std::vector<int> next( first_in.begin(), first_in.end() - 1 );
+    std::vector<int> in_edge_id( m );
+    for(int mode=0 ; mode<num_modes ; ++mode) {
+        for(int e=0 ; e<m ; ++e) {
+            if(type[e] == mode)
+                in_edge_id[ next[head[e]]++ ] = e;
+        }
+    }
+    
+    std::vector<boost::uint16_t> in_mode_offset( n * num_modes );
+    for(int v=0 ; v<n ; ++v) {
+        fill_mode_offsets( type, first_in[v], first_in[v+1], InEdgeAt(in_edge_id), &in_mode_offset[v * num_modes] );
+    }
+    
+    this->first_out.assign( first_out );
+    this->head.assign( head );
+    this->tail.assign( tail );
+    this->type.assign( type );
+    this->duration_index.assign( duration_index );
+    this->first_in.assign( first_in );
+    this->in_edge_id.assign( in_edge_id );
+    this->out_mode_offset.assign( out_mode_offset );
+    this->in_mode_offset.assign( in_mode_offset );
+}
+
+void CsrGraph::clear()
+{
+    first_out.clear();
+    head.clear();
+    tail.clear();
+    type.clear();
+    duration_index.clear();
+    first_in.clear();
+    in_edge_id.clear();
+    out_mode_offset.clear();
+    in_mode_offset.clear();
+}
+
+} // end namespace Transport
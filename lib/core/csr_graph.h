@@ -0,0 +1,154 @@
+/** Copyright : Arthur Bit-Monnot (2013)  arthur.bit-monnot@laas.fr
+
+This software is a computer program whose purpose is to [describe
+functionalities and technical features of your software].
+
+This software is governed by the CeCILL-B license under French law and
+abiding by the rules of distribution of free software.  You can  use, 
+modify and/ or redistribute the software under the terms of the CeCILL-B
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info". 
+
+As a counterpart to the access to the source code and  rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty  and the software's author,  the holder of the
+economic rights,  and the successive licensors  have only  limited
+liability. 
+
+In this respect, the user's attention is drawn to the risks associated
+with loading,  using,  modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean  that it is complicated to manipulate,  and  that  also
+therefore means  that it is reserved for developers  and  experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or 
+data to be ensured and,  more generally, to use and operate it in the 
+same conditions as regards security. 
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL-B license and that you accept its terms. 
+*/
+
+#ifndef CSR_GRAPH_H
+#define CSR_GRAPH_H
+
+#include <vector>
+#include <boost/cstdint.hpp>
+
+#include "flat_array.h"
+
+namespace Transport {
+
+/**
+ * Frozen, read-only adjacency of the transport graph in compressed sparse row format.
+ *
+ * Edges are numbered by source node: out-edges of node `n` are the edges with ids in
+ * [first_out[n], first_out[n+1]). The id of an edge is therefore its slot in the forward arrays
+ * (`head`, `tail`, `type` and `duration_index` are all indexed by edge id).
+ *
+ * In-edges of node `n` are `in_edge_id[first_in[n]]` ... `in_edge_id[first_in[n+1]-1]`.
+ *
+ * Both the out-edges and the in-edges of a node are grouped by EdgeMode. A small table of offsets
+ * (relative to the first edge of the node) gives the range of each mode, which allows to only touch
+ * the edges accepted by a DFA state.
+ *
+ * Every array is contiguous, which avoids the pointer chasing of the boost adjacency list in the
+ * search algorithms, and can be mapped from a file as is.
+ */
+class CsrGraph
+{
+public:
+    /**
+     * Number of EdgeMode that can be carried by an edge (WhateverEdge excluded)
+     */
+    static const int num_modes = 8;
+
+    /**
+     * Forward adjacency (size: num_vertices + 1)
+     */
+    FlatArray<int> first_out;
+
+    /**
+     * Target node of each edge
+     */
+    FlatArray<int> head;
+
+    /**
+     * Source node of each edge
+     */
+    FlatArray<int> tail;
+
+    /**
+     * EdgeMode of each edge
+     */
+    FlatArray<unsigned char> type;
+
+    /**
+     * Index of the duration of each edge: road edges come first (index in road_durations),
+     * followed by public transport ones (num_road_edges + index in pt_durations)
+     */
+    FlatArray<int> duration_index;
+
+    /**
+     * Reverse adjacency (size: num_vertices + 1)
+     */
+    FlatArray<int> first_in;
+
+    /**
+     * Id of the edges in the reverse adjacency
+     */
+    FlatArray<int> in_edge_id;
+
+    /**
+     * Offset, relative to first_out[n], of the first out-edge of node n with mode m
+     * is out_mode_offset[n * num_modes + m] (size: num_vertices * num_modes)
+     */
+    FlatArray<boost::uint16_t> out_mode_offset;
+
+    /**
+     * Same as out_mode_offset for in-edges, relative to first_in[n]
+     */
+    FlatArray<boost::uint16_t> in_mode_offset;
+
+    inline int num_vertices() const { return first_out.empty() ? 0 : first_out.size() - 1; }
+    inline int num_edges() const { return head.size(); }
+
+    inline int out_begin( const int node ) const { return first_out[node]; }
+    inline int out_end( const int node ) const { return first_out[node+1]; }
+    inline int in_begin( const int node ) const { return first_in[node]; }
+    inline int in_end( const int node ) const { return first_in[node+1]; }
+
+    /**
+     * Range of the out-edges (resp. in-edges) of a node restricted to a given mode.
+     * `mode` must be lower than num_modes.
+     */
+    inline int out_begin( const int node, const int mode ) const {
+        return first_out[node] + out_mode_offset[node * num_modes + mode];
+    }
+    inline int out_end( const int node, const int mode ) const {
+        return mode + 1 < num_modes ? out_begin(node, mode + 1) : first_out[node+1];
+    }
+    inline int in_begin( const int node, const int mode ) const {
+        return first_in[node] + in_mode_offset[node * num_modes + mode];
+    }
+    inline int in_end( const int node, const int mode ) const {
+        return mode + 1 < num_modes ? in_begin(node, mode + 1) : first_in[node+1];
+    }
+
+    /**
+     * Sets the forward adjacency (the vectors are emptied) then builds the per mode offsets and the
+     * reverse adjacency from it.
+     *
+     * Out-edges of every node are expected to be already sorted by mode.
+     * Throws std::runtime_error if a node has more than 65535 in-edges or out-edges.
+     */
+    void build( std::vector<int> & first_out, std::vector<int> & head, std::vector<int> & tail,
+                std::vector<unsigned char> & type, std::vector<int> & duration_index );
+
+    void clear();
+};
+
+} // end namespace Transport
+
+#endif
@@ -0,0 +1,135 @@
+/** Copyright : Arthur Bit-Monnot (2013)  arthur.bit-monnot@laas.fr
+
+This software is a computer program whose purpose is to [describe
+functionalities and technical features of your software].
+
+This software is governed by the CeCILL-B license under French law and
+abiding by the rules of distribution of free software.  You can  use, 
+modify and/ or redistribute the software under the terms of the CeCILL-B
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info". 
+
+As a counterpart to the access to the source code and  rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty  and the software's author,  the holder of the
+economic rights,  and the successive licensors  have only  limited
+liability. 
+
+In this respect, the user's attention is drawn to the risks associated
+with loading,  using,  modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean  that it is complicated to manipulate,  and  that  also
+therefore means  that it is reserved for developers  and  experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or 
+data to be ensured and,  more generally, to use and operate it in the 
+same conditions as regards security. 
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL-B license and that you accept its terms. 
+*/
+
+#ifndef FLAT_ARRAY_H
+#define FLAT_ARRAY_H
+
+#include <vector>
+#include <cstddef>
+
+namespace Transport {
+
+/**
+ * Read-only contiguous array used by the frozen representation of the graph.
+ *
+ * Data is either owned (when the graph is built in memory) or borrowed from a memory mapped file
+ * (see MappedFile) in which case nothing is copied. Elements must hence be plain old data.
+ */
+template<typename T>
+class FlatArray
+{
+public:
+    FlatArray() : ptr(NULL), count(0) {}
+
+    FlatArray( const FlatArray & other ) : ptr(NULL), count(0) { *this = other; }
+
+    FlatArray & operator=( const FlatArray & other ) {
+        if(this == &other)
+            return *this;
+        storage = other.storage;
+        ptr = other.owned() ? storage.data() : other.ptr;
+        count = other.count;
+        return *this;
+    }
+
+    /**
+     * Takes ownership of the content of `values`, which is left empty
+     */
+    void assign( std::vector<T> & values ) {
+        storage.clear();
+        storage.swap( values );
+        ptr = storage.data();
+        count = storage.size();
+    }
+
+    /**
+     * Makes the array point to external memory that must outlive it
+     */
+    void borrow( const T * data, const size_t size ) {
+        std::vector<T>().swap( storage );
+        ptr = data;
+        count = size;
+    }
+
+    void clear() {
+        std::vector<T>().swap( storage );
+        ptr = NULL;
+        count = 0;
+    }
+
+    inline bool owned() const { return ptr == NULL || ptr == storage.data(); }
+
+    inline const T & operator[]( const size_t i ) const { return ptr[i]; }
+    inline const T * data() const { return ptr; }
+    inline const T * begin() const { return ptr; }
+    inline const T * end() const { return ptr + count; }
+    inline size_t size() const { return count; }
+    inline bool empty() const { return count == 0; }
+
+private:
+    std::vector<T> storage;
+    const T * ptr;
+    size_t count;
+};
+
+/**
+ * Tells if `first` can be used as offsets into an array of `count` elements:
+ * it starts at 0, never decreases and ends at `count`
+ */
+template<typename Offsets>
+bool valid_offsets( const Offsets & first, const size_t count )
+{
+    if(first.size() == 0 || first[0] != 0 || (size_t) first[first.size() - 1] != count)
+        return false;
+    for(size_t i=1 ; i<first.size() ; ++i) {
+        if(first[i] < first[i-1])
+            return false;
+    }
+    return true;
+}
+
+/**
+ * Tells if every value is a valid index into an array of `bound` elements
+ */
+template<typename Values>
+bool all_below( const Values & values, const size_t bound )
+{
+    for(size_t i=0 ; i<values.size() ; ++i) {
+        if(values[i] < 0 || (size_t) values[i] >= bound)
+            return false;
+    }
+    return true;
+}
+
+} // end namespace Transport
+
+#endif
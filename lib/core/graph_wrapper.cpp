@@ -37,10 +37,14 @@ knowledge of the CeCILL-B license and that you accept its terms. */
 #include "graph_wrapper.h"
 #include <iostream>
 #include <fstream>
+#include <algorithm>
 #include <boost/graph/dijkstra_shortest_paths.hpp>
 #include <boost/graph/adj_list_serialize.hpp>
 #include <boost/foreach.hpp>
 #include <boost/assert.hpp>
+#include <stdexcept>
+#include <cstring>
+#include <limits>
 
 using namespace std;
 
@@ -49,7 +53,24 @@ namespace boost
     namespace serialization
     {
         template <class Archive>
-        void save(Archive &ar, const Time &t, const unsigned int version)
+        void serialize(Archive &ar, Time &t, const unsigned int version)
+        {
+            ar & boost::get<0>(t);
+            ar & boost::get<1>(t);
+            ar & boost::get<2>(t);
+        }
+
+        template <class Archive>
+        void serialize(Archive &ar, Frequency &t, const unsigned int version)
+        {
+            ar & boost::get<0>(t);
+            ar & boost::get<1>(t);
+            ar & boost::get<2>(t);
+            ar & boost::get<3>(t);
+        }
+
+        template <class Archive>
+        void save(Archive &ar, const LegacyTime &t, const unsigned int version)
         {
             ar << boost::get<0>(t);
             ar << boost::get<1>(t);
@@ -58,7 +79,7 @@ namespace boost
         }
 
         template <class Archive>
-        void load(Archive &ar, Time &t, const unsigned int version)
+        void load(Archive &ar, LegacyTime &t, const unsigned int version)
         {
             ar >> boost::get<0>(t);
             ar >> boost::get<1>(t);
@@ -68,13 +89,13 @@ namespace boost
         }
 
         template <class Archive>
-        void serialize(Archive &ar, Time &t, const unsigned int version)
+        void serialize(Archive &ar, LegacyTime &t, const unsigned int version)
         {
                 boost::serialization::split_free(ar, t, version);
         }
 
         template <class Archive>
-        void save(Archive &ar, const Frequency &t, const unsigned int version)
+        void save(Archive &ar, const LegacyFrequency &t, const unsigned int version)
         {
             ar << boost::get<0>(t);
             ar << boost::get<1>(t);
@@ -84,7 +105,7 @@ namespace boost
         }
 
         template <class Archive>
-        void load(Archive &ar, Frequency &t, const unsigned int version)
+        void load(Archive &ar, LegacyFrequency &t, const unsigned int version)
         {
             ar >> boost::get<0>(t);
             ar >> boost::get<1>(t);
@@ -95,7 +116,7 @@ namespace boost
         }
 
         template <class Archive>
-        void serialize(Archive &ar, Frequency &t, const unsigned int version)
+        void serialize(Archive &ar, LegacyFrequency &t, const unsigned int version)
         {
                 boost::serialization::split_free(ar, t, version);
         }
@@ -147,9 +168,16 @@ Edge::Edge(const bool road_edge, const int index, const EdgeMode type) : road_ed
 
 namespace Transport {
 
+/**
+ * Written at the beginning of archives holding a services patterns table
+ */
+const std::string SERVICES_ARCHIVE_TAG = "#mumoro-services-patterns";
+
 Graph::Graph(const std::string & filename, bool from_bin)
 {
-    if(from_bin)
+    if(from_bin && is_mmap_file(filename))
+        load_from_mmap(filename);
+    else if(from_bin)
         load_from_bin(filename);
     else
         load_from_txt(filename);
@@ -196,9 +224,9 @@ bool Graph::add_public_transport_edge ( int source, int target, DurationType dur
     int index = g[e].index;
     
     if(dur_type == TimetableDur)
-        pt_durations[index].append_timetable(start, arrival, services);
+        pt_durations[index].append_timetable(start, arrival, services_id(services));
     else if(dur_type == FrequencyDur)
-        pt_durations[index].append_frequency(start, arrival, duration, services);
+        pt_durations[index].append_frequency(start, arrival, duration, services_id(services));
     else if(dur_type == ConstDur)
         pt_durations[index].const_duration = duration;
     
@@ -214,11 +242,66 @@ bool Graph::add_public_transport_edge ( int source, int target, const int durati
 
 
 
+ServiceId Graph::services_id ( const string& services )
+{
+    std::map<std::string, ServiceId>::const_iterator it = services_ids.find(services);
+    if(it != services_ids.end())
+        return it->second;
+    
+    // ids are 16 bits wide: a wrapped id would make trips run on the days of another pattern
+    if( services_patterns.size() > std::numeric_limits<ServiceId>::max() )
+        throw std::runtime_error( "Too many services patterns" );
+    const ServiceId id = services_patterns.size();
+    services_patterns.push_back(Services(services));
+    services_ids[services] = id;
+    return id;
+}
+
+void Graph::register_legacy_services()
+{
+    for(uint i=0 ; i<pt_durations.size() ; ++i) {
+        DurationPT & dur = pt_durations[i];
+        for(uint j=0 ; j<dur.legacy_timetable.size() ; ++j) {
+            const LegacyTime & t = dur.legacy_timetable[j];
+            dur.timetable.push_back(Time(get<0>(t), get<1>(t), services_id(get<2>(t).to_string())));
+        }
+        for(uint j=0 ; j<dur.legacy_frequencies.size() ; ++j) {
+            const LegacyFrequency & f = dur.legacy_frequencies[j];
+            dur.frequencies.push_back(Frequency(get<0>(f), get<1>(f), get<2>(f), services_id(get<3>(f).to_string())));
+        }
+        std::vector<LegacyTime>().swap(dur.legacy_timetable);
+        std::vector<LegacyFrequency>().swap(dur.legacy_frequencies);
+    }
+}
+
+std::vector<boost::uint64_t> Graph::services_words() const
+{
+    const Services low_mask( ~0ULL );
+    std::vector<boost::uint64_t> words;
+    for(uint i=0 ; i<services_patterns.size() ; ++i) {
+        words.push_back( (services_patterns[i] & low_mask).to_ullong() );
+        words.push_back( (services_patterns[i] >> 64).to_ullong() );
+    }
+    return words;
+}
+
+void Graph::set_services_words(const std::vector<boost::uint64_t> & words)
+{
+    services_patterns.clear();
+    services_ids.clear();
+    for(uint i=0 ; i+1<words.size() ; i+=2) {
+        const Services s = (Services(words[i+1]) << 64) | Services(words[i]);
+        services_ids[s.to_string()] = services_patterns.size();
+        services_patterns.push_back(s);
+    }
+}
+
 void Graph::preprocess()
 {
     sort();
-    init_edge_indexes();
+    // the frozen durations copy the minimums
     compute_min_durations();
+    freeze();
 }
    
 void Graph::sort()
@@ -235,13 +318,78 @@ void Graph::compute_min_durations()
     }
 }
 
-void Graph::init_edge_indexes()
+void Graph::freeze()
 {
-    edges_vec.resize(num_pt_edges + num_road_edges);
-
-    BOOST_FOREACH(edge_t e, boost::edges(g)) {
-        edges_vec[ edgeIndex(e) ] = e;
+    BOOST_ASSERT( !mapped_file && "A graph mapped from a file can not be modified" );
+    
+    const int n = boost::num_vertices(g);
+    const int m = boost::num_edges(g);
+    
+    std::vector<int> original_ids(node_order), internal_ids(n);
+    if(original_ids.empty()) {
+        for(int v=0 ; v<n ; ++v)
+            original_ids.push_back(v);
+    }
+    BOOST_ASSERT( (int) original_ids.size() == n );
+    for(int v=0 ; v<n ; ++v) {
+        internal_ids[original_ids[v]] = v;
+    }
+    
+    std::vector<int> first_out, head, tail, dur_index;
+    std::vector<unsigned char> type;
+    first_out.reserve(n + 1);
+    head.reserve(m);
+    tail.reserve(m);
+    type.reserve(m);
+    dur_index.reserve(m);
+    
+    // out-edges of a node are grouped by mode, ties are kept in insertion order
+    std::vector< std::pair<int, int> > mode_rank;
+    std::vector<edge_t> node_edges;
+    for(int v=0 ; v<n ; ++v) {
+        first_out.push_back(head.size());
+        
+        node_edges.clear();
+        mode_rank.clear();
+        BOOST_FOREACH(edge_t e, boost::out_edges(original_ids[v], g)) {
+            BOOST_ASSERT( g[e].type < CsrGraph::num_modes );
+            mode_rank.push_back( std::make_pair(g[e].type, node_edges.size()) );
+            node_edges.push_back(e);
+        }
+        std::sort(mode_rank.begin(), mode_rank.end());
+        
+        for(uint i=0 ; i<mode_rank.size() ; ++i) {
+            const edge_t e = node_edges[mode_rank[i].second];
+            head.push_back(internal_ids[boost::target(e, g)]);
+            tail.push_back(v);
+            type.push_back(g[e].type);
+            dur_index.push_back(duration_index(e));
+        }
+    }
+    first_out.push_back(head.size());
+    
+    csr_graph.build(first_out, head, tail, type, dur_index);
+    
+    std::vector<Node> nodes(n);
+    for(int v=0 ; v<n ; ++v) {
+        nodes[v] = g[original_ids[v]];
+    }
+    frozen_nodes.assign(nodes);
+    
+    std::vector<int> road(road_durations);
+    frozen_road_durations.assign(road);
+    
+    frozen_pt_durations.build(pt_durations, services_patterns);
+    
+    std::vector<boost::uint64_t> car_blocks( (n + 63) / 64, 0 );
+    for(int v=0 ; v<n ; ++v) {
+        if(original_ids[v] < (int) car_accessibility.size() && car_accessibility.test(original_ids[v]))
+            car_blocks[v / 64] |= boost::uint64_t(1) << (v % 64);
     }
+    frozen_car_accessibility.assign(car_blocks);
+    
+    frozen_internal_ids.assign(internal_ids);
+    frozen_original_ids.assign(original_ids);
 }
 
 void Graph::load_from_bin(const std::string & filename)
@@ -249,23 +397,36 @@ void Graph::load_from_bin(const std::string & filename)
     std::cout << "Loading graph from file " << filename << std::endl;
     std::ifstream ifile(filename.c_str());
     boost::archive::binary_iarchive iArchive(ifile);
-    iArchive >> id;
+    std::string tag;
+    iArchive >> tag;
+    if(tag == SERVICES_ARCHIVE_TAG) {
+        std::vector<boost::uint64_t> words;
+        iArchive >> id;
+        iArchive >> words;
+        set_services_words(words);
+    } else {
+        // archive written before services patterns were shared: no tag, this is the id
+        id = tag;
+    }
     iArchive >> num_road_edges;
     iArchive >> num_pt_edges;
     iArchive >> road_durations;
     iArchive >> pt_durations;
     iArchive >> car_accessibility;
     iArchive >> g; //graph;   
+    register_legacy_services();
     std::cout << "   " << boost::num_vertices(g) << " nodes" << std::endl;
     std::cout << "   " << boost::num_edges(g) << " edges" << std::endl;
-    init_edge_indexes();
 }
 
 void Graph::save_to_bin(const std::string & filename) const
 {
+    BOOST_ASSERT( !mapped_file && "Use save_to_mmap() for a mapped graph" );
     std::ofstream ofile(filename.c_str());
     boost::archive::binary_oarchive oArchive(ofile);
+    oArchive << SERVICES_ARCHIVE_TAG;
     oArchive << id;
+    oArchive << services_words();
     oArchive << num_road_edges;
     oArchive << num_pt_edges;
     oArchive << road_durations;
@@ -279,23 +440,36 @@ void Graph::load_from_txt(const std::string & filename)
     std::cout << "Loading graph from file " << filename << std::endl;
     std::ifstream ifile(filename.c_str());
     boost::archive::text_iarchive iArchive(ifile);
-    iArchive >> id;
+    std::string tag;
+    iArchive >> tag;
+    if(tag == SERVICES_ARCHIVE_TAG) {
+        std::vector<boost::uint64_t> words;
+        iArchive >> id;
+        iArchive >> words;
+        set_services_words(words);
+    } else {
+        // archive written before services patterns were shared: no tag, this is the id
+        id = tag;
+    }
     iArchive >> num_road_edges;
     iArchive >> num_pt_edges;
     iArchive >> road_durations;
     iArchive >> pt_durations;
     iArchive >> car_accessibility;
     iArchive >> g; //graph;   
+    register_legacy_services();
     std::cout << "   " << boost::num_vertices(g) << " nodes" << std::endl;
     std::cout << "   " << boost::num_edges(g) << " edges" << std::endl;
-    init_edge_indexes();
 }
 
 void Graph::save_to_txt(const std::string & filename) const
 {
+    BOOST_ASSERT( !mapped_file && "Use save_to_mmap() for a mapped graph" );
     std::ofstream ofile(filename.c_str());
     boost::archive::text_oarchive oArchive(ofile);
+    oArchive << SERVICES_ARCHIVE_TAG;
     oArchive << id;
+    oArchive << services_words();
     oArchive << num_road_edges;
     oArchive << num_pt_edges;
     oArchive << road_durations;
@@ -304,13 +478,244 @@ void Graph::save_to_txt(const std::string & filename) const
     oArchive << g; //graph; 
 }
 
+/**
+ * Layout of the files written by save_to_mmap().
+ * 
+ * The file starts with a MmapHeader followed by one section per array of the frozen graph, each 
+ * section starting on a MMAP_ALIGNMENT bytes boundary.
+ */
+namespace {
+const char MMAP_MAGIC[8] = { 'M', 'U', 'M', 'O', 'R', 'O', 'M', 'M' };
+const boost::uint32_t MMAP_VERSION = 1;
+const boost::uint64_t MMAP_ALIGNMENT = 64;
+
+enum MmapSection {
+    IdSection, NodesSection, FirstOutSection, HeadSection, TailSection, TypeSection, DurationIndexSection, 
+    FirstInSection, InEdgeIdSection, OutModeOffsetSection, InModeOffsetSection, RoadDurationsSection, 
+    PtEdgesSection, DeparturesSection, ArrivalsSection, ServicesSection, FrequenciesSection, FrequencyReachSection, CarAccessibilitySection, 
+    InternalIdsSection, OriginalIdsSection, ActiveServicesSection, 
+    NumMmapSections
+};
+
+struct MmapHeader
+{
+    char magic[8];
+    boost::uint32_t version;
+    boost::uint32_t num_sections;
+    boost::int32_t num_road_edges;
+    boost::int32_t num_pt_edges;
+    boost::uint64_t offset[NumMmapSections];
+    boost::uint64_t count[NumMmapSections];
+    boost::uint64_t element_size[NumMmapSections];
+};
+
+template<typename T>
+void write_section( std::ofstream & out, MmapHeader & header, const MmapSection section, const T * data, const size_t count )
+{
+    boost::uint64_t pos = out.tellp();
+    const boost::uint64_t padding = (MMAP_ALIGNMENT - pos % MMAP_ALIGNMENT) % MMAP_ALIGNMENT;
+    const char zeros[MMAP_ALIGNMENT] = { 0 };
+    out.write( zeros, padding );
+    
+    header.offset[section] = pos + padding;
+    header.count[section] = count;
+    header.element_size[section] = sizeof(T);
+    out.write( reinterpret_cast<const char *>(data), count * sizeof(T) );
+}
+
+template<typename T>
+void write_section( std::ofstream & out, MmapHeader & header, const MmapSection section, const FlatArray<T> & array )
+{
+    write_section( out, header, section, array.data(), array.size() );
+}
+
+template<typename T>
+void map_section( const MappedFile & file, const MmapHeader & header, const MmapSection section, FlatArray<T> & array )
+{
+    const boost::uint64_t offset = header.offset[section];
+    const boost::uint64_t count = header.count[section];
+    if( header.element_size[section] != sizeof(T) || offset % MMAP_ALIGNMENT != 0 
+        || offset > file.size() || count > (file.size() - offset) / sizeof(T) )
+        throw std::runtime_error( "Corrupted section in mapped graph file" );
+    
+    array.borrow( reinterpret_cast<const T *>(file.data() + offset), count );
+}
+
+/**
+ * True if the offsets of the modes of every node are sorted and within the `first` range of the node
+ */
+bool valid_mode_offsets( const FlatArray<boost::uint16_t> & offsets, const FlatArray<int> & first )
+{
+    for(size_t v=0 ; v+1<first.size() ; ++v) {
+        const int degree = first[v+1] - first[v];
+        for(int m=0 ; m<CsrGraph::num_modes ; ++m) {
+            const int offset = offsets[v * CsrGraph::num_modes + m];
+            if(offset > degree || (m > 0 && offset < offsets[v * CsrGraph::num_modes + m - 1]))
+                return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * True if the timetable and frequency ranges of the edges fit their arrays, and every services id a row of
+ * the calendar
+ */
+bool valid_pt_durations( const PtDurations & durations )
+{
+    const FlatArray<boost::uint64_t> & active = durations.active_services;
+    if( active.size() % PtDurations::num_days != 0
+        || durations.arrivals.size() != durations.departures.size()
+        || durations.services.size() != durations.departures.size()
+        || durations.frequency_reach.size() != durations.frequencies.size() )
+        return false;
+    const size_t num_patterns = active.size() / PtDurations::num_days * 64;
+    if(!all_below( durations.services, num_patterns ))
+        return false;
+    for(const FrequencyEntry * f=durations.frequencies.begin() ; f!=durations.frequencies.end() ; ++f) {
+        if(f->services >= num_patterns)
+            return false;
+    }
+    for(const PtEdge * e=durations.edges.begin() ; e!=durations.edges.end() ; ++e) {
+        size_t size = 0;
+        if(e->dur_type == TimetableDur)
+            size = durations.departures.size();
+        else if(e->dur_type == FrequencyDur)
+            size = durations.frequencies.size();
+        else
+            continue;
+        if(e->begin < 0 || e->begin > e->end || (size_t) e->end > size)
+            return false;
+    }
+    return true;
+}
+}
+
+bool Graph::is_mmap_file(const std::string & filename)
+{
+    char magic[sizeof(MMAP_MAGIC)];
+    std::ifstream ifile(filename.c_str(), std::ios::binary);
+    return ifile.read(magic, sizeof(magic)) && memcmp(magic, MMAP_MAGIC, sizeof(magic)) == 0;
+}
+
+void Graph::save_to_mmap(const std::string & filename) const
+{
+    MmapHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, MMAP_MAGIC, sizeof(MMAP_MAGIC));
+    header.version = MMAP_VERSION;
+    header.num_sections = NumMmapSections;
+    header.num_road_edges = num_road_edges;
+    header.num_pt_edges = num_pt_edges;
+    
+    std::ofstream ofile(filename.c_str(), std::ios::binary);
+    ofile.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    
+    write_section(ofile, header, IdSection, id.data(), id.size());
+    write_section(ofile, header, NodesSection, frozen_nodes);
+    write_section(ofile, header, FirstOutSection, csr_graph.first_out);
+    write_section(ofile, header, HeadSection, csr_graph.head);
+    write_section(ofile, header, TailSection, csr_graph.tail);
+    write_section(ofile, header, TypeSection, csr_graph.type);
+    write_section(ofile, header, DurationIndexSection, csr_graph.duration_index);
+    write_section(ofile, header, FirstInSection, csr_graph.first_in);
+    write_section(ofile, header, InEdgeIdSection, csr_graph.in_edge_id);
+    write_section(ofile, header, OutModeOffsetSection, csr_graph.out_mode_offset);
+    write_section(ofile, header, InModeOffsetSection, csr_graph.in_mode_offset);
+    write_section(ofile, header, RoadDurationsSection, frozen_road_durations);
+    write_section(ofile, header, PtEdgesSection, frozen_pt_durations.edges);
+    write_section(ofile, header, DeparturesSection, frozen_pt_durations.departures);
+    write_section(ofile, header, ArrivalsSection, frozen_pt_durations.arrivals);
+    write_section(ofile, header, ServicesSection, frozen_pt_durations.services);
+    write_section(ofile, header, FrequenciesSection, frozen_pt_durations.frequencies);
+    write_section(ofile, header, FrequencyReachSection, frozen_pt_durations.frequency_reach);
+    write_section(ofile, header, CarAccessibilitySection, frozen_car_accessibility);
+    write_section(ofile, header, InternalIdsSection, frozen_internal_ids);
+    write_section(ofile, header, OriginalIdsSection, frozen_original_ids);
+    write_section(ofile, header, ActiveServicesSection, frozen_pt_durations.active_services);
+    
+    ofile.seekp(0);
+    ofile.write(reinterpret_cast<const char *>(&header), sizeof(header));
+}
+
+void Graph::load_from_mmap(const std::string & filename)
+{
+    std::cout << "Mapping graph from file " << filename << std::endl;
+    mapped_file.reset( new MappedFile(filename) );
+    
+    MmapHeader header;
+    if( mapped_file->size() < sizeof(header) )
+        throw std::runtime_error( "Not a mapped graph file: " + filename );
+    memcpy(&header, mapped_file->data(), sizeof(header));
+    if( memcmp(header.magic, MMAP_MAGIC, sizeof(MMAP_MAGIC)) != 0 || header.version != MMAP_VERSION 
+        || header.num_sections != NumMmapSections )
+        throw std::runtime_error( "Unsupported mapped graph file: " + filename );
+    
+    num_road_edges = header.num_road_edges;
+    num_pt_edges = header.num_pt_edges;
+    
+    FlatArray<char> id_chars;
+    map_section(*mapped_file, header, IdSection, id_chars);
+    id.assign(id_chars.begin(), id_chars.end());
+    
+    map_section(*mapped_file, header, NodesSection, frozen_nodes);
+    map_section(*mapped_file, header, FirstOutSection, csr_graph.first_out);
+    map_section(*mapped_file, header, HeadSection, csr_graph.head);
+    map_section(*mapped_file, header, TailSection, csr_graph.tail);
+    map_section(*mapped_file, header, TypeSection, csr_graph.type);
+    map_section(*mapped_file, header, DurationIndexSection, csr_graph.duration_index);
+    map_section(*mapped_file, header, FirstInSection, csr_graph.first_in);
+    map_section(*mapped_file, header, InEdgeIdSection, csr_graph.in_edge_id);
+    map_section(*mapped_file, header, OutModeOffsetSection, csr_graph.out_mode_offset);
+    map_section(*mapped_file, header, InModeOffsetSection, csr_graph.in_mode_offset);
+    map_section(*mapped_file, header, RoadDurationsSection, frozen_road_durations);
+    map_section(*mapped_file, header, PtEdgesSection, frozen_pt_durations.edges);
+    map_section(*mapped_file, header, DeparturesSection, frozen_pt_durations.departures);
+    map_section(*mapped_file, header, ArrivalsSection, frozen_pt_durations.arrivals);
+    map_section(*mapped_file, header, ServicesSection, frozen_pt_durations.services);
+    map_section(*mapped_file, header, FrequenciesSection, frozen_pt_durations.frequencies);
+    map_section(*mapped_file, header, FrequencyReachSection, frozen_pt_durations.frequency_reach);
+    map_section(*mapped_file, header, CarAccessibilitySection, frozen_car_accessibility);
+    map_section(*mapped_file, header, InternalIdsSection, frozen_internal_ids);
+    map_section(*mapped_file, header, OriginalIdsSection, frozen_original_ids);
+    map_section(*mapped_file, header, ActiveServicesSection, frozen_pt_durations.active_services);
+    
+    // sections are only checked one by one above: their sizes and the ids they hold must be checked against
+    // each other, or a truncated or mismatched file would be read out of bounds
+    const size_t n = frozen_nodes.size();
+    const size_t m = csr_graph.head.size();
+    if( num_road_edges < 0 || num_pt_edges < 0
+        || frozen_road_durations.size() != (size_t) num_road_edges
+        || frozen_pt_durations.edges.size() != (size_t) num_pt_edges
+        || frozen_car_accessibility.size() != (n + 63) / 64
+        || csr_graph.first_out.size() != n + 1 || csr_graph.first_in.size() != n + 1
+        || !valid_offsets(csr_graph.first_out, m) || !valid_offsets(csr_graph.first_in, m)
+        || csr_graph.tail.size() != m || csr_graph.type.size() != m
+        || csr_graph.duration_index.size() != m || csr_graph.in_edge_id.size() != m
+        || csr_graph.out_mode_offset.size() != n * CsrGraph::num_modes
+        || csr_graph.in_mode_offset.size() != n * CsrGraph::num_modes
+        || frozen_internal_ids.size() != n || frozen_original_ids.size() != n )
+        throw std::runtime_error( "Inconsistent sections in mapped graph file: " + filename );
+    if( !all_below(csr_graph.head, n) || !all_below(csr_graph.tail, n) || !all_below(csr_graph.in_edge_id, m)
+        || !all_below(csr_graph.type, CsrGraph::num_modes)
+        || !all_below(csr_graph.duration_index, (size_t) num_road_edges + num_pt_edges)
+        || !valid_mode_offsets(csr_graph.out_mode_offset, csr_graph.first_out)
+        || !valid_mode_offsets(csr_graph.in_mode_offset, csr_graph.first_in)
+        || !all_below(frozen_internal_ids, n) || !all_below(frozen_original_ids, n)
+        || !valid_pt_durations(frozen_pt_durations) )
+        throw std::runtime_error( "Ids out of bounds in mapped graph file: " + filename );
+    
+    std::cout << "   " << num_vertices() << " nodes" << std::endl;
+    std::cout << "   " << csr_graph.num_edges() << " edges" << std::endl;
+}
+
 EdgeList Graph::listEdges(const EdgeMode type) const
 {
     EdgeList edgeList;
     
-    BOOST_FOREACH(edge_t e, boost::edges(g)) {
-        if(type == WhateverEdge || g[e].type == type)
-            edgeList.push_back(edgeIndex(e));
+    for(int e=0 ; e<csr_graph.num_edges() ; ++e) {
+        if(type == WhateverEdge || csr_graph.type[e] == type)
+            edgeList.push_back(e);
     }
     return edgeList;
 }
@@ -41,8 +41,16 @@ knowledge of the CeCILL-B license and that you accept its terms. */
 #include <boost/archive/text_iarchive.hpp>
 #include <boost/archive/text_oarchive.hpp>
 #include <boost/dynamic_bitset.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/serialization/version.hpp>
 
 #include <bitset>
+#include <map>
+
+#include "csr_graph.h"
+#include "pt_durations.h"
+#include "mapped_file.h"
 
 #ifndef GRAPH_WRAPPER_H
 #define GRAPH_WRAPPER_H
@@ -65,69 +73,78 @@ typedef enum {
 } DurationType;
 
 
-/**
- * Attaches a boolean to every day
- */
-typedef std::bitset<128> Services;
-
 /**
  * Defines a timetable line:
  *  - float: departure
  *  - float: arrival
- *  - Services: days of availability
+ *  - ServiceId: days of availability, as an index in the services patterns of the graph
  */
-typedef boost::tuple<float, float, Services> Time;
+typedef boost::tuple<float, float, ServiceId> Time;
 
 /**
  * Defines a frequency with the four following properties :
  * - begining of the period during which it is usable
  * - end of the period during which it is usable
  * - const duration of the transfer
- * - days on which it is usable
+ * - days on which it is usable, as an index in the services patterns of the graph
  */
-typedef boost::tuple<int, int, int, Services> Frequency;
+typedef boost::tuple<int, int, int, ServiceId> Frequency;
 
+/**
+ * Timetable lines and frequencies as stored in archives written before the services patterns
+ * were shared, each one holding its own Services.
+ */
+typedef boost::tuple<float, float, Services> LegacyTime;
+typedef boost::tuple<int, int, int, Services> LegacyFrequency;
 
-typedef enum { NextDay = 1, PrevDay = 2 } AllowedLookup;
+namespace Transport {
+    struct Graph;
+}
 
+/**
+ * Duration of a public transport edge while the graph is being built.
+ * 
+ * Queries are answered by the frozen version of the graph (see Transport::PtDurations).
+ */
 class DurationPT
 {
+    friend class Transport::PtDurations;
+    friend struct Transport::Graph;
 private:
     std::vector<Time> timetable;
     std::vector<Frequency> frequencies;
     
+    /**
+     * Only filled when loading an archive of version 0, until the graph registers their services
+     */
+    std::vector<LegacyTime> legacy_timetable;
+    std::vector<LegacyFrequency> legacy_frequencies;
+    
 public:
     int const_duration;
     DurationType dur_type;
     
     DurationPT(const DurationType dur_type = ConstDur);
     DurationPT(float const_duration);
-    void append_timetable(float start, float arrival, const std::string & services);
-    void append_frequency(int start, int end, int duration, const std::string & services);
+    void append_timetable(float start, float arrival, const ServiceId services);
+    void append_frequency(int start, int end, int duration, const ServiceId services);
     void sort();
     void set_min();
-    std::pair<bool, int> operator()(float start_time, int day, bool backward = false) const;
-    
-    /**
-     * Returns the minimum cost that might appear on this edge.
-     * This is tipically useful for backward search when no arrival time is known
-     */
-    std::pair<bool, int> min_duration() const;
     
 
     template<class Archive>
     void serialize(Archive& ar, const unsigned int version)
     {
-        ar & dur_type & const_duration & timetable & frequencies;
+        ar & dur_type & const_duration;
+        if(version == 0)
+            ar & legacy_timetable & legacy_frequencies;
+        else
+            ar & timetable & frequencies;
     }
-
-private: 
-    std::pair<bool, int> freq_duration_forward(float start_time, int day, int allowed_lookup = NextDay | PrevDay ) const;
-    std::pair<bool, int> freq_duration_backward(float start_time, int day, int allowed_lookup = NextDay | PrevDay ) const;
-    std::pair<bool, int> tt_duration_forward(float start_time, int day, int allowed_lookup = NextDay | PrevDay ) const;
-    std::pair<bool, int> tt_duration_backward(float start_time, int day, int allowed_lookup = NextDay | PrevDay ) const;
 };
 
+BOOST_CLASS_VERSION(DurationPT, 1)
+
 struct Node
 {
     float lon;
@@ -182,7 +199,9 @@ private:
     Graph(int nb_nodes);
     
     /**
-     * Loads the graph from the archive
+     * Loads the graph from the archive.
+     * 
+     * If `from_bin` is true and the file was written by save_to_mmap(), it is memory mapped instead of deserialized.
      */
     Graph(const std::string & filename, bool from_bin);
     
@@ -206,27 +225,71 @@ private:
     
     void set_id(const std::string id) { this->id = id; }
     
+    /**
+     * Returns the id of a services pattern, registering it if it is not known yet.
+     * Throws std::runtime_error if there are more patterns than ServiceId can number.
+     */
+    ServiceId services_id(const std::string & services);
+    
+    /**
+     * Registers the services of the timetable lines and frequencies loaded from an archive of version 0
+     */
+    void register_legacy_services();
+    
+    /**
+     * Services patterns as two 64 bits words (lower bits first), used to store them in archives
+     */
+    std::vector<boost::uint64_t> services_words() const;
+    void set_services_words(const std::vector<boost::uint64_t> & words);
+    
     /**
      * Saves the whole graph to a file
      */
     void save_to_bin(const std::string & filename/*, bool bin_archive*/) const;
     void save_to_txt(const std::string & filename/*, bool bin_archive*/) const;
     
+    /**
+     * Saves the frozen graph in a file made of flat and aligned sections that can be mapped in memory 
+     * without any deserialization (the file is only readable on a machine with the same endianness).
+     * 
+     * The graph must have been preprocessed.
+     */
+    void save_to_mmap(const std::string & filename) const;
+    
     /**
      * Loads graph from a file
      */
     void load_from_bin(const std::string & filename);
     void load_from_txt(const std::string & filename);
+    
+    /**
+     * Maps a file written by save_to_mmap(). The graph is read-only afterwards.
+     */
+    void load_from_mmap(const std::string & filename);
+    
+    /**
+     * Returns true if the file was written by save_to_mmap()
+     */
+    static bool is_mmap_file(const std::string & filename);
 
     
     /**
      * Performs operations that need to be done once all information is in the graph :
      * 
      * - sorts timetables
-     * - builds an edge index
+     * - builds the frozen (CSR) representation used by queries
      * - computes min duration for each edge
      */
     void preprocess();
+    
+    /**
+     * Builds the CSR representation of the graph from the adjacency list.
+     * 
+     * Nodes are numbered according to `node_order`. Edge ids exposed by this class are the ones of 
+     * this representation, they are hence only valid until the next call.
+     * Throws std::runtime_error if a node has more than 65535 edges in either direction.
+     */
+    void freeze();
 
 public:
     std::string get_id() const { return id; }
@@ -236,74 +299,131 @@ public:
      */
     EdgeList listEdges(const EdgeMode type = WhateverEdge) const;
     
+    /**
+     * Nodes are renumbered when the graph is frozen so that nodes close in space are close in memory
+     * (see GraphFactory::init()). Every method of this class and the algorithms use the new ids.
+     * 
+     * Those convert the id of a node in the input data (as used by the GraphFactory and Python) 
+     * to its id in the graph, and the reverse.
+     */
+    inline int internal_node(const int original) const { return frozen_internal_ids[original]; }
+    inline int original_node(const int internal) const { return frozen_original_ids[internal]; }
+    
     /**
      * Returns the number of vertices in the graph
      */
-    inline int num_vertices() const { return boost::num_vertices( g ); }
+    inline int num_vertices() const { return frozen_nodes.size(); }
     
     /**
      * Return the Edge instance associated with the edge index passed
      */
-    inline Edge map(const int edge_id) const { return g[this->edge_descriptor(edge_id)]; }
-    inline Edge map( const edge_t edge ) const { return g[edge]; }
-    inline int edgeIndex(const edge_t edge) const { 
-        if(g[edge].road_edge) 
-            return g[edge].index; 
-        else 
-            return num_road_edges + g[edge].index; }
+    inline Edge map(const int edge_id) const { 
+        const int index = csr_graph.duration_index[edge_id];
+        const EdgeMode type = (EdgeMode) csr_graph.type[edge_id];
+        if(index < num_road_edges)
+            return Edge(true, index, type);
+        else
+            return Edge(false, index - num_road_edges, type);
+    }
     
-    inline std::pair<bool, int> duration_forward(const edge_t edge, const float start_sec, const int day) const {
-        if(g[edge].road_edge) {
-            return std::pair<bool, int>(true, road_durations[g[edge].index]);
+    inline std::pair<bool, int> duration_forward(const int edge_id, const float start_sec, const int day) const {
+        const int index = csr_graph.duration_index[edge_id];
+        if(index < num_road_edges) {
+            return std::pair<bool, int>(true, frozen_road_durations[index]);
         } else {
-            return pt_durations[g[edge].index](start_sec, day, false);
+            return frozen_pt_durations.duration(index - num_road_edges, start_sec, day, false);
         }
     }
     
-    inline std::pair<bool, int> duration_backward(const edge_t edge, const float start_sec, const int day) const {
-        if(g[edge].road_edge) {
-            return std::pair<bool, int>(true, road_durations[g[edge].index]);
+    inline std::pair<bool, int> duration_backward(const int edge_id, const float start_sec, const int day) const {
+        const int index = csr_graph.duration_index[edge_id];
+        if(index < num_road_edges) {
+            return std::pair<bool, int>(true, frozen_road_durations[index]);
         } else {
-            return pt_durations[g[edge].index](start_sec, day, true);
+            return frozen_pt_durations.duration(index - num_road_edges, start_sec, day, true);
         }
     }
     
-    inline std::pair<bool, int> min_duration(const edge_t edge) const {
-        if(g[edge].road_edge) {
-            return std::pair<bool, int>(true, road_durations[g[edge].index]);
+    inline std::pair<bool, int> min_duration(const int edge_id) const {
+        const int index = csr_graph.duration_index[edge_id];
+        if(index < num_road_edges) {
+            return std::pair<bool, int>(true, frozen_road_durations[index]);
         } else {
-            return pt_durations[g[edge].index].min_duration();
+            return frozen_pt_durations.min_duration(index - num_road_edges);
         }
     }
     
+    /**
+     * True if traversing the edge always takes its minimal duration, whatever the time
+     */
+    inline bool constant_duration(const int edge_id) const {
+        const int index = csr_graph.duration_index[edge_id];
+        return index < num_road_edges || frozen_pt_durations.edges[index - num_road_edges].dur_type == ConstDur;
+    }
+    
+    /**
+     * Index of the edge in Transport::DayTimetable, -1 if its duration does not follow a timetable
+     */
+    inline int timetable_index(const int edge_id) const {
+        const int index = csr_graph.duration_index[edge_id] - num_road_edges;
+        if(index < 0 || frozen_pt_durations.edges[index].dur_type != TimetableDur)
+            return -1;
+        return index;
+    }
+    
+    /**
+     * Fills `windows` with the frequencies of the edge running on `day` (see Transport::PtDurations::day_frequencies).
+     * Returns false if its duration does not follow frequencies.
+     */
+    inline bool frequency_windows(const int edge_id, const int day, std::vector<Transport::FrequencyEntry> & windows) const {
+        const int index = csr_graph.duration_index[edge_id] - num_road_edges;
+        windows.clear();
+        if(index < 0 || frozen_pt_durations.edges[index].dur_type != FrequencyDur)
+            return false;
+        frozen_pt_durations.day_frequencies(index, day, windows);
+        return true;
+    }
+    
+    /**
+     * Timetable lines of every public transport edge running on `day`, see Transport::DayTimetable
+     */
+    inline boost::shared_ptr<const Transport::DayTimetable> day_timetable(const int day) const {
+        return frozen_pt_durations.day_timetable(day);
+    }
+    
+    /**
+     * Frozen representation of the graph on which searches are run.
+     */
+    inline const CsrGraph & csr() const { return csr_graph; }
+    
     /**
      * Return the Node instance associated with the node index passed
      */
-    inline Node mapNode(const int node_id) const { return g[node_id]; }
+    inline Node mapNode(const int node_id) const { return frozen_nodes[node_id]; }
     
     /**
      * Returns the origin (node index) of an edge
      */
-    inline int source(const int edge_id) const { return boost::source(this->edge_descriptor(edge_id), g); }
-    inline int source(const edge_t edge) const { return boost::source(edge, g); }
+    inline int source(const int edge_id) const { return csr_graph.tail[edge_id]; }
     
     /**
      * Returns the target (node index) of an edge
      */
-    inline int target(const int edge_id) const { return boost::target(this->edge_descriptor(edge_id), g); }
-    inline int target(const edge_t edge) const { return boost::target(edge, g); }
+    inline int target(const int edge_id) const { return csr_graph.head[edge_id]; }
     
     /**
      * Returns the longitude of a node
      */
-    inline float longitude(const int node) const { return g[node].lon; }
+    inline float longitude(const int node) const { return frozen_nodes[node].lon; }
     
     /**
      * Returns the latitude of a node
      */
-    inline float latitude(const int node) const { return g[node].lat; }
+    inline float latitude(const int node) const { return frozen_nodes[node].lat; }
     
-    inline bool car_accessible(const int node) const { return car_accessibility.test(node); }
+    inline bool car_accessible(const int node) const { 
+        return (frozen_car_accessibility[node / 64] >> (node % 64)) & 1; 
+    }
   
 private:
     std::string id;
@@ -313,13 +433,48 @@ private:
     vector<int> road_durations;
     vector<DurationPT> pt_durations;
     
-    std::vector<edge_t> edges_vec;
+    /**
+     * Distinct Services of the graph, referenced by ServiceId from timetables and frequencies
+     */
+    vector<Services> services_patterns;
+    std::map<std::string, ServiceId> services_ids;
+    
     boost::dynamic_bitset<> car_accessibility;
-    inline edge_t edge_descriptor(const int edge_id) const { return edges_vec[edge_id]; }
+    
+    /**
+     * Id in the input data of each node of the frozen graph (node_order[internal] = original).
+     * The identity is used if empty.
+     */
+    vector<int> node_order;
+    
+    /**
+     * Frozen graph: this is the only data read by queries. 
+     * It is either built by freeze() or borrowed from a mapped file.
+     */
+    CsrGraph csr_graph;
+    FlatArray<Node> frozen_nodes;
+    FlatArray<int> frozen_road_durations;
+    Transport::PtDurations frozen_pt_durations;
+    FlatArray<boost::uint64_t> frozen_car_accessibility;
+    FlatArray<int> frozen_internal_ids;
+    FlatArray<int> frozen_original_ids;
+    
+    /**
+     * File backing the frozen graph, if it was mapped
+     */
+    boost::shared_ptr<MappedFile> mapped_file;
+    
+    /**
+     * Index of the duration of an edge of the adjacency list (see CsrGraph::duration_index)
+     */
+    inline int duration_index(const edge_t edge) const { 
+        if(g[edge].road_edge) 
+            return g[edge].index; 
+        else 
+            return num_road_edges + g[edge].index; }
     
     void compute_min_durations();
     void sort();
-    void init_edge_indexes();
 };
 
 } // end namespace Transport
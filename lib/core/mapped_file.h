@@ -0,0 +1,69 @@
+/** Copyright : Arthur Bit-Monnot (2013)  arthur.bit-monnot@laas.fr
+
+This software is a computer program whose purpose is to [describe
+functionalities and technical features of your software].
+
+This software is governed by the CeCILL-B license under French law and
+abiding by the rules of distribution of free software.  You can  use, 
+modify and/ or redistribute the software under the terms of the CeCILL-B
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info". 
+
+As a counterpart to the access to the source code and  rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty  and the software's author,  the holder of the
+economic rights,  and the successive licensors  have only  limited
+liability. 
+
+In this respect, the user's attention is drawn to the risks associated
+with loading,  using,  modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean  that it is complicated to manipulate,  and  that  also
+therefore means  that it is reserved for developers  and  experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or 
+data to be ensured and,  more generally, to use and operate it in the 
+same conditions as regards security. 
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL-B license and that you accept its terms. 
+*/
+
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <string>
+#include <cstddef>
+
+namespace Transport {
+
+/**
+ * Read-only memory mapping of a whole file.
+ *
+ * Pages are shared with any other process mapping the same file and are only loaded when accessed.
+ * The mapping is released when the instance is destroyed.
+ */
+class MappedFile
+{
+public:
+    /**
+     * Maps the file, throws std::runtime_error if this is not possible
+     */
+    MappedFile( const std::string & filename );
+    ~MappedFile();
+
+    inline const char * data() const { return addr; }
+    inline size_t size() const { return length; }
+
+private:
+    MappedFile( const MappedFile & );
+    MappedFile & operator=( const MappedFile & );
+
+    const char * addr;
+    size_t length;
+};
+
+} // end namespace Transport
+
+#endif
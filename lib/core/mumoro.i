@@ -8,6 +8,44 @@
   
 %template(EdgeList) std::list<int>;
 
+// Nodes of the graph are renumbered when it is frozen, Python only sees the ids of the input data
+%ignore Transport::Graph::mapNode;
+%ignore Transport::Graph::source;
+%ignore Transport::Graph::target;
+%ignore Transport::Graph::longitude;
+%ignore Transport::Graph::latitude;
+%ignore Transport::Graph::car_accessible;
+%rename(mapNode) Transport::Graph::original_mapNode;
+%rename(source) Transport::Graph::original_source;
+%rename(target) Transport::Graph::original_target;
+%rename(longitude) Transport::Graph::original_longitude;
+%rename(latitude) Transport::Graph::original_latitude;
+%rename(car_accessible) Transport::Graph::original_car_accessible;
+%ignore BBNodeFilter::isIn;
+%ignore BBNodeFilter::visualization;
+%rename(isIn) BBNodeFilter::original_isIn;
+%rename(visualization) BBNodeFilter::original_visualization;
+
 // Parse the original header file
 %include "graph_wrapper.h" 
-%include "nodes_filter.h"
\ No newline at end of file
+%include "nodes_filter.h"
+
+%extend Transport::Graph {
+    Node original_mapNode(const int node) const { return $self->mapNode( $self->internal_node(node) ); }
+    int original_source(const int edge_id) const { return $self->original_node( $self->source(edge_id) ); }
+    int original_target(const int edge_id) const { return $self->original_node( $self->target(edge_id) ); }
+    float original_longitude(const int node) const { return $self->longitude( $self->internal_node(node) ); }
+    float original_latitude(const int node) const { return $self->latitude( $self->internal_node(node) ); }
+    bool original_car_accessible(const int node) const { return $self->car_accessible( $self->internal_node(node) ); }
+}
+
+%extend BBNodeFilter {
+    bool original_isIn(const int node) const { return $self->isIn( $self->graph()->internal_node(node) ); }
+    VisualResult original_visualization() const {
+        VisualResult vres = $self->visualization();
+        for(NodeList::iterator it=vres.a_nodes.begin() ; it!=vres.a_nodes.end() ; ++it) {
+            *it = $self->graph()->original_node( *it );
+        }
+        return vres;
+    }
+}
@@ -59,14 +59,10 @@ VisualResult BBNodeFilter::visualization() const
 {
     VisualResult vres;
     
-    Graph_t::vertex_iterator curr, end;
-    boost::tie(curr, end) = boost::vertices( g->g );
-    
-    while(curr != end) {
-        if( isIn( *curr ) ) {
-            vres.a_nodes.push_back(*curr);
+    for(int node=0 ; node < g->num_vertices() ; ++node) {
+        if( isIn( node ) ) {
+            vres.a_nodes.push_back( node );
         }
-        curr++;
     }
     
     return vres;
@@ -57,6 +57,7 @@ public:
     BBNodeFilter(const Transport::Graph * g, float max_lon, float min_lon, float max_lat, float min_lat);
     bool isIn( const int node ) const;
     virtual VisualResult visualization() const;
+    inline const Transport::Graph * graph() const { return g; }
 private:
     const Transport::Graph * g;
     const float max_lon;
@@ -0,0 +1,373 @@
+/** Copyright : Arthur Bit-Monnot (2013)  arthur.bit-monnot@laas.fr
+
+This software is a computer program whose purpose is to [describe
+functionalities and technical features of your software].
+
+This software is governed by the CeCILL-B license under French law and
+abiding by the rules of distribution of free software.  You can  use, 
+modify and/ or redistribute the software under the terms of the CeCILL-B
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info". 
+
+As a counterpart to the access to the source code and  rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty  and the software's author,  the holder of the
+economic rights,  and the successive licensors  have only  limited
+liability. 
+
+In this respect, the user's attention is drawn to the risks associated
+with loading,  using,  modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean  that it is complicated to manipulate,  and  that  also
+therefore means  that it is reserved for developers  and  experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or 
+data to be ensured and,  more generally, to use and operate it in the 
+same conditions as regards security. 
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL-B license and that you accept its terms. 
+*/
+
+#include "pt_durations.h"
+#include "graph_wrapper.h"
+
+#include <iostream>
+#include <cmath>
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <map>
+#include <stdexcept>
+
+namespace Transport {
+
+namespace {
+
+inline int to_seconds( const float time )
+{
+    return static_cast<int>( std::floor( time + 0.5f ) );
+}
+
+/**
+ * First element of the sorted range [first, first + n) that is not lower than `value`
+ *
+ * The loop only depends on n, the comparison result being used as a conditional move.
+ */
+inline int lower_bound( const int * first, int n, const float value )
+{
+    if(n == 0)
+        return 0;
+    const int * base = first;
+    while(n > 1) {
+        const int half = n / 2;
+        base = (base[half] < value) ? base + half : base;
+        n -= half;
+    }
+    return (base - first) + (*base < value);
+}
+
+/**
+ * First element of the sorted range [first, first + n) that is greater than `value`
+ */
+inline int upper_bound( const int * first, int n, const float value )
+{
+    if(n == 0)
+        return 0;
+    const int * base = first;
+    while(n > 1) {
+        const int half = n / 2;
+        base = (base[half] <= value) ? base + half : base;
+        n -= half;
+    }
+    return (base - first) + (*base <= value);
+}
+
+inline bool compare_starts( const FrequencyEntry & a, const FrequencyEntry & b )
+{
+    return a.start < b.start;
+}
+
+/**
+ * Number of frequencies of the sorted range [first, first + n) starting at or before `value`
+ */
+inline int started_before( const FrequencyEntry * first, int n, const float value )
+{
+    if(n == 0)
+        return 0;
+    const FrequencyEntry * base = first;
+    while(n > 1) {
+        const int half = n / 2;
+        base = (base[half].start <= value) ? base + half : base;
+        n -= half;
+    }
+    return (base - first) + (base->start <= value);
+}
+
+} // end anonymous namespace
+
+DayTimetable::DayTimetable( const PtDurations & durations, const int day ) : day(day)
+{
+    std::vector< std::pair<int, int> > lines;
+    first.reserve( durations.size() + 1 );
+    for(int e=0 ; e<durations.size() ; ++e) {
+        first.push_back( departures.size() );
+        const PtEdge & edge = durations.edges[e];
+        if(edge.dur_type != TimetableDur)
+            continue;
+
+        // lines of the previous and next days are shifted on the time line of `day`
+        lines.clear();
+        for(int shift=-1 ; shift<=1 ; ++shift) {
+            for(int i=edge.begin ; i<edge.end ; ++i) {
+                if(durations.is_active( durations.services[i], day + shift ))
+                    lines.push_back( std::make_pair( durations.departures[i] + shift * 24*3600,
+                                                     durations.arrivals[i] + shift * 24*3600 ) );
+            }
+        }
+        std::sort( lines.begin(), lines.end() );
+        for(uint i=0 ; i<lines.size() ; ++i) {
+            departures.push_back( lines[i].first );
+            arrivals.push_back( lines[i].second );
+        }
+    }
+    first.push_back( departures.size() );
+}
+
+int DayTimetable::forward( const int index, const float start_time ) const
+{
+    const int begin = first[index];
+    const int i = begin + lower_bound(departures.data() + begin, first[index+1] - begin, start_time);
+    if(i == first[index+1])
+        return -1;
+    BOOST_ASSERT(arrivals[i] >= start_time);
+    return arrivals[i] - start_time;
+}
+
+int DayTimetable::backward( const int index, const float start_time ) const
+{
+    const int begin = first[index];
+    const int i = begin + upper_bound(arrivals.data() + begin, first[index+1] - begin, start_time) - 1;
+    if(i < begin)
+        return -1;
+    BOOST_ASSERT(start_time >= departures[i]);
+    return start_time - departures[i];
+}
+
+namespace {
+std::atomic<int> last_cache_serial( 0 );
+}
+
+DayTimetableCache::DayTimetableCache( const size_t capacity ) : serial(++last_cache_serial), capacity(capacity)
+{
+}
+
+boost::shared_ptr<const DayTimetable> DayTimetableCache::get( const PtDurations & durations, const int day )
+{
+    std::lock_guard<std::mutex> lock( mutex );
+    for(std::list< boost::shared_ptr<const DayTimetable> >::iterator it = views.begin() ; it != views.end() ; ++it) {
+        if((*it)->day == day) {
+            views.splice( views.begin(), views, it );
+            return views.front();
+        }
+    }
+
+    views.push_front( boost::shared_ptr<const DayTimetable>( new DayTimetable( durations, day ) ) );
+    if(views.size() > capacity)
+        views.pop_back();
+    return views.front();
+}
+
+PtDurations::PtDurations() : day_cache( new DayTimetableCache() )
+{
+}
+
+boost::shared_ptr<const DayTimetable> PtDurations::day_timetable( const int day ) const
+{
+    if(day < 0 || day >= num_days)
+        return boost::shared_ptr<const DayTimetable>();
+    return day_cache->get( *this, day );
+}
+
+const DayTimetable * PtDurations::day_view( const int day ) const
+{
+    if(day < 0 || day >= num_days)
+        return NULL;
+
+    // consecutive days land in distinct slots
+    struct Slot {
+        Slot() : serial(0), day(-1) {}
+        int serial;
+        int day;
+        boost::shared_ptr<const DayTimetable> view;
+    };
+    static thread_local Slot slots[4];
+
+    Slot & slot = slots[day % 4];
+    if(slot.serial != day_cache->serial || slot.day != day) {
+        slot.view = day_cache->get( *this, day );
+        slot.serial = day_cache->serial;
+        slot.day = day;
+    }
+    return slot.view.get();
+}
+
+void PtDurations::build( const std::vector<DurationPT> & durations, const std::vector<Services> & base_patterns )
+{
+    // frequency windows are copied to the previous and next days, with the pattern shifted accordingly
+    std::vector<Services> patterns( base_patterns );
+    std::map<std::pair<ServiceId, int>, ServiceId> shifted_ids;
+    std::vector<PtEdge> edges;
+    std::vector<int> departures;
+    std::vector<int> arrivals;
+    std::vector<ServiceId> services;
+    std::vector<FrequencyEntry> frequencies;
+    std::vector<int> reach;
+    edges.reserve( durations.size() );
+
+    for(uint i=0 ; i<durations.size() ; ++i) {
+        const DurationPT & dur = durations[i];
+        PtEdge edge;
+        edge.dur_type = dur.dur_type;
+        edge.const_duration = dur.const_duration;
+
+        if(dur.dur_type == TimetableDur) {
+            edge.begin = departures.size();
+            for(uint j=0 ; j<dur.timetable.size() ; ++j) {
+                departures.push_back( to_seconds( boost::get<0>(dur.timetable[j]) ) );
+                arrivals.push_back( to_seconds( boost::get<1>(dur.timetable[j]) ) );
+                services.push_back( boost::get<2>(dur.timetable[j]) );
+            }
+            edge.end = departures.size();
+        } else if(dur.dur_type == FrequencyDur) {
+            edge.begin = frequencies.size();
+            for(uint j=0 ; j<dur.frequencies.size() ; ++j) {
+                FrequencyEntry entry;
+                boost::tie(entry.start, entry.end, entry.duration, entry.services) = dur.frequencies[j];
+                frequencies.push_back( entry );
+
+                const ServiceId services = entry.services;
+                for(int shift=-1 ; shift<=1 ; shift+=2) {
+                    FrequencyEntry copy = entry;
+                    copy.start += shift * 24*3600;
+                    copy.end += shift * 24*3600;
+                    if(copy.end <= 0)
+                        continue;
+
+                    std::map<std::pair<ServiceId, int>, ServiceId>::const_iterator it = shifted_ids.find( std::make_pair(services, shift) );
+                    if(it != shifted_ids.end()) {
+                        copy.services = it->second;
+                    } else {
+                        // shifted copies can triple the dictionary, a wrapped id would be another pattern
+                        if( patterns.size() > std::numeric_limits<ServiceId>::max() )
+                            throw std::runtime_error( "Too many services patterns once shifted by a day" );
+                        copy.services = patterns.size();
+                        // the copy runs on a day if the original one runs on the day before (resp. after)
+                        patterns.push_back( shift < 0 ? patterns[services] << 1 : patterns[services] >> 1 );
+                        shifted_ids[std::make_pair(services, shift)] = copy.services;
+                    }
+                    frequencies.push_back( copy );
+                }
+            }
+            edge.end = frequencies.size();
+
+            // the index relies on the order by start, which graphs loaded from archives do not guarantee
+            std::stable_sort( frequencies.begin() + edge.begin, frequencies.end(), compare_starts );
+            for(int j=edge.begin ; j<edge.end ; ++j)
+                reach.push_back( j == edge.begin ? frequencies[j].end : std::max( reach.back(), frequencies[j].end ) );
+        } else {
+            edge.begin = edge.end = 0;
+        }
+        edges.push_back( edge );
+    }
+
+    const int words = (patterns.size() + 63) / 64;
+    std::vector<boost::uint64_t> active( num_days * words, 0 );
+    for(int day=0 ; day<num_days ; ++day) {
+        for(uint s=0 ; s<patterns.size() ; ++s) {
+            if(patterns[s][day])
+                active[day * words + s / 64] |= boost::uint64_t(1) << (s % 64);
+        }
+    }
+
+    this->edges.assign( edges );
+    this->departures.assign( departures );
+    this->arrivals.assign( arrivals );
+    this->services.assign( services );
+    this->frequencies.assign( frequencies );
+    this->frequency_reach.assign( reach );
+    this->active_services.assign( active );
+    day_cache.reset( new DayTimetableCache() );
+}
+
+std::pair<bool, int> PtDurations::duration( const int index, float start, int day, bool backward ) const
+{
+    const PtEdge & edge = edges[index];
+
+    if (edge.dur_type == ConstDur) {
+        return std::pair<bool, int>(true, edge.const_duration);
+    } else if(edge.dur_type == FrequencyDur) {
+        return frequency_duration(edge, start, day);
+    } else {
+        return tt_duration(index, start, day, backward);
+    }
+}
+
+std::pair<bool, int> PtDurations::min_duration( const int index ) const
+{
+    const int const_duration = edges[index].const_duration;
+    if(const_duration < 0) {
+        std::cerr << "WARNING CONST DURATION < 0\n";
+        return std::pair<bool, int>(false, const_duration);
+    }
+    return std::pair<bool, int>(true, const_duration);
+}
+
+
+
+std::pair<bool, int> PtDurations::frequency_duration( const PtEdge & edge, const float start_time, const int day ) const
+{
+    const boost::uint64_t * row = day_row(day);
+    if(row == NULL)
+        return std::pair<bool, int>(false, -1);
+
+    // the window starting first among those containing the time is the one a scan by start would find
+    int found = -1;
+    for(int i = edge.begin + started_before(frequencies.data() + edge.begin, edge.end - edge.begin, start_time) - 1 ;
+        i >= edge.begin && start_time < frequency_reach[i] ; --i)
+    {
+        const FrequencyEntry & f = frequencies[i];
+        if(start_time < f.end && active(row, f.services))
+            found = i;
+    }
+    if(found < 0)
+        return std::pair<bool, int>(false, -1);
+    return std::pair<bool, int>(true, frequencies[found].duration);
+}
+
+void PtDurations::day_frequencies( const int index, const int day, std::vector<FrequencyEntry> & windows ) const
+{
+    windows.clear();
+    const boost::uint64_t * row = day_row(day);
+    const PtEdge & edge = edges[index];
+    if(row == NULL || edge.dur_type != FrequencyDur)
+        return;
+
+    for(int i=edge.begin ; i<edge.end ; ++i) {
+        if(active(row, frequencies[i].services))
+            windows.push_back( frequencies[i] );
+    }
+}
+
+std::pair<bool, int> PtDurations::tt_duration( const int index, const float start_time, const int day, const bool backward ) const
+{
+    const DayTimetable * view = day_view(day);
+    if(view == NULL)
+        return std::pair<bool, int>(false, -1);
+
+    const int cost = backward ? view->backward(index, start_time) : view->forward(index, start_time);
+    return std::pair<bool, int>(cost >= 0, cost);
+}
+
+} // end namespace Transport
@@ -0,0 +1,277 @@
+/** Copyright : Arthur Bit-Monnot (2013)  arthur.bit-monnot@laas.fr
+
+This software is a computer program whose purpose is to [describe
+functionalities and technical features of your software].
+
+This software is governed by the CeCILL-B license under French law and
+abiding by the rules of distribution of free software.  You can  use, 
+modify and/ or redistribute the software under the terms of the CeCILL-B
+license as circulated by CEA, CNRS and INRIA at the following URL
+"http://www.cecill.info". 
+
+As a counterpart to the access to the source code and  rights to copy,
+modify and redistribute granted by the license, users are provided only
+with a limited warranty  and the software's author,  the holder of the
+economic rights,  and the successive licensors  have only  limited
+liability. 
+
+In this respect, the user's attention is drawn to the risks associated
+with loading,  using,  modifying and/or developing or reproducing the
+software by the user in light of its specific status of free software,
+that may mean  that it is complicated to manipulate,  and  that  also
+therefore means  that it is reserved for developers  and  experienced
+professionals having in-depth computer knowledge. Users are therefore
+encouraged to load and test the software's suitability as regards their
+requirements in conditions enabling the security of their systems and/or 
+data to be ensured and,  more generally, to use and operate it in the 
+same conditions as regards security. 
+
+The fact that you are presently reading this means that you have had
+knowledge of the CeCILL-B license and that you accept its terms. 
+*/
+
+#ifndef PT_DURATIONS_H
+#define PT_DURATIONS_H
+
+#include <vector>
+#include <bitset>
+#include <utility>
+#include <list>
+#include <mutex>
+#include <boost/cstdint.hpp>
+#include <boost/shared_ptr.hpp>
+
+#include "flat_array.h"
+
+class DurationPT;
+
+/**
+ * Attaches a boolean to every day
+ */
+typedef std::bitset<128> Services;
+
+/**
+ * Id of a services pattern: distinct Services are stored once for the whole graph
+ */
+typedef boost::uint16_t ServiceId;
+
+namespace Transport {
+
+/**
+ * A frequency of the frozen graph (see DurationPT::append_frequency)
+ */
+struct FrequencyEntry
+{
+    int start;
+    int end;
+    int duration;
+    ServiceId services;
+};
+
+/**
+ * Duration of a public transport edge in the frozen graph.
+ *
+ * Entries of the edge are in [begin, end) of the PtDurations::departures, arrivals and services arrays
+ * if `dur_type` is TimetableDur, of PtDurations::frequencies if it is FrequencyDur.
+ */
+struct PtEdge
+{
+    int dur_type;
+    int const_duration;
+    int begin;
+    int end;
+};
+
+class PtDurations;
+
+/**
+ * Timetables of all public transport edges restricted to the lines running on a given day.
+ *
+ * The lines of the previous and next days are included, shifted by -24h and +24h: lines of the previous
+ * service day running after midnight are found by early morning queries, and queries going past midnight
+ * find the lines of the next day.
+ *
+ * Lines of the edge `e` are in [first[e], first[e+1]) of departures and arrivals, sorted by departure.
+ * A lookup is hence a single binary search, with no services to test.
+ */
+class DayTimetable
+{
+public:
+    DayTimetable( const PtDurations & durations, const int day );
+
+    const int day;
+
+    /**
+     * Time needed to traverse the edge `index` when leaving at `start_time`, -1 if no line leaves after it
+     */
+    int forward( const int index, const float start_time ) const;
+
+    /**
+     * Time needed to traverse the edge `index` when arriving at `start_time`, -1 if no line arrives before it
+     */
+    int backward( const int index, const float start_time ) const;
+
+    /**
+     * Lines of the edge `index` are the ones in [begin(index), end(index))
+     */
+    inline int begin( const int index ) const { return first[index]; }
+    inline int end( const int index ) const { return first[index+1]; }
+    inline int departure( const int line ) const { return departures[line]; }
+    inline int arrival( const int line ) const { return arrivals[line]; }
+
+private:
+    std::vector<int> first;
+    std::vector<int> departures;
+    std::vector<int> arrivals;
+};
+
+/**
+ * Keeps the DayTimetable of the last few days that were queried, building them when first needed.
+ *
+ * Can be shared by several threads. A view stays valid as long as a shared pointer to it is held,
+ * even once it has been evicted from the cache.
+ */
+class DayTimetableCache
+{
+public:
+    DayTimetableCache( const size_t capacity = 8 );
+
+    /**
+     * Distinguishes caches from each other, including ones allocated at the same address
+     */
+    const int serial;
+
+    boost::shared_ptr<const DayTimetable> get( const PtDurations & durations, const int day );
+
+private:
+    const size_t capacity;
+    std::mutex mutex;
+
+    /**
+     * Most recently used first
+     */
+    std::list< boost::shared_ptr<const DayTimetable> > views;
+};
+
+/**
+ * Frozen durations of all public transport edges.
+ *
+ * Timetables are stored column-wise: the lines of all edges are concatenated in the departures, arrivals and
+ * services arrays, sorted by departure inside the range of each edge. Times are rounded to the second.
+ * The searches hence only touch the column they need (departures when going forward, arrivals when
+ * going backward) and then the 2 bytes service ids.
+ *
+ * Frequencies are stored in a single array, sorted by start inside the range of each edge. Each window
+ * also appears shifted by -24h and +24h, with a services pattern shifted by one day, so that a lookup
+ * covers the previous and next service days at once. Together with
+ * frequency_reach, this makes an interval index: the windows containing a time are found by a binary search
+ * on the start followed by a backward scan that stops as soon as no earlier window can reach that time.
+ * When the windows of an edge do not overlap, at most one of them is visited. When several windows contain the
+ * time, the one starting first gives the duration.
+ */
+class PtDurations
+{
+public:
+    /**
+     * Number of days covered by Services
+     */
+    static const int num_days = 128;
+
+    FlatArray<PtEdge> edges;
+    FlatArray<int> departures;
+    FlatArray<int> arrivals;
+    FlatArray<ServiceId> services;
+    FlatArray<FrequencyEntry> frequencies;
+
+    /**
+     * Greatest end of the frequencies of the edge up to (and including) the one at the same index
+     */
+    FlatArray<int> frequency_reach;
+
+    /**
+     * Calendar resolved by day: bit `s` of the row of day `d` is set if the services pattern `s` runs on `d`.
+     * Each row is made of (number of patterns + 63) / 64 words.
+     */
+    FlatArray<boost::uint64_t> active_services;
+
+    PtDurations();
+
+    /**
+     * Builds the frozen durations from the ones of the graph builder
+     *
+     * Patterns referenced by the shifted frequencies are appended after the given ones.
+     * Throws std::runtime_error if they no longer fit in ServiceId.
+     */
+    void build( const std::vector<DurationPT> & durations, const std::vector<Services> & patterns );
+
+    inline int size() const { return edges.size(); }
+
+    /**
+     * True if the services pattern runs on the given day
+     */
+    inline bool is_active( const ServiceId services, const int day ) const {
+        const boost::uint64_t * row = day_row(day);
+        return row != NULL && active(row, services);
+    }
+
+    /**
+     * Time needed to traverse the edge `index` when leaving at `start_time` (arriving at if `backward`)
+     * on `day`. The first member of the pair is false if there is no traffic.
+     */
+    std::pair<bool, int> duration( const int index, float start_time, int day, bool backward = false ) const;
+
+    /**
+     * Returns the minimum cost that might appear on this edge.
+     */
+    std::pair<bool, int> min_duration( const int index ) const;
+
+    /**
+     * Timetables of the given day, an empty pointer if the day is not covered
+     */
+    boost::shared_ptr<const DayTimetable> day_timetable( const int day ) const;
+
+    /**
+     * Fills `windows` with the frequencies of the edge `index` running on `day`, sorted by start.
+     * Windows of the previous and next days are included, shifted by -24h and +24h.
+     */
+    void day_frequencies( const int index, const int day, std::vector<FrequencyEntry> & windows ) const;
+
+private:
+    /**
+     * Row of active_services for the given day, NULL if the day is not covered
+     */
+    inline const boost::uint64_t * day_row( const int day ) const {
+        if(day < 0 || day >= num_days)
+            return NULL;
+        return active_services.data() + day * (active_services.size() / num_days);
+    }
+
+    static inline bool active( const boost::uint64_t * row, const ServiceId services ) {
+        return (row[services / 64] >> (services % 64)) & 1;
+    }
+
+    /**
+     * Timetables of the given day, NULL if the day is not covered.
+     *
+     * Each thread keeps the views of the last days it queried, so the shared cache is only
+     * locked when the query day changes.
+     */
+    const DayTimetable * day_view( const int day ) const;
+
+    /**
+     * Views of the timetables by day, replaced whenever the durations are rebuilt
+     */
+    boost::shared_ptr<DayTimetableCache> day_cache;
+
+    /**
+     * Duration of the frequency of the edge containing `start_time` and running on `day`.
+     * If several windows qualify, the one that started first is used.
+     */
+    std::pair<bool, int> frequency_duration( const PtEdge & edge, const float start_time, const int day ) const;
+
+    std::pair<bool, int> tt_duration( const int index, const float start_time, const int day, const bool backward ) const;
+};
+
+} // end namespace Transport
+
+#endif
@@ -52,3 +52,10 @@ double get_run_time_sec() {
 
   return df;
 }
+
+int num_threads( const int threads ) {
+  if(threads > 0)
+    return threads;
+  const int cores = std::thread::hardware_concurrency();
+  return cores > 0 ? cores : 1;
+}
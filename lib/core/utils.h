@@ -37,6 +37,12 @@ knowledge of the CeCILL-B license and that you accept its terms. */
 #ifndef UTILS_H
 #define UTILS_H
 
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <boost/shared_ptr.hpp>
+
 double get_run_time_sec();
 
 extern double ticking_start, ticking_end;
@@ -59,4 +65,77 @@ struct LISTPARAM {
     template<typename T2, typename T3, typename T4> LISTPARAM(T4 t4, T3 t3, T2 t2, T t) : value(t), next(t4, t3, t2) {}
 };
 
+/**
+ * Number of threads used when `threads` are asked for, 0 meaning one per core
+ */
+int num_threads( const int threads );
+
+/**
+ * Calls job(i, thread) for every i in [0, count), spread over num_threads(threads) threads. Each thread takes
+ * the next i as soon as it is done with the previous one; `thread` is its index, for the buffers a thread keeps
+ * from one call to the next.
+ */
+template<typename Job>
+void parallel_for( const int count, const int threads, const Job & job )
+{
+    std::atomic<int> next( 0 );
+    std::vector<std::thread> workers;
+    for(int t=0 ; t<num_threads(threads) ; ++t) {
+        workers.push_back( std::thread( [t, count, &next, &job]() {
+            for(int i=next++ ; i<count ; i=next++)
+                job( i, t );
+        } ) );
+    }
+    for(unsigned int t=0 ; t<workers.size() ; ++t) {
+        workers[t].join();
+    }
+}
+
+/**
+ * Objects reused by the successive queries of several threads, each one used by a single query at a time.
+ * A copy of a pool starts empty.
+ */
+template<typename T>
+class ObjectPool
+{
+public:
+    ObjectPool() {}
+    ObjectPool( const ObjectPool & ) {}
+    ObjectPool & operator=( const ObjectPool & ) { return *this; }
+
+    ~ObjectPool() {
+        for(unsigned int i=0 ; i<free_objects.size() ; ++i) {
+            delete free_objects[i];
+        }
+    }
+
+    /**
+     * An object that no other query uses, made by `create()` if none is free. It goes back to the pool when
+     * the last copy of the pointer is released, which must happen before the pool is destroyed.
+     */
+    template<typename Create>
+    boost::shared_ptr<T> acquire( const Create & create ) {
+        T * object = NULL;
+        {
+            std::lock_guard<std::mutex> lock( mutex );
+            if(!free_objects.empty()) {
+                object = free_objects.back();
+                free_objects.pop_back();
+            }
+        }
+        if(object == NULL)
+            object = create();
+        return boost::shared_ptr<T>( object, [this]( T * o ) { release( o ); } );
+    }
+
+private:
+    void release( T * object ) {
+        std::lock_guard<std::mutex> lock( mutex );
+        free_objects.push_back( object );
+    }
+
+    std::mutex mutex;
+    std::vector<T *> free_objects;
+};
+
 #endif
\ No newline at end of file
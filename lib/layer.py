@@ -369,6 +369,9 @@ class MultimodalGraph(object):
 
     def save_to_txt(self, filename):
         self.graph_facto.save_to_txt(filename)
+
+    def save_to_mmap(self, filename):
+        self.graph_facto.save_to_mmap(filename)
         
     #def load(self, filename):
         #self.graph_facto.load(filename)